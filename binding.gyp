@@ -4,19 +4,41 @@
       'target_name': 'index',
       'sources': [
         'src/index.cpp',
+        'src/allocations.cpp',
+        'src/archive.cpp',
+        'src/arrow.cpp',
         'src/codecs.cpp',
+        'src/columns.cpp',
+        'src/container.cpp',
+        'src/dedup.cpp',
+        'src/flows.cpp',
+        'src/parser.cpp',
+        'src/predicates.cpp',
+        'src/sampling.cpp',
+        'src/sources.cpp',
+        'src/stations.cpp',
+        'src/tpacket.cpp',
         'src/utils.cpp',
         'src/wrapper.cpp'
       ],
       'link_settings': {
         'libraries': [
           '-lavrocpp',
-          '-ltins'
+          '-lpcap',
+          '-ltins',
+          '-lz'
         ]
       },
       'cflags!': ['-fno-exceptions'],
       'cflags_cc!': ['-fno-exceptions', '-fno-rtti'],
       'conditions': [
+        [
+          'OS=="linux"', {
+            'ldflags': [
+              '-Wl,--version-script=<(module_root_dir)/src/allocations.map'
+            ]
+          }
+        ],
         [
           'OS=="mac"', {
             'xcode_settings': {
@@ -4,12 +4,37 @@
 
 var utils = require('./utils'),
     events = require('events'),
+    os = require('os'),
     stream = require('stream'),
     util = require('util');
 
 
-// Cache for PDU type to avoid parsing the IDL each time.
+// Cache for PDU and record types to avoid parsing the IDLs each time.
 var PDU_TYPE;
+var RECORD_TYPES = {}; // By mode.
+
+// Events emitted with each record, in aggregating modes.
+var RECORD_EVENTS = {flows: 'flow', stations: 'station'};
+
+// Event emitted with each batch's contents, by mode. In `'pdu'` mode, typed
+// `pdu:<name>` events are emitted as well.
+var MODE_EVENTS = {
+  pdu: 'pdu',
+  raw: 'pdu',
+  columns: 'columns',
+  arrow: 'arrow',
+  flows: 'flow',
+  stations: 'station'
+};
+
+// Size of the header preceding each frame in raw mode.
+var RAW_HEADER_SIZE = 20;
+
+// Bit set in the tags of duplicate frames (see `dedup`).
+var DUPLICATE_TAG = 0x80;
+
+// Arrow IPC stream end marker.
+var ARROW_EOS = new Buffer([0xff, 0xff, 0xff, 0xff, 0, 0, 0, 0]);
 
 
 /**
@@ -18,55 +43,230 @@ var PDU_TYPE;
  * Not meant to be instantiated directly though, only through the two factory
  * functions below (so as not to expose the CPP-defined `Wrapper`).
  *
+ * By default each batch is captured by a separate worker on libuv's
+ * threadpool. When the `threaded` option is set, the wrapper instead captures
+ * from its own native thread into a ring of `ringSize` buffers, which avoids
+ * scheduling gaps between batches under sustained traffic. In this mode, the
+ * sniffer can also be fed by several wrappers at once (one thread each).
+ *
+ * A `batch` event is emitted for each batch captured, with the number of PDUs
+ * it contains and statistics about how it was read (`frames` consumed and
+ * `dispatches` it took). PDUs larger than a batch are delivered on their own,
+ * in a dedicated buffer, rather than failing the capture.
+ *
+ * Each `batch` event also carries the batch's buffer, along with a
+ * `Uint32Array` of each PDU's starting offset in it and a `Uint8Array` of
+ * their frame types' tags (see `getFrameTypeName`). These allow jumping
+ * straight to PDUs of interest (e.g. `type.decode(buf, offsets[i])`), without
+ * decoding the ones before. The buffer is reused once the event's listeners
+ * return, so it must be copied to be used afterwards.
+ *
+ * When duplicates are tagged (see the `dedup` option of the factories), the
+ * tags of duplicate frames have their `0x80` bit set and `pdu` events (typed
+ * or not, raw included) get an extra boolean argument, `true` for duplicates.
+ *
+ * Listeners can also subscribe to a single frame type, via `pdu:<name>` events
+ * (e.g. `pdu:dot11.mgmt.Beacon`, see `getFrameTypeName` for the list of
+ * names). PDUs of types without any such listener (nor `pdu` ones) are never
+ * decoded. These events are only emitted in `'pdu'` mode: attaching such a
+ * listener in any other mode throws. Likewise, only listeners of the current
+ * mode's event (`pdu`, `columns`, `arrow`, `flow`, or `station`) start the
+ * capture.
+ *
+ * With the `lazy` option set, each `pdu` event is emitted with the same view
+ * (see `PduView` in `utils.js`), moved over the batch's buffer: fields are
+ * only decoded when accessed. It is only valid until the listener returns.
+ *
+ * In `'raw'` mode, frames aren't decoded at all. Each `pdu` event is instead
+ * emitted with the frame's captured bytes, its timestamp (in microseconds),
+ * its length on the wire, and its PCAP link type. The bytes are a slice of the
+ * batch's buffer, which will be reused: they must be copied to be used after
+ * the event.
+ *
+ * In `'columns'` mode, no `pdu` events are emitted. Each batch instead emits a
+ * single `columns` event with its frames' main fields, as typed arrays of the
+ * same length (one entry per frame) viewing the batch's buffer: `timestamp`
+ * (`Float64Array`, milliseconds), `addr1`, `addr2`, `addr3` (`Float64Array`,
+ * 802.11 addresses as 48-bit integers, `NaN` when absent), `size`
+ * (`Uint32Array`, captured length), `seqNum`, `rate`, `freq` (`Int32Array`,
+ * -1 when absent), and `type` (`Uint8Array`, see `getFrameTypeName`). The
+ * ethernet payload of frame `i` is `data.slice(dataOffsets[i], dataOffsets[i +
+ * 1])` (empty for other frames). As for raw frames, these must be copied to be
+ * used after the event.
+ *
+ * `'arrow'` mode is similar, except that each batch emits a single `arrow`
+ * event with an Arrow IPC record batch message holding the same fields (as
+ * nullable columns, timestamps in microseconds). Here again the message is a
+ * slice of the batch's buffer. See `arrowStream` to write them to a file.
+ *
+ * Finally, the `archive` option (`{path, codec, level, maxSize, maxAge}`)
+ * appends each batch, as is, to Avro object container files. Batches are
+ * copied then compressed (`codec` is `'null'`, the default, or `'deflate'`)
+ * and written from a background thread, rotating files once they exceed
+ * `maxSize` bytes or `maxAge` milliseconds (see `src/container.hpp`). PDUs are
+ * archived even if there are no listeners (in which case they aren't decoded
+ * at all). This is only supported in the default `'pdu'` mode.
+ *
+ * In `'flows'` mode, Ethernet II frames are aggregated natively into flows
+ * (per addresses, payload type, and IP 5-tuple if any) and a `flow` event is
+ * emitted with each flow's record (see `etc/idls/Flow.avdl`) once it expires:
+ * after `flowIdleTimeout` milliseconds without frames (15 seconds by default),
+ * or `flowActiveTimeout` milliseconds after its first frame (60 seconds by
+ * default, 0 to disable). Other frames are ignored.
+ *
+ * Similarly, `'stations'` mode aggregates 802.11 frames per BSSID and station
+ * (see `etc/idls/Station.avdl`). Every `stationInterval` milliseconds (one
+ * second by default), a `station` event is emitted with a snapshot of each
+ * station seen since the previous interval.
+ *
  */
-function Sniffer(wrapper, batchSize) {
+function Sniffer(wrappers, opts) {
   events.EventEmitter.call(this);
 
-  batchSize = batchSize || 65536; // Same default as PCAP's buffer size.
-  this._bufs = [new Buffer(batchSize), new Buffer(batchSize)];
+  opts = opts || {};
+  if (!(wrappers instanceof Array)) {
+    wrappers = [wrappers];
+  }
+  if (wrappers.length > 1 && !opts.threaded) {
+    throw new Error('multiple wrappers require threaded mode');
+  }
+  if (opts.archive && (opts.mode || 'pdu') !== 'pdu') {
+    throw new Error('archives require pdu mode');
+  }
+
+  var batchSize = opts.batchSize || 65536; // Same default as PCAP's buffer size.
+  var numBufs = opts.threaded ? opts.ringSize || 8 : 2;
+  this._bufs = wrappers.map(function () {
+    var bufs = [];
+    var i;
+    for (i = 0; i < numBufs; i++) {
+      bufs.push(new Buffer(batchSize));
+    }
+    return bufs;
+  });
   this._bufIndex = 0;
-  this._wrapper = wrapper;
+  this._wrappers = wrappers;
+  this._threaded = !!opts.threaded;
+  this._raw = opts.mode === 'raw';
+  this._columns = opts.mode === 'columns';
+  this._arrow = opts.mode === 'arrow';
+  this._recordEvent = RECORD_EVENTS[opts.mode];
+  this._event = MODE_EVENTS[opts.mode || 'pdu'];
+  this._typed = (opts.mode || 'pdu') === 'pdu';
+  this._lazy = !!opts.lazy && this._typed;
   this._type = undefined;
+  this._recordType = undefined;
+  this._view = undefined;
+  this._frameTypeNames = undefined;
+  this._pduEvents = undefined; // Typed event names, by tag.
+  this._archive = undefined;
   this._sniffing = false;
+  this._batching = false; // Inside a capture thread's batch callback.
   this._destroyed = false;
 
+  if (!this._typed) {
+    // These would never be emitted.
+    this.on('newListener', function (evt) {
+      if (/^pdu:/.test(evt)) {
+        throw new Error('typed pdu events require pdu mode');
+      }
+    });
+  }
+
   this.once('_end', function () {
-    this._wrapper.destroy();
+    this._wrappers.forEach(function (wrapper) { wrapper.destroy(); });
+    if (this._archive) {
+      try {
+        this._archive.close(); // Waits for pending batches to be written.
+      } catch (err) {
+        this.emit('error', err);
+      }
+    }
     this.emit('end');
   });
 
   var self = this;
-  loadPduType(function (err, type) {
+  loadTypes(opts.mode, function (err, type, recordType) {
     if (err) {
       self.emit('error', err);
       return;
     }
     self._type = type;
+    self._recordType = recordType;
+    self._frameTypeNames = utils.getFrameTypeNames(type);
+    self._pduEvents = self._frameTypeNames.map(function (name) {
+      return 'pdu:' + name;
+    });
+    if (self._lazy) {
+      self._view = new utils.PduView(type);
+    }
+    if (opts.archive) {
+      try {
+        self._archive = openArchive(opts.archive, type);
+      } catch (err) {
+        self.emit('error', err);
+        return;
+      }
+    }
 
     self.on('newListener', function start(evt) {
-      if (evt === 'pdu' && !self.listenerCount('pdu')) {
+      var emitted = evt === self._event || (self._typed && /^pdu:/.test(evt));
+      if (emitted && !hasPduListeners()) {
         sniff();
       }
     });
-    if (self.listenerCount('pdu')) {
+    if (hasPduListeners()) {
       // Only start listening right away if a handler is already attached,
       // otherwise we are either dropping PDUs, wasting CPU, or both.
       sniff();
     }
 
     function sniff() {
-      var buf = self._bufs[self._bufIndex];
+      if (self._threaded) {
+        // Each capture thread keeps running until the sniffer is destroyed,
+        // cycling through its own buffers.
+        if (!self._sniffing && !self._destroyed) {
+          self._sniffing = true;
+          self._wrappers.forEach(function (wrapper, i) {
+            var bufs = self._bufs[i];
+            wrapper.start(bufs, onBatch);
+
+            function onBatch(err, index, n, stats, offsets, tags, oversized) {
+              if (err) {
+                self.emit('error', err);
+                return;
+              }
+              var buf = oversized || bufs[index];
+              self._batching = true;
+              self.emit('batch', n, stats, buf, offsets, tags);
+              decode(buf, n, stats, offsets, tags);
+              self._batching = false;
+              if (self._destroyed) {
+                // Destroyed from one of this batch's listeners, the end was
+                // deferred until all its PDUs were emitted.
+                self.emit('_end');
+              }
+            }
+          });
+        }
+        return;
+      }
+
+      var buf = self._bufs[0][self._bufIndex];
       self._bufIndex = 1 - self._bufIndex;
       self._sniffing = true;
-      self._wrapper.getPdus(buf, function (err, n) {
+      self._wrappers[0].getPdus(buf, onBatch);
+
+      function onBatch(err, n, stats, offsets, tags, oversized) {
         if (err) {
           self.emit('error', err);
           return;
         }
 
-        self.emit('batch', n);
+        var batchBuf = oversized || buf;
+        self.emit('batch', n, stats, batchBuf, offsets, tags);
 
-        var sniffing = !self._destroyed && !!self.listenerCount('pdu');
+        var sniffing = !self._destroyed && hasPduListeners();
         if (sniffing) {
           // Trigger the next batch before processing this one, to enable the
           // C++ code to run as often as possible. This is possible because we
@@ -74,15 +274,7 @@ function Sniffer(wrapper, batchSize) {
           sniff();
         }
 
-        try {
-          var pos = 0;
-          while (n--) {
-            var obj = self._type.decode(buf, pos);
-            self.emit('pdu', obj.value);
-            pos = obj.offset;
-          }
-        } catch (err) {
-          self.emit('error', err);
+        if (!decode(batchBuf, n, stats, offsets, tags)) {
           return;
         }
 
@@ -90,7 +282,122 @@ function Sniffer(wrapper, batchSize) {
         if (!sniffing && self._destroyed) {
           self.emit('_end');
         }
+      }
+    }
+
+    function hasPduListeners() {
+      // Only listeners of events emitted in the current mode count.
+      return !!self._archive ||
+        !!self.listenerCount(self._event) ||
+        (self._typed && !!getTypedTags());
+    }
+
+    function getTypedTags() {
+      // Tags with at least one typed listener, `undefined` if there are none.
+      var typed;
+      self._pduEvents.forEach(function (evt, tag) {
+        if (self.listenerCount(evt)) {
+          typed = typed || [];
+          typed[tag] = true;
+        }
       });
+      return typed;
+    }
+
+    function decode(buf, n, stats, offsets, tags) {
+      if (self._archive && n) {
+        try {
+          self._archive.write(buf, stats.bytes, n);
+        } catch (err) {
+          self.emit('error', err);
+          return false;
+        }
+      }
+      if (self._raw) {
+        decodeRaw(buf, n, tags);
+        return true;
+      }
+      if (self._columns) {
+        if (n) {
+          self.emit('columns', readColumns(buf, n));
+        }
+        return true;
+      }
+      if (self._arrow) {
+        if (n) {
+          // The message starts at the buffer's first 8-byte aligned address.
+          var start = (8 - buf.byteOffset % 8) % 8;
+          self.emit('arrow', buf.slice(start, stats.bytes));
+        }
+        return true;
+      }
+      if (self._recordEvent) {
+        return decodeRecords(buf, n, offsets);
+      }
+      var all = !!self.listenerCount('pdu');
+      var typed = getTypedTags();
+      var view = self._view;
+      try {
+        var i;
+        for (i = 0; i < n; i++) {
+          var tag = tags[i] & ~DUPLICATE_TAG;
+          var duplicate = tag !== tags[i];
+          var isTyped = typed && typed[tag];
+          if (!all && !isTyped) {
+            continue; // Thanks to the offsets, we can skip it entirely.
+          }
+          var pdu;
+          if (view) {
+            // Nothing decoded upfront.
+            view._moveTo(buf, offsets[i]);
+            pdu = view;
+          } else {
+            pdu = self._type.decode(buf, offsets[i]).value;
+          }
+          if (all) {
+            self.emit('pdu', pdu, duplicate);
+          }
+          if (isTyped) {
+            self.emit(self._pduEvents[tag], pdu, duplicate);
+          }
+        }
+      } catch (err) {
+        self.emit('error', err);
+        return false;
+      }
+      return true;
+    }
+
+    function decodeRecords(buf, n, offsets) {
+      try {
+        var i;
+        for (i = 0; i < n; i++) {
+          var record = self._recordType.decode(buf, offsets[i]).value;
+          self.emit(self._recordEvent, record);
+        }
+      } catch (err) {
+        self.emit('error', err);
+        return false;
+      }
+      return true;
+    }
+
+    function decodeRaw(buf, n, tags) {
+      // See `encodeRaw` in `src/codecs.hpp` for the layout.
+      var pos = 0;
+      var i;
+      for (i = 0; i < n; i++) {
+        var timestamp = buf.readUInt32LE(pos) +
+          0x100000000 * buf.readUInt32LE(pos + 4);
+        var caplen = buf.readUInt32LE(pos + 8);
+        var len = buf.readUInt32LE(pos + 12);
+        var linkType = buf.readUInt32LE(pos + 16);
+        pos += RAW_HEADER_SIZE;
+        var data = buf.slice(pos, pos + caplen);
+        var duplicate = !!(tags[i] & DUPLICATE_TAG);
+        self.emit('pdu', data, timestamp, len, linkType, duplicate);
+        pos += caplen;
+      }
     }
   });
 }
@@ -102,11 +409,32 @@ util.inherits(Sniffer, events.EventEmitter);
  */
 Sniffer.prototype.destroy = function () {
   this._destroyed = true;
-  if (!this._sniffing) {
+  if (this._sniffing) {
+    // Interrupt any pending read so that we don't have to wait for the current
+    // batch's timeout. Unlike workers, capture threads also don't stop on
+    // their own.
+    this._wrappers.forEach(function (wrapper) { wrapper.stop(); });
+    if (this._threaded) {
+      this._sniffing = false;
+    }
+  }
+  if (!this._sniffing && !this._batching) {
     this.emit('_end');
   }
 };
 
+/**
+ * Name of the frame type a tag corresponds to (e.g. `'dot11.mgmt.Beacon'`).
+ *
+ * Tags are only available once the PDU type is loaded, i.e. from within
+ * `batch` events.
+ *
+ */
+Sniffer.prototype.getFrameTypeName = function (tag) {
+  tag &= ~DUPLICATE_TAG;
+  return this._frameTypeNames && this._frameTypeNames[tag];
+};
+
 /**
  * Convenience method to expose a stream interface.
  *
@@ -119,16 +447,49 @@ Sniffer.prototype.destroy = function () {
  *
  */
 Sniffer.prototype.stream = function () {
+  var raw = this._raw;
+  var lazy = this._lazy;
   var readable = new stream.Readable({
     objectMode: true,
     read: function () {} // We push irrespective of this.
   });
   this
-    .on('pdu', function (pdu) { readable.push(pdu); })
+    .on('pdu', function (pdu) {
+      // Raw frames and views must be copied out of the batch buffer before
+      // it's reused.
+      if (raw) {
+        readable.push(new Buffer(pdu));
+      } else {
+        readable.push(lazy ? pdu.decode() : pdu);
+      }
+    })
     .on('end', function () { readable.push(null); });
   return readable;
 };
 
+/**
+ * Arrow IPC stream of all batches, in `'arrow'` mode.
+ *
+ * Each record batch message is copied out of its batch's buffer, so the same
+ * buffering caveat as `stream` applies. The stream can be written as is to a
+ * `.arrow` file.
+ *
+ */
+Sniffer.prototype.arrowStream = function () {
+  if (!this._arrow) {
+    throw new Error('arrow streams require arrow mode');
+  }
+  var readable = new stream.Readable({read: function () {}});
+  readable.push(this._wrappers[0].getArrowSchema());
+  this
+    .on('arrow', function (msg) { readable.push(new Buffer(msg)); })
+    .on('end', function () {
+      readable.push(ARROW_EOS);
+      readable.push(null);
+    });
+  return readable;
+};
+
 /**
  * Factory method for live captures.
  *
@@ -137,33 +498,98 @@ Sniffer.prototype.stream = function () {
  * + http://www.tcpdump.org/manpages/pcap.3pcap.html
  * + http://libtins.github.io/docs/latest/da/d53/classTins_1_1SnifferConfiguration.html
  *
+ * Setting `backend` to `'tpacket'` uses Linux's memory-mapped `AF_PACKET`
+ * rings instead of PCAP, configured via `blockSize` (bytes, a multiple of both
+ * the page size and 2048, the ring's frame size), `blockCount`, and
+ * `blockTimeout` (milliseconds before the kernel hands over a partially filled
+ * block). See
+ * https://www.kernel.org/doc/Documentation/networking/packet_mmap.txt
+ *
+ * The `fanout` option (`{group, mode, workers}`) implies this backend: it
+ * opens `workers` sockets (one per CPU by default) in the same `PACKET_FANOUT`
+ * group, each captured from its own thread. `mode` is one of `'hash'` (the
+ * default, which keeps each flow on a single socket and therefore ordered),
+ * `'cpu'`, or `'lb'` (round-robin).
+ *
+ * Options controlling how frames are processed are shared with file sniffers
+ * (see `configureWrappers`), as are those of the sniffer itself (`mode`,
+ * `lazy`, `archive`, etc., see `Sniffer`).
+ *
  */
 function createInterfaceSniffer(dev, opts) {
   opts = opts || {};
-  var wrapper = new utils.Wrapper().fromInterface(
-    dev,
-    opts.snaplen,
-    opts.promisc,
-    opts.rfmon,
-    opts.timeout || 1000, // Default maximum 1 second delay between batches.
-    opts.bufferSize,
-    opts.filter
-  );
+  var timeout = opts.timeout || 1000; // Default maximum 1 second delay between batches.
+  var wrappers;
+  if (opts.fanout) {
+    // Spread the capture over several sockets in the same fanout group, each
+    // read and encoded from its own thread.
+    var fanout = opts.fanout;
+    var group = fanout.group === undefined ? process.pid & 0xffff : fanout.group;
+    var numWorkers = fanout.workers || os.cpus().length;
+    wrappers = [];
+    while (numWorkers--) {
+      wrappers.push(createTpacketWrapper(group, fanout.mode || 'hash'));
+    }
+  } else if (opts.backend === 'tpacket') {
+    wrappers = [createTpacketWrapper()];
+  } else {
+    wrappers = [
+      new utils.Wrapper().fromInterface(
+        dev,
+        opts.snaplen,
+        opts.promisc,
+        opts.rfmon,
+        timeout,
+        opts.bufferSize,
+        opts.filter
+      )
+    ];
+  }
+  configureWrappers(wrappers, opts);
   // We use the same size for both PCAP's buffer and ours by default. It is an
   // approximation though (we still need to handle overflows) because the
   // encodings are different in each, so data size will vary.
-  return new Sniffer(wrapper, opts.batchSize || opts.bufferSize);
+  return new Sniffer(wrappers, {
+    batchSize: opts.batchSize || opts.bufferSize,
+    threaded: opts.threaded || !!opts.fanout,
+    ringSize: opts.ringSize,
+    mode: opts.mode,
+    lazy: opts.lazy,
+    archive: opts.archive
+  });
+
+  function createTpacketWrapper(fanoutGroup, fanoutMode) {
+    // Memory-mapped capture (Linux only), bypassing PCAP entirely. Note that
+    // `rfmon` isn't supported here: the interface must already be in monitor
+    // mode to capture 802.11 frames.
+    return new utils.Wrapper().fromTpacket(
+      dev,
+      opts.snaplen,
+      opts.promisc,
+      timeout,
+      opts.blockSize,
+      opts.blockCount,
+      opts.blockTimeout,
+      opts.filter,
+      fanoutGroup,
+      fanoutMode
+    );
+  }
 }
 
 /**
  * Factory method for replaying captures from PCAP files.
  *
+ * Besides a BPF `filter`, it supports the same processing options as live
+ * captures (see `configureWrappers`) and the sniffer's own (see `Sniffer`).
+ *
  */
 function createFileSniffer(path, opts) {
   opts = opts || {};
   var wrapper = new utils.Wrapper().fromFile(path, opts.filter);
+  configureWrappers([wrapper], opts);
   var exhausted = false;
-  return new Sniffer(wrapper, opts.batchSize)
+  return new Sniffer(wrapper, opts)
     .on('batch', function (n) {
       // We must do this in two passes because libtin's `FileSniffer` will
       // sometimes return an empty batch even though the file isn't exhausted
@@ -177,6 +603,132 @@ function createFileSniffer(path, opts) {
 
 // Helpers.
 
+/**
+ * Apply options shared by all wrapper types, if specified.
+ *
+ * + `parser`, `'native'` to decode radiotap frames (and the 802.11 frames
+ *   they contain) directly rather than through libtins. This is much cheaper
+ *   and yields the same PDUs, except that their `size` is always the captured
+ *   length (libtins' is smaller when an inner IP packet declares a shorter
+ *   length) and that truncated tagged parameters aren't rejected.
+ * + `mode`, what batches contain (see `Sniffer`).
+ * + `predicates`, expressions over frames' fields (e.g. `'retry and type ==
+ *   dot11.data.QosData'`, see `src/predicates.hpp`) evaluated after any BPF
+ *   `filter`. Only frames matching at least one are kept, and each `batch`'s
+ *   statistics include how many frames each predicate `matches`.
+ * + `payloadSnap`, how many bytes of each ethernet frame's payload are kept.
+ *   Unlike `snaplen`, this doesn't affect predicates nor PDUs' `size`.
+ *   Payloads are always the frame's captured bytes (e.g. invalid checksums
+ *   are kept as is).
+ * + `flowIdleTimeout` and `flowActiveTimeout`, when flows expire in `'flows'`
+ *   mode (see `Sniffer`).
+ * + `stationInterval`, how often stations are snapshotted in `'stations'`
+ *   mode (see `Sniffer`).
+ * + `sampling` (`{method, rate}`), to only keep a fraction `rate` of frames,
+ *   before they are parsed: every `1 / rate`-th frame for the `'count'`
+ *   method, each frame with probability `rate` for `'random'`, or whole
+ *   conversations (frames hashed on their addresses) for `'hash'`. Each
+ *   `batch`'s statistics then include how many frames were `sampled` and the
+ *   `samplingRate` to scale counts by.
+ * + `dedup`, to `'drop'` or `'tag'` (see `Sniffer`) 802.11 retransmissions:
+ *   frames with the retry flag set and the same transmitter, sequence, and
+ *   fragment numbers as their previous one. Each `batch`'s statistics include
+ *   how many `duplicates` were found.
+ *
+ */
+function configureWrappers(wrappers, opts) {
+  wrappers.forEach(function (wrapper) {
+    if (opts.parser !== undefined) {
+      wrapper.setParser(opts.parser);
+    }
+    if (opts.mode !== undefined) {
+      wrapper.setMode(opts.mode);
+    }
+    if (opts.predicates !== undefined) {
+      wrapper.setPredicates(opts.predicates);
+    }
+    if (opts.payloadSnap !== undefined) {
+      wrapper.setPayloadSnap(opts.payloadSnap);
+    }
+    if (
+      opts.flowIdleTimeout !== undefined ||
+      opts.flowActiveTimeout !== undefined
+    ) {
+      wrapper.setFlowTimeouts(opts.flowIdleTimeout, opts.flowActiveTimeout);
+    }
+    if (opts.stationInterval !== undefined) {
+      wrapper.setStationInterval(opts.stationInterval);
+    }
+    if (opts.sampling !== undefined) {
+      wrapper.setSampling(opts.sampling.method, opts.sampling.rate);
+    }
+    if (opts.dedup !== undefined) {
+      wrapper.setDedup(opts.dedup);
+    }
+  });
+}
+
+/**
+ * View a batch's columns (see `Columns` in `src/columns.hpp` for the layout).
+ *
+ */
+function readColumns(buf, n) {
+  var pos = buf.byteOffset + (8 - buf.byteOffset % 8) % 8;
+  var columns = {
+    timestamp: view(Float64Array),
+    addr1: view(Float64Array),
+    addr2: view(Float64Array),
+    addr3: view(Float64Array),
+    size: view(Uint32Array),
+    seqNum: view(Int32Array),
+    rate: view(Int32Array),
+    freq: view(Int32Array),
+    dataOffsets: view(Uint32Array, n + 1),
+    type: view(Uint8Array)
+  };
+  var start = pos - buf.byteOffset; // The data pool comes last.
+  columns.data = buf.slice(start, start + columns.dataOffsets[n]);
+  return columns;
+
+  function view(TypedArray, len) {
+    len = len === undefined ? n : len;
+    var arr = new TypedArray(buf.buffer, pos, len);
+    pos += len * TypedArray.BYTES_PER_ELEMENT;
+    return arr;
+  }
+}
+
+/**
+ * Open an archive for PDUs of the given type.
+ *
+ */
+function openArchive(opts, type) {
+  return new utils.Archive().open(
+    opts.path,
+    type.getSchema(),
+    opts.codec,
+    opts.level,
+    opts.maxSize,
+    opts.maxAge
+  );
+}
+
+/**
+ * Get PDU type (and record type, in aggregating modes), caching them.
+ *
+ */
+function loadTypes(mode, cb) {
+  loadPduType(function (err, pduType) {
+    if (err || !RECORD_EVENTS[mode]) {
+      cb(err, pduType);
+      return;
+    }
+    loadRecordType(mode, function (err, recordType) {
+      cb(err, pduType, recordType);
+    });
+  });
+}
+
 /**
  * Get PDU type from IDL, caching it for future calls.
  *
@@ -191,6 +743,22 @@ function loadPduType(cb) {
   });
 }
 
+/**
+ * Get the type of records emitted in an aggregating mode from IDL, caching it
+ * for future calls.
+ *
+ */
+function loadRecordType(mode, cb) {
+  if (RECORD_TYPES[mode]) {
+    process.nextTick(function () { cb(null, RECORD_TYPES[mode]); });
+    return;
+  }
+  var load = mode === 'flows' ? utils.loadFlowType : utils.loadStationType;
+  load(function (err, type) {
+    cb(err, RECORD_TYPES[mode] = type);
+  });
+}
+
 
 module.exports = {
   Sniffer: Sniffer, // For tests.
@@ -7,8 +7,7 @@
  *
  */
 
-var assert = require('assert'),
-    avro = require('avsc'),
+var avro = require('avsc'),
     path = require('path'),
     util = require('util');
 
@@ -32,6 +31,47 @@ var ADDON = (/* istanbul ignore next */ function () {
  *
  */
 function loadPduType(cb) {
+  loadType('Pdu', function (err, type, registry) {
+    if (err) {
+      cb(err);
+      return;
+    }
+    Object.keys(registry).forEach(function (name) {
+      var type = registry[name];
+      if (type.getName(true) === 'record') {
+        if (/^dot11\./.test(type.getName())) {
+          util.inherits(type.getRecordConstructor(), Dot11Frame);
+        }
+      }
+    });
+
+    cb(null, type);
+  });
+}
+
+/**
+ * Load the Avro type of flow records (emitted in `'flows'` mode).
+ *
+ */
+function loadFlowType(cb) {
+  loadType('Flow', function (err, type) { cb(err, type); });
+}
+
+/**
+ * Load the Avro type of station records (emitted in `'stations'` mode).
+ *
+ */
+function loadStationType(cb) {
+  loadType('Station', function (err, type) { cb(err, type); });
+}
+
+/**
+ * Load a type from the IDL file of the same name.
+ *
+ * The callback is also passed the registry of all types parsed along the way.
+ *
+ */
+function loadType(name, cb) {
   var opts = {
     logicalTypes: {
       address: AddressType,
@@ -41,22 +81,47 @@ function loadPduType(cb) {
     typeHook: createTypeHook()
   };
 
-  var fpath = path.join(__dirname, '..', 'etc', 'idls', 'Pdu.avdl');
+  var fpath = path.join(__dirname, '..', 'etc', 'idls', name + '.avdl');
   avro.assemble(fpath, function (err, attrs) {
-    assert.strictEqual(err, null);
+    if (err) {
+      cb(err);
+      return;
+    }
+    var protocol;
+    try {
+      protocol = avro.parse(attrs, opts);
+    } catch (parseErr) {
+      cb(parseErr);
+      return;
+    }
+    cb(null, protocol.getType(name), opts.registry);
+  });
+}
 
-    var protocol = avro.parse(attrs, opts);
-    Object.keys(opts.registry).forEach(function (name) {
-      var type = opts.registry[name];
-      if (type.getName(true) === 'record') {
-        if (/^dot11\./.test(type.getName())) {
-          util.inherits(type.getRecordConstructor(), Dot11Frame);
-        }
-      }
+/**
+ * Names of the frame types PDUs are tagged with in each batch's index.
+ *
+ * The returned array is indexed by tag: each PDU is tagged with the branch of
+ * its `frame`, or for radiotap PDUs (the last branch) that branch plus their
+ * own frame's, so that every innermost frame type gets its own tag. Radiotap
+ * PDUs without an inner frame are tagged as `Radiotap`.
+ *
+ */
+function getFrameTypeNames(type) {
+  var names = [];
+  type.getFields()[2].getType().getTypes().forEach(function (frameType) {
+    if (frameType.getName() !== 'Radiotap') {
+      names.push(frameType.getName());
+      return;
+    }
+    var field = frameType.getFields().filter(function (field) {
+      return field.getName() === 'frame';
+    })[0];
+    field.getType().getTypes().forEach(function (innerType) {
+      names.push(innerType.getName() || frameType.getName()); // `null` branch.
     });
-
-    cb(null, protocol.getType('Pdu'));
   });
+  return names;
 }
 
 /**
@@ -234,6 +299,99 @@ Address.prototype.toJSON = Address.prototype.toString;
 
 Address.prototype.inspect = Address.prototype.toString;
 
+/**
+ * Lazy view over an encoded PDU.
+ *
+ * Fields are only decoded when first accessed (e.g. reading `size` doesn't
+ * create any addresses or dates). The same view is meant to be moved from PDU
+ * to PDU within a batch, so it must not be held onto: `decode` returns a
+ * standalone copy.
+ *
+ */
+function PduView(type) {
+  this._type = type;
+  this._frameType = type.getFields()[2].getType();
+  this._buf = undefined;
+  this._pos = 0; // Start of the current PDU.
+  this._framePos = -1; // Start of its frame, negative until the header is read.
+  this._size = 0;
+  this._millis = 0;
+  this._timestamp = undefined;
+  this._frame = undefined;
+}
+
+PduView.prototype.decode = function () {
+  return this._type.decode(this._buf, this._pos).value;
+};
+
+PduView.prototype._moveTo = function (buf, pos) {
+  this._buf = buf;
+  this._pos = pos;
+  this._framePos = -1;
+  this._timestamp = undefined;
+  this._frame = undefined;
+};
+
+PduView.prototype._readHeader = function () {
+  // Both fields are varints, cheap enough to read together.
+  this._framePos = this._pos;
+  this._size = this._readLong();
+  this._millis = this._readLong();
+};
+
+/**
+ * Read a zig-zag encoded varint at `_framePos`, advancing past it.
+ *
+ * Arithmetic is used rather than bitwise operators so that values larger than
+ * 32 bits (e.g. timestamps) are exact.
+ *
+ */
+PduView.prototype._readLong = function () {
+  var buf = this._buf;
+  var n = 0;
+  var k = 1;
+  var b;
+  do {
+    b = buf[this._framePos++];
+    n += (b & 0x7f) * k;
+    k *= 128;
+  } while (b & 0x80);
+  return n % 2 ? -(n + 1) / 2 : n / 2;
+};
+
+Object.defineProperty(PduView.prototype, 'size', {
+  get: function () {
+    if (this._framePos < 0) {
+      this._readHeader();
+    }
+    return this._size;
+  }
+});
+
+Object.defineProperty(PduView.prototype, 'timestamp', {
+  get: function () {
+    if (!this._timestamp) {
+      if (this._framePos < 0) {
+        this._readHeader();
+      }
+      this._timestamp = new Date(this._millis);
+    }
+    return this._timestamp;
+  }
+});
+
+Object.defineProperty(PduView.prototype, 'frame', {
+  get: function () {
+    if (this._frame === undefined) {
+      if (this._framePos < 0) {
+        this._readHeader();
+      }
+      this._frame = this._frameType.decode(this._buf, this._framePos).value;
+    }
+    return this._frame;
+  }
+});
+
 /**
  * Base class to augment all 802.11 frames.
  *
@@ -280,7 +438,12 @@ Dot11Frame.prototype.getApAddr = function () {
 
 
 module.exports = {
+  Archive: ADDON.Archive,
+  PduView: PduView,
   Wrapper: ADDON.Wrapper,
+  getFrameTypeNames: getFrameTypeNames,
+  loadFlowType: loadFlowType,
   loadPduType: loadPduType,
+  loadStationType: loadStationType,
   stringifyAddress: ADDON.stringifyAddress
 };
@@ -0,0 +1,62 @@
+#include "allocations.hpp"
+#include <new>
+#include <stdlib.h>
+
+// Calls to the replaced `operator new`, per thread.
+static thread_local uint64_t allocations = 0;
+
+/**
+ * Allocate `size` bytes, counting the call.
+ *
+ * Memory comes from `malloc` (as with the default operators), so it can be
+ * released by any `operator delete`, replaced or not.
+ *
+ */
+static void *allocate(size_t size) {
+  allocations++;
+  return malloc(size ? size : 1);
+}
+
+void *operator new(size_t size) {
+  void *ptr = allocate(size);
+  if (!ptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+  return allocate(size);
+}
+
+void operator delete(void *ptr) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  free(ptr);
+}
+
+#if __cpp_sized_deallocation
+void operator delete(void *ptr, size_t) noexcept {
+  free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept {
+  free(ptr);
+}
+#endif
+
+namespace Layer2 {
+
+uint64_t numAllocations() { return allocations; }
+
+}
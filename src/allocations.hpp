@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Counting of heap allocations, to check that hot paths don't make any.
+ *
+ */
+
+namespace Layer2 {
+
+/**
+ * Number of heap allocations made so far by the calling thread.
+ *
+ * The addon replaces the global `operator new` (and its array and `nothrow`
+ * variants) with versions which count calls before forwarding to `malloc`.
+ * The replacements are kept local to the addon on Linux (see
+ * `allocations.map`), so only allocations made from its own code are counted:
+ * those made inside shared libraries (e.g. libtins's PDU parsing, or the
+ * standard library's explicitly instantiated `std::string`) go through their
+ * own operator and are not.
+ *
+ */
+uint64_t numAllocations();
+
+}
@@ -0,0 +1,104 @@
+#include "archive.hpp"
+
+namespace Layer2 {
+
+NAN_METHOD(Archive::Empty) {}
+
+NAN_METHOD(Archive::Open) {
+  if (
+    info.Length() != 6 ||
+    !info[0]->IsString() ||
+    !info[1]->IsString() ||
+    !(info[2]->IsUndefined() || info[2]->IsString()) ||  // codec
+    !(info[3]->IsUndefined() || info[3]->IsInt32()) ||   // level
+    !(info[4]->IsUndefined() || info[4]->IsNumber()) ||  // maxSize
+    !(info[5]->IsUndefined() || info[5]->IsUint32())     // maxAge
+  ) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  ContainerConfiguration config;
+  Nan::Utf8String path(info[0]);
+  config.path = std::string(*path);
+  Nan::Utf8String schema(info[1]);
+  config.schema = std::string(*schema);
+  if (!info[2]->IsUndefined()) {
+    Nan::Utf8String codec(info[2]);
+    std::string name(*codec);
+    if (name == "null") {
+      config.codec = Codec::NONE;
+    } else if (name == "deflate") {
+      config.codec = Codec::DEFLATE;
+    } else {
+      Nan::ThrowError("unsupported codec");
+      return;
+    }
+  }
+  if (!info[3]->IsUndefined()) {
+    config.level = info[3]->Int32Value();
+  }
+  if (!info[4]->IsUndefined()) {
+    config.maxSize = info[4]->NumberValue();
+  }
+  if (!info[5]->IsUndefined()) {
+    config.maxAge = info[5]->Uint32Value();
+  }
+
+  ContainerWriter *writer;
+  try {
+    writer = new ContainerWriter(config);
+  } catch (std::runtime_error &err) {
+    Nan::ThrowError(err.what());
+    return;
+  }
+
+  Archive *archive = new Archive(writer);
+  archive->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Archive::Write) {
+  if (
+    info.Length() != 3 ||
+    !node::Buffer::HasInstance(info[0]) ||
+    !info[1]->IsUint32() ||
+    !info[2]->IsUint32() ||
+    info[1]->Uint32Value() > node::Buffer::Length(info[0])
+  ) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Archive *archive = ObjectWrap::Unwrap<Archive>(info.This());
+  try {
+    archive->_writer->append(
+      (const uint8_t *) node::Buffer::Data(info[0]),
+      info[1]->Uint32Value(),
+      info[2]->Uint32Value()
+    );
+  } catch (std::runtime_error &err) {
+    Nan::ThrowError(err.what());
+  }
+}
+
+NAN_METHOD(Archive::Close) {
+  Archive *archive = ObjectWrap::Unwrap<Archive>(info.This());
+  try {
+    archive->_writer->close();
+  } catch (std::runtime_error &err) {
+    Nan::ThrowError(err.what());
+  }
+}
+
+v8::Local<v8::FunctionTemplate> Archive::Init() {
+  v8::Local<v8::FunctionTemplate> tpl = Nan::New<v8::FunctionTemplate>(Archive::Empty);
+  tpl->SetClassName(Nan::New("Archive").ToLocalChecked());
+  tpl->InstanceTemplate()->SetInternalFieldCount(1);
+  Nan::SetPrototypeMethod(tpl, "open", Archive::Open);
+  Nan::SetPrototypeMethod(tpl, "write", Archive::Write);
+  Nan::SetPrototypeMethod(tpl, "close", Archive::Close);
+  return tpl;
+}
+
+}
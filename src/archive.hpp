@@ -0,0 +1,53 @@
+#pragma once
+
+#include "container.hpp"
+#include <nan.h>
+
+namespace Layer2 {
+
+/**
+ * JavaScript handle to a `ContainerWriter`, to archive batches of PDUs.
+ *
+ */
+class Archive : public Nan::ObjectWrap {
+public:
+  static v8::Local<v8::FunctionTemplate> Init();
+
+private:
+  std::unique_ptr<ContainerWriter> _writer;
+
+  Archive(ContainerWriter *writer) : _writer(writer) {}
+
+  ~Archive() {}
+
+  /**
+   * Required function constructor.
+   *
+   */
+  static NAN_METHOD(Empty);
+
+  /**
+   * Factory method, taking in a path, the writer schema (as JSON), a codec
+   * (`'null'` or `'deflate'`), a compression level, and the maximum size (in
+   * bytes) and age (in milliseconds) of each file. All but the first two can
+   * be undefined (see `ContainerConfiguration` for defaults).
+   *
+   */
+  static NAN_METHOD(Open);
+
+  /**
+   * Prototype method to append a block, taking in a buffer, the number of
+   * bytes to copy from it, and the number of records these hold.
+   *
+   */
+  static NAN_METHOD(Write);
+
+  /**
+   * Prototype method to write all pending blocks and close the archive. This
+   * blocks until the background thread is done.
+   *
+   */
+  static NAN_METHOD(Close);
+};
+
+}
@@ -0,0 +1,272 @@
+#include "arrow.hpp"
+#include <algorithm>
+#include <functional>
+#include <string.h>
+
+namespace Layer2 {
+
+// Message header and field type union branches (see Arrow's `Message.fbs` and
+// `Schema.fbs`).
+#define LAYER2_ARROW_METADATA_V5 4
+#define LAYER2_ARROW_HEADER_SCHEMA 1
+#define LAYER2_ARROW_HEADER_RECORD_BATCH 3
+#define LAYER2_ARROW_TYPE_INT 2
+#define LAYER2_ARROW_TYPE_BINARY 4
+#define LAYER2_ARROW_TYPE_TIMESTAMP 10
+#define LAYER2_ARROW_UNIT_MICROSECOND 2
+
+// Prefix of encapsulated messages, followed by their metadata's length.
+#define LAYER2_ARROW_CONTINUATION 0xffffffff
+
+/**
+ * Flatbuffer builder, writing objects front to back.
+ *
+ * Tables are written before the objects they point to, so that all offsets
+ * are positive (as required for unsigned offsets); each table's vtable is
+ * written right before it. Positions are relative to the start of the
+ * flatbuffer, which must itself be 8-byte aligned within its message.
+ *
+ */
+class FlatBufferBuilder {
+public:
+  typedef std::function<size_t(FlatBufferBuilder &)> Writer;
+
+  /**
+   * Table field, either inline (scalar `value` of `size` bytes) or an offset
+   * to an object written by `object`.
+   *
+   */
+  struct Slot {
+    uint16_t id;
+    uint8_t size;
+    int64_t value;
+    Writer object;
+
+    Slot(uint16_t id, uint8_t size, int64_t value) :
+    id(id), size(size), value(value) {}
+
+    Slot(uint16_t id, Writer object) :
+    id(id), size(4), value(0), object(object) {}
+  };
+
+  FlatBufferBuilder(std::vector<uint8_t> &buf) : _buf(buf), _start(buf.size()) {}
+
+  /**
+   * Write the root table, then pad the buffer to a multiple of 8 bytes.
+   *
+   */
+  void finish(Writer root) {
+    size_t loc = reserve(4);
+    put(loc, 4, root(*this) - loc);
+    align(8);
+  }
+
+  size_t table(std::vector<Slot> slots) {
+    uint16_t numIds = 0;
+    for (const Slot &slot : slots) {
+      numIds = std::max(numIds, (uint16_t) (slot.id + 1));
+    }
+    align(2);
+    size_t vtable = reserve(4 + 2 * numIds);
+    align(8);
+    size_t table = reserve(4);
+    put(table, 4, table - vtable);
+
+    // Largest fields first, to minimize padding.
+    std::stable_sort(slots.begin(), slots.end(), [](const Slot &a, const Slot &b) {
+      return a.size > b.size;
+    });
+    std::vector<size_t> locs;
+    for (const Slot &slot : slots) {
+      align(slot.size);
+      size_t loc = reserve(slot.size);
+      put(loc, slot.size, slot.value);
+      put(vtable + 4 + 2 * slot.id, 2, loc - table);
+      locs.push_back(loc);
+    }
+    put(vtable, 2, 4 + 2 * numIds);
+    put(vtable + 2, 2, position() - table);
+
+    for (size_t i = 0; i < slots.size(); i++) {
+      if (slots[i].object) {
+        put(locs[i], 4, slots[i].object(*this) - locs[i]);
+      }
+    }
+    return table;
+  }
+
+  size_t tables(size_t n, std::function<size_t(FlatBufferBuilder &, size_t)> element) {
+    align(4);
+    size_t vec = reserve(4 + 4 * n);
+    put(vec, 4, n);
+    for (size_t i = 0; i < n; i++) {
+      size_t loc = vec + 4 + 4 * i;
+      put(loc, 4, element(*this, i) - loc);
+    }
+    return vec;
+  }
+
+  /**
+   * Vector of structs made of 64-bit integers (`width` of them per struct).
+   *
+   */
+  size_t structs(const int64_t *values, size_t n, size_t width) {
+    align(8);
+    reserve(4); // So that the elements following the length are aligned.
+    size_t vec = reserve(4);
+    put(vec, 4, n);
+    for (size_t i = 0; i < n * width; i++) {
+      put(reserve(8), 8, values[i]);
+    }
+    return vec;
+  }
+
+  size_t string(const char *str) {
+    size_t len = strlen(str);
+    align(4);
+    size_t pos = reserve(4 + len + 1);
+    put(pos, 4, len);
+    memcpy(_buf.data() + _start + pos + 4, str, len);
+    return pos;
+  }
+
+private:
+  std::vector<uint8_t> &_buf;
+  size_t _start;
+
+  size_t position() const { return _buf.size() - _start; }
+
+  size_t reserve(size_t len) {
+    size_t pos = position();
+    _buf.resize(_buf.size() + len, 0);
+    return pos;
+  }
+
+  void align(size_t alignment) {
+    reserve((alignment - position() % alignment) % alignment);
+  }
+
+  void put(size_t pos, size_t size, int64_t value) { // Little-endian.
+    for (size_t i = 0; i < size; i++) {
+      _buf[_start + pos + i] = (uint8_t) ((uint64_t) value >> (8 * i));
+    }
+  }
+};
+
+/**
+ * Write a field's type table, returning the corresponding union branch.
+ *
+ */
+static uint8_t writeType(ArrowType type, FlatBufferBuilder::Writer &writer) {
+  int64_t bitWidth;
+  bool isSigned = false;
+  switch (type) {
+  case ArrowType::UINT8:
+    bitWidth = 8;
+    break;
+  case ArrowType::INT32:
+    bitWidth = 32;
+    isSigned = true;
+    break;
+  case ArrowType::UINT32:
+    bitWidth = 32;
+    break;
+  case ArrowType::UINT64:
+    bitWidth = 64;
+    break;
+  case ArrowType::TIMESTAMP_US:
+    writer = [](FlatBufferBuilder &builder) {
+      return builder.table({{0, 2, LAYER2_ARROW_UNIT_MICROSECOND}});
+    };
+    return LAYER2_ARROW_TYPE_TIMESTAMP;
+  default: // Binary.
+    writer = [](FlatBufferBuilder &builder) { return builder.table({}); };
+    return LAYER2_ARROW_TYPE_BINARY;
+  }
+  writer = [bitWidth, isSigned](FlatBufferBuilder &builder) {
+    return builder.table({{0, 4, bitWidth}, {1, 1, isSigned}});
+  };
+  return LAYER2_ARROW_TYPE_INT;
+}
+
+/**
+ * Append an encapsulated message, given its header.
+ *
+ */
+static void writeMessage(
+  std::vector<uint8_t> &dst,
+  uint8_t headerType,
+  FlatBufferBuilder::Writer header,
+  int64_t bodyLength
+) {
+  size_t prefix = dst.size();
+  dst.resize(prefix + 8);
+  FlatBufferBuilder metadata(dst);
+  metadata.finish([&](FlatBufferBuilder &builder) {
+    return builder.table({
+      {0, 2, LAYER2_ARROW_METADATA_V5},
+      {1, 1, headerType},
+      {2, header},
+      {3, 8, bodyLength}
+    });
+  });
+  uint32_t continuation = LAYER2_ARROW_CONTINUATION;
+  uint32_t len = dst.size() - prefix - 8; // Already padded.
+  for (size_t i = 0; i < 4; i++) {
+    dst[prefix + i] = continuation >> (8 * i);
+    dst[prefix + 4 + i] = len >> (8 * i);
+  }
+}
+
+void writeArrowSchema(std::vector<uint8_t> &dst, const std::vector<ArrowField> &fields) {
+  writeMessage(dst, LAYER2_ARROW_HEADER_SCHEMA, [&](FlatBufferBuilder &builder) {
+    return builder.table({
+      {1, [&](FlatBufferBuilder &builder) {
+        return builder.tables(fields.size(), [&](FlatBufferBuilder &builder, size_t i) {
+          const ArrowField &field = fields[i];
+          FlatBufferBuilder::Writer type;
+          uint8_t typeType = writeType(field.type, type);
+          return builder.table({
+            {0, [&](FlatBufferBuilder &builder) { return builder.string(field.name); }},
+            {1, 1, field.nullable},
+            {2, 1, typeType},
+            {3, type},
+            {5, [](FlatBufferBuilder &builder) { // Readers expect it to be set.
+              return builder.tables(0, nullptr);
+            }}
+          });
+        });
+      }}
+    });
+  }, 0);
+}
+
+void writeArrowRecordBatch(
+  std::vector<uint8_t> &dst,
+  int64_t length,
+  const std::vector<ArrowNode> &nodes,
+  const std::vector<ArrowBuffer> &buffers,
+  int64_t bodyLength
+) {
+  writeMessage(dst, LAYER2_ARROW_HEADER_RECORD_BATCH, [&](FlatBufferBuilder &builder) {
+    return builder.table({
+      {0, 8, length},
+      {1, [&](FlatBufferBuilder &builder) {
+        return builder.structs((const int64_t *) nodes.data(), nodes.size(), 2);
+      }},
+      {2, [&](FlatBufferBuilder &builder) {
+        return builder.structs((const int64_t *) buffers.data(), buffers.size(), 2);
+      }}
+    });
+  }, bodyLength);
+}
+
+void writeArrowEos(std::vector<uint8_t> &dst) {
+  uint32_t continuation = LAYER2_ARROW_CONTINUATION;
+  for (size_t i = 0; i < 4; i++) {
+    dst.push_back(continuation >> (8 * i));
+  }
+  dst.insert(dst.end(), 4, 0);
+}
+
+}
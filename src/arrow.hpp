@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Minimal Arrow IPC encoder (streaming format).
+ *
+ * Only what's needed to write flat schemas of primitive and binary columns is
+ * supported. Message metadata (Flatbuffers tables, see Arrow's `Schema.fbs`
+ * and `Message.fbs`) is written by hand rather than pulling in the Arrow and
+ * Flatbuffers libraries. See https://arrow.apache.org/docs/format/Columnar.html
+ *
+ */
+
+namespace Layer2 {
+
+// Marker ending an Arrow IPC stream.
+#define LAYER2_ARROW_EOS_SIZE 8
+
+// Round a length up to Arrow's buffer alignment.
+inline size_t arrowPad(size_t len) { return (len + 7) & ~((size_t) 7); }
+
+enum class ArrowType {
+  UINT8,
+  INT32,
+  UINT32,
+  UINT64,
+  TIMESTAMP_US, // 64-bit, microseconds since the epoch (without timezone).
+  BINARY // 32-bit offsets.
+};
+
+struct ArrowField {
+  const char *name;
+  ArrowType type;
+  bool nullable;
+};
+
+/**
+ * Length and number of nulls of a column in a record batch.
+ *
+ */
+struct ArrowNode {
+  int64_t length;
+  int64_t nullCount;
+};
+
+/**
+ * Position of a buffer within a record batch's body.
+ *
+ */
+struct ArrowBuffer {
+  int64_t offset;
+  int64_t length;
+};
+
+/**
+ * Append an encapsulated schema message.
+ *
+ */
+void writeArrowSchema(std::vector<uint8_t> &dst, const std::vector<ArrowField> &fields);
+
+/**
+ * Append an encapsulated record batch message's prefix and metadata.
+ *
+ * The message's body (`bodyLength` bytes, holding all buffers) must directly
+ * follow. The size written only depends on the number of nodes and buffers.
+ *
+ */
+void writeArrowRecordBatch(
+  std::vector<uint8_t> &dst,
+  int64_t length,
+  const std::vector<ArrowNode> &nodes,
+  const std::vector<ArrowBuffer> &buffers,
+  int64_t bodyLength
+);
+
+/**
+ * Append the end-of-stream marker.
+ *
+ */
+void writeArrowEos(std::vector<uint8_t> &dst);
+
+}
@@ -1,423 +1,639 @@
 #include "codecs.hpp"
+#include "parser.hpp"
+#include <algorithm>
+#include <utility>
 
 namespace Layer2 {
 
-// Generic.
+// Raw frames.
+
+std::unique_ptr<Tins::PDU> parse(const Frame &frame) {
+  switch (frame.linkType) {
+  case DLT_EN10MB:
+    return std::unique_ptr<Tins::PDU>(new Tins::EthernetII(frame.data, frame.caplen));
+  case DLT_IEEE802_11_RADIO:
+    return std::unique_ptr<Tins::PDU>(new Tins::RadioTap(frame.data, frame.caplen));
+  case DLT_IEEE802_11:
+    return std::unique_ptr<Tins::PDU>(Tins::Dot11::from_bytes(frame.data, frame.caplen));
+  default:
+    return std::unique_ptr<Tins::PDU>();
+  }
+}
 
-std::unique_ptr<Layer2::Unsupported> convert(const Tins::PDU &src) {
-  Layer2::Unsupported *dst = new Layer2::Unsupported;
-  dst->name = Tins::Utils::to_string(src.pdu_type());
-  return std::unique_ptr<Layer2::Unsupported>(dst);
+/**
+ * Store a value in little-endian order.
+ *
+ */
+template <typename T>
+static uint8_t *storeLittleEndian(uint8_t *dst, T n) {
+  for (size_t i = 0; i < sizeof(T); i++) {
+    *dst++ = (uint8_t) (n >> (8 * i));
+  }
+  return dst;
 }
 
-// Ethernet II.
+void encodeRaw(Writer &writer, const Frame &frame) {
+  uint8_t header[LAYER2_RAW_HEADER_SIZE];
+  uint8_t *pos = header;
+  pos = storeLittleEndian<uint64_t>(pos, (uint64_t) frame.ts.tv_sec * 1000000 + frame.ts.tv_usec);
+  pos = storeLittleEndian<uint32_t>(pos, frame.caplen);
+  pos = storeLittleEndian<uint32_t>(pos, frame.len);
+  storeLittleEndian<uint32_t>(pos, frame.linkType);
+  writer.writeFixed<LAYER2_RAW_HEADER_SIZE>(header);
+  writer.writeFixed(frame.data, frame.caplen);
+}
 
-std::unique_ptr<Layer2::Ethernet2> convert(const Tins::EthernetII &src) {
-  Layer2::Ethernet2 *dst = new Layer2::Ethernet2;
+// Union branches (indices are generated from `etc/idls`).
 
-  src.src_addr().copy(dst->srcAddr.data());
-  src.dst_addr().copy(dst->dstAddr.data());
-  dst->payloadType = src.payload_type();
+typedef Layer2::Pdu::frame_t PduFrame;
+typedef Layer2::Radiotap::frame_t RadiotapFrame;
 
+// Generic.
+
+static void encodeMacAddr(Writer &writer, const Tins::HWAddress<6> &addr) {
+  writer.writeFixed<6>(addr.begin());
+}
+
+// Ethernet II.
+
+static void encode(
+  Writer &writer,
+  const Tins::EthernetII &src,
+  const Frame &frame,
+  uint32_t payloadSnap
+) {
+  encodeMacAddr(writer, src.src_addr());
+  encodeMacAddr(writer, src.dst_addr());
+  writer.writeInt(src.payload_type());
+
+  // The payload is written straight from the frame rather than serialized back
+  // from the inner PDU, so that snapping it doesn't first require a copy of it
+  // all. The bytes are therefore those captured: `serialize` would instead
+  // recompute the inner PDUs' checksums and length fields.
   Tins::PDU *innerPdu = src.inner_pdu();
-  if (innerPdu) {
-    dst->data = const_cast<Tins::PDU &>(*innerPdu).serialize();
+  uint32_t offset = src.header_size();
+  if (!innerPdu || offset >= frame.caplen) {
+    writer.writeBytes(frame.data, 0);
+  } else {
+    uint32_t len = std::min(innerPdu->size(), frame.caplen - offset);
+    writer.writeBytes(frame.data + offset, std::min(len, payloadSnap));
   }
-
-  return std::unique_ptr<Layer2::Ethernet2>(dst);
 }
 
 // 802.11.
 
 // A few helpers first for the nested headers.
 
-void populateDot11Header(Layer2::dot11_Header &dst, const Tins::Dot11 &src) {
-  dst.toDs = src.to_ds();
-  dst.fromDs = src.from_ds();
-  dst.moreFrag = src.more_frag();
-  dst.retry = src.retry();
-  dst.powerMgmt = src.power_mgmt();
-  dst.wep = src.wep();
-  dst.order = src.order();
-  dst.durationId = src.duration_id();
-  src.addr1().copy(dst.addr1.data());
+static void encodeDot11Header(Writer &writer, const Tins::Dot11 &src) {
+  writer.writeBoolean(src.to_ds());
+  writer.writeBoolean(src.from_ds());
+  writer.writeBoolean(src.more_frag());
+  writer.writeBoolean(src.retry());
+  writer.writeBoolean(src.power_mgmt());
+  writer.writeBoolean(src.wep());
+  writer.writeBoolean(src.order());
+  writer.writeInt(src.duration_id());
+  encodeMacAddr(writer, src.addr1());
 }
 
-void populateDot11DataHeader(Layer2::dot11_data_Header &dst, const Tins::Dot11Data &src) {
-  dst.fragNum = src.frag_num();
-  dst.seqNum = src.seq_num();
-  src.addr2().copy(dst.addr2.data());
-  src.addr3().copy(dst.addr3.data());
-  src.addr4().copy(dst.addr4.data());
+static void encodeDot11DataHeader(Writer &writer, const Tins::Dot11Data &src) {
+  encodeMacAddr(writer, src.addr2());
+  encodeMacAddr(writer, src.addr3());
+  encodeMacAddr(writer, src.addr4());
+  writer.writeInt(src.frag_num());
+  writer.writeInt(src.seq_num());
 }
 
-void populateDot11MgmtHeader(Layer2::dot11_mgmt_Header &dst, const Tins::Dot11ManagementFrame &src) {
-  dst.fragNum = src.frag_num();
-  dst.seqNum = src.seq_num();
-  src.addr2().copy(dst.addr2.data());
-  src.addr3().copy(dst.addr3.data());
-  src.addr4().copy(dst.addr4.data());
+static void encodeDot11MgmtHeader(Writer &writer, const Tins::Dot11ManagementFrame &src) {
+  encodeMacAddr(writer, src.addr2());
+  encodeMacAddr(writer, src.addr3());
+  encodeMacAddr(writer, src.addr4());
+  writer.writeInt(src.frag_num());
+  writer.writeInt(src.seq_num());
 }
 
-void populateDot11Capabilities(
-  std::vector<Layer2::dot11_mgmt_Capability> &dst,
+static void encodeDot11Capabilities(
+  Writer &writer,
   const Tins::Dot11ManagementFrame::capability_information &src
 ) {
+  // Arrays are prefixed by their length, so we collect the items first.
+  Layer2::dot11_mgmt_Capability items[16];
+  size_t count = 0;
   if (src.ess()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::ESS);
+    items[count++] = Layer2::dot11_mgmt_Capability::ESS;
   }
   if (src.ibss()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::IBSS);
+    items[count++] = Layer2::dot11_mgmt_Capability::IBSS;
   }
   if (src.cf_poll()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::CF_POLL);
+    items[count++] = Layer2::dot11_mgmt_Capability::CF_POLL;
   }
   if (src.cf_poll_req()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::CF_POLL_REQ);
+    items[count++] = Layer2::dot11_mgmt_Capability::CF_POLL_REQ;
   }
   if (src.privacy()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::PRIVACY);
+    items[count++] = Layer2::dot11_mgmt_Capability::PRIVACY;
   }
   if (src.short_preamble()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::SHORT_PREAMBLE);
+    items[count++] = Layer2::dot11_mgmt_Capability::SHORT_PREAMBLE;
   }
   if (src.pbcc()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::PBCC);
+    items[count++] = Layer2::dot11_mgmt_Capability::PBCC;
   }
   if (src.channel_agility()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::CHANNEL_AGILITY);
+    items[count++] = Layer2::dot11_mgmt_Capability::CHANNEL_AGILITY;
   }
   if (src.spectrum_mgmt()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::SPECTRUM_MGMT);
+    items[count++] = Layer2::dot11_mgmt_Capability::SPECTRUM_MGMT;
   }
   if (src.qos()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::QOS);
+    items[count++] = Layer2::dot11_mgmt_Capability::QOS;
   }
   if (src.sst()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::SST);
+    items[count++] = Layer2::dot11_mgmt_Capability::SST;
   }
   if (src.apsd()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::APSD);
+    items[count++] = Layer2::dot11_mgmt_Capability::APSD;
   }
   if (src.radio_measurement()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::RADIO_MEASUREMENT);
+    items[count++] = Layer2::dot11_mgmt_Capability::RADIO_MEASUREMENT;
   }
   if (src.dsss_ofdm()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::DSSS_OFDM);
+    items[count++] = Layer2::dot11_mgmt_Capability::DSSS_OFDM;
   }
   if (src.delayed_block_ack()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::DELAYED_BLOCK_ACK);
+    items[count++] = Layer2::dot11_mgmt_Capability::DELAYED_BLOCK_ACK;
   }
   if (src.immediate_block_ack()) {
-    dst.push_back(Layer2::dot11_mgmt_Capability::IMMEDIATE_BLOCK_ACK);
+    items[count++] = Layer2::dot11_mgmt_Capability::IMMEDIATE_BLOCK_ACK;
   }
+  writer.writeArrayStart(count);
+  for (size_t i = 0; i < count; i++) {
+    writer.writeEnum(items[i]);
+  }
+  writer.writeArrayEnd();
 }
 
 // Now the actual PDUs.
 
-std::unique_ptr<Layer2::dot11_ctrl_Ack> convert(const Tins::Dot11Ack &src) {
-  Layer2::dot11_ctrl_Ack *dst = new Layer2::dot11_ctrl_Ack;
-  populateDot11Header(dst->header, src);
-  return std::unique_ptr<Layer2::dot11_ctrl_Ack>(dst);
+static void encode(Writer &writer, const Tins::Dot11Ack &src) {
+  encodeDot11Header(writer, src);
+}
+
+static void encode(Writer &writer, const Tins::Dot11BlockAck &src) {
+  encodeDot11Header(writer, src);
+  // Control fields aren't extracted yet, they keep their default value.
+  writer.writeInt(0); // barControl
+  writer.writeInt(0); // startSeq
+  writer.writeInt(0); // fragNum
+}
+
+static void encode(Writer &writer, const Tins::Dot11BlockAckRequest &src) {
+  encodeDot11Header(writer, src);
+  writer.writeInt(0); // barControl
+  writer.writeInt(0); // startSeq
+  writer.writeInt(0); // fragNum
 }
 
-std::unique_ptr<Layer2::dot11_ctrl_BlockAck> convert(const Tins::Dot11BlockAck &src) {
-  Layer2::dot11_ctrl_BlockAck *dst = new Layer2::dot11_ctrl_BlockAck;
-  populateDot11Header(dst->header, src);
-  return std::unique_ptr<Layer2::dot11_ctrl_BlockAck>(dst);
+static void encode(Writer &writer, const Tins::Dot11CFEnd &src) {
+  encodeDot11Header(writer, src);
 }
 
-std::unique_ptr<Layer2::dot11_ctrl_BlockAckRequest> convert(const Tins::Dot11BlockAckRequest &src) {
-  Layer2::dot11_ctrl_BlockAckRequest *dst = new Layer2::dot11_ctrl_BlockAckRequest;
-  populateDot11Header(dst->header, src);
-  return std::unique_ptr<Layer2::dot11_ctrl_BlockAckRequest>(dst);
+static void encode(Writer &writer, const Tins::Dot11EndCFAck &src) {
+  encodeDot11Header(writer, src);
 }
 
-std::unique_ptr<Layer2::dot11_ctrl_CfEnd> convert(const Tins::Dot11CFEnd &src) {
-  Layer2::dot11_ctrl_CfEnd *dst = new Layer2::dot11_ctrl_CfEnd;
-  populateDot11Header(dst->header, src);
-  return std::unique_ptr<Layer2::dot11_ctrl_CfEnd>(dst);
+static void encode(Writer &writer, const Tins::Dot11PSPoll &src) {
+  encodeDot11Header(writer, src);
 }
 
-std::unique_ptr<Layer2::dot11_ctrl_EndCfAck> convert(const Tins::Dot11EndCFAck &src) {
-  Layer2::dot11_ctrl_EndCfAck *dst = new Layer2::dot11_ctrl_EndCfAck;
-  populateDot11Header(dst->header, src);
-  return std::unique_ptr<Layer2::dot11_ctrl_EndCfAck>(dst);
+static void encode(Writer &writer, const Tins::Dot11RTS &src) {
+  encodeDot11Header(writer, src);
 }
 
-std::unique_ptr<Layer2::dot11_ctrl_PsPoll> convert(const Tins::Dot11PSPoll &src) {
-  Layer2::dot11_ctrl_PsPoll *dst = new Layer2::dot11_ctrl_PsPoll;
-  populateDot11Header(dst->header, src);
-  return std::unique_ptr<Layer2::dot11_ctrl_PsPoll>(dst);
+static void encode(Writer &writer, const Tins::Dot11Data &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11DataHeader(writer, src);
 }
 
-std::unique_ptr<Layer2::dot11_ctrl_Rts> convert(const Tins::Dot11RTS &src) {
-  Layer2::dot11_ctrl_Rts *dst = new Layer2::dot11_ctrl_Rts;
-  populateDot11Header(dst->header, src);
-  return std::unique_ptr<Layer2::dot11_ctrl_Rts>(dst);
+static void encode(Writer &writer, const Tins::Dot11QoSData &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11DataHeader(writer, src);
+  writer.writeInt(src.qos_control());
 }
 
-std::unique_ptr<Layer2::dot11_data_Data> convert(const Tins::Dot11Data &src) {
-  Layer2::dot11_data_Data *dst = new Layer2::dot11_data_Data;
-  populateDot11Header(dst->header, src);
-  populateDot11DataHeader(dst->dataHeader, src);
-  return std::unique_ptr<Layer2::dot11_data_Data>(dst);
+static void encode(Writer &writer, const Tins::Dot11AssocRequest &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  encodeDot11Capabilities(writer, src.capabilities());
+  writer.writeInt(src.listen_interval());
 }
 
-std::unique_ptr<Layer2::dot11_data_QosData> convert(const Tins::Dot11QoSData &src) {
-  Layer2::dot11_data_QosData *dst = new Layer2::dot11_data_QosData;
-  populateDot11Header(dst->header, src);
-  populateDot11DataHeader(dst->dataHeader, src);
-  dst->qosControl = src.qos_control();
-  return std::unique_ptr<Layer2::dot11_data_QosData>(dst);
+static void encode(Writer &writer, const Tins::Dot11AssocResponse &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  encodeDot11Capabilities(writer, src.capabilities());
+  writer.writeInt(src.status_code());
+  writer.writeInt(src.aid());
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_AssocRequest> convert(const Tins::Dot11AssocRequest &src) {
-  Layer2::dot11_mgmt_AssocRequest *dst = new Layer2::dot11_mgmt_AssocRequest;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  populateDot11Capabilities(dst->capabilities, src.capabilities());
-  dst->listenInterval = src.listen_interval();
-  return std::unique_ptr<Layer2::dot11_mgmt_AssocRequest>(dst);
+static void encode(Writer &writer, const Tins::Dot11Authentication &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  writer.writeInt(src.auth_algorithm());
+  writer.writeInt(src.auth_seq_number());
+  writer.writeInt(src.status_code());
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_AssocResponse> convert(const Tins::Dot11AssocResponse &src) {
-  Layer2::dot11_mgmt_AssocResponse *dst = new Layer2::dot11_mgmt_AssocResponse;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  populateDot11Capabilities(dst->capabilities, src.capabilities());
-  dst->statusCode = src.status_code();
-  dst->aid = src.aid();
-  return std::unique_ptr<Layer2::dot11_mgmt_AssocResponse>(dst);
+static void encode(Writer &writer, const Tins::Dot11Beacon &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  writer.writeLong(src.timestamp());
+  writer.writeInt(src.interval());
+  encodeDot11Capabilities(writer, src.capabilities());
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_Authentication> convert(const Tins::Dot11Authentication &src) {
-  Layer2::dot11_mgmt_Authentication *dst = new Layer2::dot11_mgmt_Authentication;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  dst->authAlgorithm = src.auth_algorithm();
-  dst->authSeqNumber = src.auth_seq_number();
-  dst->statusCode = src.status_code();
-  return std::unique_ptr<Layer2::dot11_mgmt_Authentication>(dst);
+static void encode(Writer &writer, const Tins::Dot11Deauthentication &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  writer.writeInt(src.reason_code());
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_Beacon> convert(const Tins::Dot11Beacon &src) {
-  Layer2::dot11_mgmt_Beacon *dst = new Layer2::dot11_mgmt_Beacon;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  dst->timestamp = src.timestamp();
-  dst->interval = src.interval();
-  populateDot11Capabilities(dst->capabilities, src.capabilities());
-  return std::unique_ptr<Layer2::dot11_mgmt_Beacon>(dst);
+static void encode(Writer &writer, const Tins::Dot11Disassoc &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  writer.writeInt(src.reason_code());
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_Deauthentication> convert(const Tins::Dot11Deauthentication &src) {
-  Layer2::dot11_mgmt_Deauthentication *dst = new Layer2::dot11_mgmt_Deauthentication;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  dst->reasonCode = src.reason_code();
-  return std::unique_ptr<Layer2::dot11_mgmt_Deauthentication>(dst);
+static void encode(Writer &writer, const Tins::Dot11ProbeRequest &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_Disassoc> convert(const Tins::Dot11Disassoc &src) {
-  Layer2::dot11_mgmt_Disassoc *dst = new Layer2::dot11_mgmt_Disassoc;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  dst->reasonCode = src.reason_code();
-  return std::unique_ptr<Layer2::dot11_mgmt_Disassoc>(dst);
+static void encode(Writer &writer, const Tins::Dot11ProbeResponse &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  writer.writeLong(src.timestamp());
+  writer.writeInt(src.interval());
+  encodeDot11Capabilities(writer, src.capabilities());
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_ProbeRequest> convert(const Tins::Dot11ProbeRequest &src) {
-  Layer2::dot11_mgmt_ProbeRequest *dst = new Layer2::dot11_mgmt_ProbeRequest;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  return std::unique_ptr<Layer2::dot11_mgmt_ProbeRequest>(dst);
+static void encode(Writer &writer, const Tins::Dot11ReAssocRequest &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  encodeDot11Capabilities(writer, src.capabilities());
+  writer.writeInt(src.listen_interval());
+  encodeMacAddr(writer, src.current_ap());
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_ProbeResponse> convert(const Tins::Dot11ProbeResponse &src) {
-  Layer2::dot11_mgmt_ProbeResponse *dst = new Layer2::dot11_mgmt_ProbeResponse;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  dst->timestamp = src.timestamp();
-  dst->interval = src.interval();
-  populateDot11Capabilities(dst->capabilities, src.capabilities());
-  return std::unique_ptr<Layer2::dot11_mgmt_ProbeResponse>(dst);
+static void encode(Writer &writer, const Tins::Dot11ReAssocResponse &src) {
+  encodeDot11Header(writer, src);
+  encodeDot11MgmtHeader(writer, src);
+  encodeDot11Capabilities(writer, src.capabilities());
+  writer.writeInt(src.status_code());
+  writer.writeInt(src.aid());
 }
 
-std::unique_ptr<Layer2::dot11_mgmt_ReassocRequest> convert(const Tins::Dot11ReAssocRequest &src) {
-  Layer2::dot11_mgmt_ReassocRequest *dst = new Layer2::dot11_mgmt_ReassocRequest;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  populateDot11Capabilities(dst->capabilities, src.capabilities());
-  dst->listenInterval = src.listen_interval();
-  src.current_ap().copy(dst->currentAp.data());
-  return std::unique_ptr<Layer2::dot11_mgmt_ReassocRequest>(dst);
-}
-
-std::unique_ptr<Layer2::dot11_mgmt_ReassocResponse> convert(const Tins::Dot11ReAssocResponse &src) {
-  Layer2::dot11_mgmt_ReassocResponse *dst = new Layer2::dot11_mgmt_ReassocResponse;
-  populateDot11Header(dst->header, src);
-  populateDot11MgmtHeader(dst->mgmtHeader, src);
-  populateDot11Capabilities(dst->capabilities, src.capabilities());
-  dst->statusCode = src.status_code();
-  dst->aid = src.aid();
-  return std::unique_ptr<Layer2::dot11_mgmt_ReassocResponse>(dst);
-}
-
-std::unique_ptr<Layer2::dot11_Unsupported> convert(const Tins::Dot11 &src) {
-  Layer2::dot11_Unsupported *dst = new Layer2::dot11_Unsupported;
-  populateDot11Header(dst->header, src);
-  dst->type = src.type();
-  dst->subtype = src.subtype();
-  return std::unique_ptr<Layer2::dot11_Unsupported>(dst);
+static void encode(Writer &writer, const Tins::Dot11 &src) {
+  encodeDot11Header(writer, src);
+  writer.writeInt(src.type());
+  writer.writeInt(src.subtype());
 }
 
 // Radiotap.
 
-std::unique_ptr<Layer2::Radiotap> convert(const Tins::RadioTap &src) {
-  Layer2::Radiotap *dst = new Layer2::Radiotap();
+static void encodeRadiotapFlags(Writer &writer, const Tins::RadioTap &src) {
+  Layer2::radiotap_Flag items[8];
+  size_t count = 0;
+  Tins::RadioTap::FrameFlags frameFlags = src.flags();
+  if (frameFlags & Tins::RadioTap::FrameFlags::CFP) {
+    items[count++] = Layer2::radiotap_Flag::CFP;
+  }
+  if (frameFlags & Tins::RadioTap::FrameFlags::PREAMBLE) {
+    items[count++] = Layer2::radiotap_Flag::PREAMBLE;
+  }
+  if (frameFlags & Tins::RadioTap::FrameFlags::WEP) {
+    items[count++] = Layer2::radiotap_Flag::WEP;
+  }
+  if (frameFlags & Tins::RadioTap::FrameFlags::FRAGMENTATION) {
+    items[count++] = Layer2::radiotap_Flag::FRAGMENTATION;
+  }
+  if (frameFlags & Tins::RadioTap::FrameFlags::FCS) {
+    items[count++] = Layer2::radiotap_Flag::FCS;
+  }
+  if (frameFlags & Tins::RadioTap::FrameFlags::PADDING) {
+    items[count++] = Layer2::radiotap_Flag::PADDING;
+  }
+  if (frameFlags & Tins::RadioTap::FrameFlags::FAILED_FCS) {
+    items[count++] = Layer2::radiotap_Flag::FAILED_FCS;
+  }
+  if (frameFlags & Tins::RadioTap::FrameFlags::SHORT_GI) {
+    items[count++] = Layer2::radiotap_Flag::SHORT_GI;
+  }
+  writer.writeArrayStart(count);
+  for (size_t i = 0; i < count; i++) {
+    writer.writeEnum(items[i]);
+  }
+  writer.writeArrayEnd();
+}
 
-  Tins::RadioTap::PresentFlags present = src.present();
-  if (present & Tins::RadioTap::PresentFlags::TSTF) {
-    dst->tsft.set_long(src.tsft());
+static void encodeRadiotapChannel(Writer &writer, const Tins::RadioTap &src) {
+  writer.writeInt(src.channel_freq());
+  switch (src.channel_type()) {
+  case Tins::RadioTap::TURBO:
+    writer.writeEnum(Layer2::radiotap_ChannelType::TURBO);
+    break;
+  case Tins::RadioTap::CCK:
+    writer.writeEnum(Layer2::radiotap_ChannelType::CCK);
+    break;
+  case Tins::RadioTap::OFDM:
+    writer.writeEnum(Layer2::radiotap_ChannelType::OFDM);
+    break;
+  case Tins::RadioTap::TWO_GZ:
+    writer.writeEnum(Layer2::radiotap_ChannelType::TWO_GZ);
+    break;
+  case Tins::RadioTap::FIVE_GZ:
+    writer.writeEnum(Layer2::radiotap_ChannelType::FIVE_GZ);
+    break;
+  case Tins::RadioTap::PASSIVE:
+    writer.writeEnum(Layer2::radiotap_ChannelType::PASSIVE);
+    break;
+  case Tins::RadioTap::DYN_CCK_OFDM:
+    writer.writeEnum(Layer2::radiotap_ChannelType::DYN_CCK_OFDM);
+    break;
+  case Tins::RadioTap::GFSK:
+    writer.writeEnum(Layer2::radiotap_ChannelType::GFSK);
+    break;
+  default:
+    writer.writeEnum(Layer2::radiotap_ChannelType());
   }
+}
 
-  if (present & Tins::RadioTap::PresentFlags::FLAGS) {
-    Tins::RadioTap::FrameFlags frameFlags = src.flags();
-    std::vector<Layer2::radiotap_Flag> flags;
-    if (frameFlags & Tins::RadioTap::FrameFlags::CFP) {
-      flags.push_back(Layer2::radiotap_Flag::CFP);
-    }
-    if (frameFlags & Tins::RadioTap::FrameFlags::PREAMBLE) {
-      flags.push_back(Layer2::radiotap_Flag::PREAMBLE);
-    }
-    if (frameFlags & Tins::RadioTap::FrameFlags::WEP) {
-      flags.push_back(Layer2::radiotap_Flag::WEP);
-    }
-    if (frameFlags & Tins::RadioTap::FrameFlags::FRAGMENTATION) {
-      flags.push_back(Layer2::radiotap_Flag::FRAGMENTATION);
-    }
-    if (frameFlags & Tins::RadioTap::FrameFlags::FCS) {
-      flags.push_back(Layer2::radiotap_Flag::FCS);
-    }
-    if (frameFlags & Tins::RadioTap::FrameFlags::PADDING) {
-      flags.push_back(Layer2::radiotap_Flag::PADDING);
+/**
+ * Encode a radiotap frame's inner PDU as the corresponding branch.
+ *
+ */
+template <typename T>
+static size_t encodeFrame(Writer &writer, size_t index, const Tins::PDU &src) {
+  writer.writeUnionIndex(index);
+  encode(writer, static_cast<const T &>(src));
+  return index;
+}
+
+/**
+ * Capacity of a radiotap frame's capabilities (0 for frames without any).
+ *
+ */
+static size_t getCapacity(const Layer2::Radiotap::frame_t &frame) {
+  switch (frame.idx()) {
+  case RadiotapFrame::dot11_mgmt_AssocRequest_index:
+    return frame.get_dot11_mgmt_AssocRequest().capabilities.capacity();
+  case RadiotapFrame::dot11_mgmt_AssocResponse_index:
+    return frame.get_dot11_mgmt_AssocResponse().capabilities.capacity();
+  case RadiotapFrame::dot11_mgmt_Beacon_index:
+    return frame.get_dot11_mgmt_Beacon().capabilities.capacity();
+  case RadiotapFrame::dot11_mgmt_ProbeResponse_index:
+    return frame.get_dot11_mgmt_ProbeResponse().capabilities.capacity();
+  case RadiotapFrame::dot11_mgmt_ReassocRequest_index:
+    return frame.get_dot11_mgmt_ReassocRequest().capabilities.capacity();
+  case RadiotapFrame::dot11_mgmt_ReassocResponse_index:
+    return frame.get_dot11_mgmt_ReassocResponse().capabilities.capacity();
+  default:
+    return 0;
+  }
+}
+
+// Converter.
+
+Converter::Converter() :
+_parser(Parser::TINS),
+_flagsCapacity(0),
+_capabilitiesCapacities(RadiotapFrame::dot11_mgmt_ReassocResponse_index + 1, 0),
+_numBufferGrowths(0),
+_tag(0),
+_payloadSnap(UINT32_MAX),
+_dedup(DedupMode::NONE),
+_duplicate(false),
+_numDuplicates(0) {}
+
+void Converter::setPredicates(const std::vector<Predicate> &predicates) {
+  _predicates = predicates;
+  _numMatches.assign(predicates.size(), 0);
+}
+
+bool Converter::accept(const Frame &frame) {
+  if (_predicates.empty()) {
+    return !suppress(frame);
+  }
+  return extract(frame);
+}
+
+const FieldValues *Converter::extract(const Frame &frame) {
+  if (suppress(frame)) {
+    return NULL;
+  }
+  bool radiotap = frame.linkType == DLT_IEEE802_11_RADIO;
+  if (radiotap && !parseRadiotap(frame, _radiotap)) {
+    return NULL;
+  }
+  _values.extract(frame, radiotap ? &_radiotap : NULL);
+  return _predicates.empty() || matches() ? &_values : NULL;
+}
+
+bool Converter::suppress(const Frame &frame) {
+  _duplicate = false;
+  if (_dedup == DedupMode::NONE || !_deduplicator.check(frame)) {
+    return false;
+  }
+  _numDuplicates++;
+  if (_dedup == DedupMode::DROP) {
+    return true;
+  }
+  _duplicate = true;
+  return false;
+}
+
+bool Converter::matches() {
+  bool matched = false;
+  for (size_t i = 0; i < _predicates.size(); i++) {
+    if (_predicates[i].matches(_values)) { // Evaluate all, for the counters.
+      _numMatches[i]++;
+      matched = true;
     }
-    if (frameFlags & Tins::RadioTap::FrameFlags::FAILED_FCS) {
-      flags.push_back(Layer2::radiotap_Flag::FAILED_FCS);
+  }
+  return matched;
+}
+
+bool Converter::encode(Writer &writer, const Frame &frame) {
+  if (!accept(frame)) {
+    return false;
+  }
+
+  if (frame.linkType == DLT_IEEE802_11_RADIO && _parser == Parser::NATIVE) {
+    if (_predicates.empty() && !parseRadiotap(frame, _radiotap)) {
+      return false; // Otherwise already parsed by `accept`.
     }
-    if (frameFlags & Tins::RadioTap::FrameFlags::SHORT_GI) {
-      flags.push_back(Layer2::radiotap_Flag::SHORT_GI);
+    if (!_radiotap.flags.is_null()) {
+      track(_flagsCapacity, _radiotap.flags.get_array().capacity());
     }
-    dst->flags.set_array(flags);
+    track(_capabilitiesCapacities[_radiotap.frame.idx()], getCapacity(_radiotap.frame));
+    // Tins' radiotap PDUs span the entire frame (including any FCS), unless an
+    // inner layer declares a shorter length. Inner layers aren't parsed here,
+    // so this can be larger than tins' size (see `Parser`).
+    writer.writeInt(frame.caplen);
+    writer.writeLong((int64_t) frame.ts.tv_sec * 1000 + frame.ts.tv_usec / 1000);
+    writer.writeUnionIndex(PduFrame::Radiotap_index);
+    Layer2::write(writer, _radiotap);
+    _tag = frameTag(PduFrame::Radiotap_index, _radiotap.frame.idx());
+    return true;
+  }
+
+  std::unique_ptr<Tins::PDU> pdu;
+  try {
+    pdu = parse(frame);
+  } catch (Tins::malformed_packet &err) {
+    return false;
+  }
+  encodePdu(writer, frame, pdu.get());
+  return true;
+}
+
+void Converter::encodePdu(Writer &writer, const Frame &frame, const Tins::PDU *pdu) {
+  writer.writeInt(pdu ? pdu->size() : 0);
+  writer.writeLong((int64_t) frame.ts.tv_sec * 1000 + frame.ts.tv_usec / 1000);
+  if (!pdu) {
+    writer.writeUnionIndex(PduFrame::Unsupported_index);
+    writer.writeBytes(NULL, 0); // Empty name.
+    _tag = frameTag(PduFrame::Unsupported_index);
+    return;
+  }
+  switch (pdu->pdu_type()) {
+  case Tins::PDU::PDUType::ETHERNET_II:
+    writer.writeUnionIndex(PduFrame::Ethernet2_index);
+    Layer2::encode(
+      writer,
+      static_cast<const Tins::EthernetII &>(*pdu),
+      frame,
+      _payloadSnap
+    );
+    _tag = frameTag(PduFrame::Ethernet2_index);
+    break;
+  case Tins::PDU::PDUType::RADIOTAP:
+    writer.writeUnionIndex(PduFrame::Radiotap_index);
+    _tag = frameTag(
+      PduFrame::Radiotap_index,
+      encodeRadiotap(writer, static_cast<const Tins::RadioTap &>(*pdu))
+    );
+    break;
+  default:
+    writer.writeUnionIndex(PduFrame::Unsupported_index);
+    encodeUnsupported(writer, *pdu);
+    _tag = frameTag(PduFrame::Unsupported_index);
+  }
+}
+
+size_t Converter::encodeRadiotap(Writer &writer, const Tins::RadioTap &src) {
+  Tins::RadioTap::PresentFlags present = src.present();
+
+  // Optional fields are `null` (branch 0) when absent.
+  if (present & Tins::RadioTap::PresentFlags::TSTF) {
+    writer.writeUnionIndex(1);
+    writer.writeLong(src.tsft());
+  } else {
+    writer.writeUnionIndex(0);
+  }
+
+  if (present & Tins::RadioTap::PresentFlags::FLAGS) {
+    writer.writeUnionIndex(1);
+    encodeRadiotapFlags(writer, src);
+  } else {
+    writer.writeUnionIndex(0);
   }
 
   if (present & Tins::RadioTap::PresentFlags::RATE) {
-    dst->rate.set_int(src.rate());
+    writer.writeUnionIndex(1);
+    writer.writeInt(src.rate());
+  } else {
+    writer.writeUnionIndex(0);
   }
 
   if (present & Tins::RadioTap::PresentFlags::CHANNEL) {
-    Layer2::radiotap_Channel channel;
-    channel.freq = src.channel_freq();
-    switch (src.channel_type()) {
-    case Tins::RadioTap::TURBO:
-      channel.type = Layer2::radiotap_ChannelType::TURBO;
-      break;
-    case Tins::RadioTap::CCK:
-      channel.type = Layer2::radiotap_ChannelType::CCK;
-      break;
-    case Tins::RadioTap::OFDM:
-      channel.type = Layer2::radiotap_ChannelType::OFDM;
-      break;
-    case Tins::RadioTap::TWO_GZ:
-      channel.type = Layer2::radiotap_ChannelType::TWO_GZ;
-      break;
-    case Tins::RadioTap::FIVE_GZ:
-      channel.type = Layer2::radiotap_ChannelType::FIVE_GZ;
-      break;
-    case Tins::RadioTap::PASSIVE:
-      channel.type = Layer2::radiotap_ChannelType::PASSIVE;
-      break;
-    case Tins::RadioTap::DYN_CCK_OFDM:
-      channel.type = Layer2::radiotap_ChannelType::DYN_CCK_OFDM;
-      break;
-    case Tins::RadioTap::GFSK:
-      channel.type = Layer2::radiotap_ChannelType::GFSK;
-      break;
-    }
-    dst->channel.set_radiotap_Channel(channel);
+    writer.writeUnionIndex(1);
+    encodeRadiotapChannel(writer, src);
+  } else {
+    writer.writeUnionIndex(0);
   }
 
   Tins::PDU *innerPdu = src.inner_pdu();
-  if (innerPdu) {
-    switch (innerPdu->pdu_type()) {
-    case Tins::PDU::PDUType::DOT11_ACK:
-      dst->frame.set_dot11_ctrl_Ack(*Layer2::convert(static_cast<const Tins::Dot11Ack &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_BLOCK_ACK:
-      dst->frame.set_dot11_ctrl_BlockAck(*Layer2::convert(static_cast<const Tins::Dot11BlockAck &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_BLOCK_ACK_REQ:
-      dst->frame.set_dot11_ctrl_BlockAckRequest(*Layer2::convert(static_cast<const Tins::Dot11BlockAckRequest &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_CF_END:
-      dst->frame.set_dot11_ctrl_CfEnd(*Layer2::convert(static_cast<const Tins::Dot11CFEnd &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_END_CF_ACK:
-      dst->frame.set_dot11_ctrl_EndCfAck(*Layer2::convert(static_cast<const Tins::Dot11EndCFAck &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_PS_POLL:
-      dst->frame.set_dot11_ctrl_PsPoll(*Layer2::convert(static_cast<const Tins::Dot11PSPoll &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_RTS:
-      dst->frame.set_dot11_ctrl_Rts(*Layer2::convert(static_cast<const Tins::Dot11RTS &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_DATA:
-      dst->frame.set_dot11_data_Data(*Layer2::convert(static_cast<const Tins::Dot11Data &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_QOS_DATA:
-      dst->frame.set_dot11_data_QosData(*Layer2::convert(static_cast<const Tins::Dot11QoSData &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_ASSOC_REQ:
-      dst->frame.set_dot11_mgmt_AssocRequest(*Layer2::convert(static_cast<const Tins::Dot11AssocRequest &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_ASSOC_RESP:
-      dst->frame.set_dot11_mgmt_AssocResponse(*Layer2::convert(static_cast<const Tins::Dot11AssocResponse &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_AUTH:
-      dst->frame.set_dot11_mgmt_Authentication(*Layer2::convert(static_cast<const Tins::Dot11Authentication &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_BEACON:
-      dst->frame.set_dot11_mgmt_Beacon(*Layer2::convert(static_cast<const Tins::Dot11Beacon &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_DEAUTH:
-      dst->frame.set_dot11_mgmt_Deauthentication(*Layer2::convert(static_cast<const Tins::Dot11Deauthentication &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_DIASSOC:
-      dst->frame.set_dot11_mgmt_Disassoc(*Layer2::convert(static_cast<const Tins::Dot11Disassoc &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_PROBE_REQ:
-      dst->frame.set_dot11_mgmt_ProbeRequest(*Layer2::convert(static_cast<const Tins::Dot11ProbeRequest &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_PROBE_RESP:
-      dst->frame.set_dot11_mgmt_ProbeResponse(*Layer2::convert(static_cast<const Tins::Dot11ProbeResponse &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_REASSOC_REQ:
-      dst->frame.set_dot11_mgmt_ReassocRequest(*Layer2::convert(static_cast<const Tins::Dot11ReAssocRequest &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11_REASSOC_RESP:
-      dst->frame.set_dot11_mgmt_ReassocResponse(*Layer2::convert(static_cast<const Tins::Dot11ReAssocResponse &>(*innerPdu)));
-      break;
-    case Tins::PDU::PDUType::DOT11:
-      dst->frame.set_dot11_Unsupported(*Layer2::convert(static_cast<const Tins::Dot11 &>(*innerPdu)));
-      break;
-    default:
-      dst->frame.set_Unsupported(*Layer2::convert(*innerPdu));
-      ; // This should never happen. Throw an exception here?
-    }
+  if (!innerPdu) {
+    writer.writeUnionIndex(RadiotapFrame::null_index);
+    return RadiotapFrame::null_index;
+  }
+  switch (innerPdu->pdu_type()) {
+  case Tins::PDU::PDUType::DOT11_ACK:
+    return encodeFrame<Tins::Dot11Ack>(writer, RadiotapFrame::dot11_ctrl_Ack_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_BLOCK_ACK:
+    return encodeFrame<Tins::Dot11BlockAck>(writer, RadiotapFrame::dot11_ctrl_BlockAck_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_BLOCK_ACK_REQ:
+    return encodeFrame<Tins::Dot11BlockAckRequest>(writer, RadiotapFrame::dot11_ctrl_BlockAckRequest_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_CF_END:
+    return encodeFrame<Tins::Dot11CFEnd>(writer, RadiotapFrame::dot11_ctrl_CfEnd_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_END_CF_ACK:
+    return encodeFrame<Tins::Dot11EndCFAck>(writer, RadiotapFrame::dot11_ctrl_EndCfAck_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_PS_POLL:
+    return encodeFrame<Tins::Dot11PSPoll>(writer, RadiotapFrame::dot11_ctrl_PsPoll_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_RTS:
+    return encodeFrame<Tins::Dot11RTS>(writer, RadiotapFrame::dot11_ctrl_Rts_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_DATA:
+    return encodeFrame<Tins::Dot11Data>(writer, RadiotapFrame::dot11_data_Data_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_QOS_DATA:
+    return encodeFrame<Tins::Dot11QoSData>(writer, RadiotapFrame::dot11_data_QosData_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_ASSOC_REQ:
+    return encodeFrame<Tins::Dot11AssocRequest>(writer, RadiotapFrame::dot11_mgmt_AssocRequest_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_ASSOC_RESP:
+    return encodeFrame<Tins::Dot11AssocResponse>(writer, RadiotapFrame::dot11_mgmt_AssocResponse_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_AUTH:
+    return encodeFrame<Tins::Dot11Authentication>(writer, RadiotapFrame::dot11_mgmt_Authentication_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_BEACON:
+    return encodeFrame<Tins::Dot11Beacon>(writer, RadiotapFrame::dot11_mgmt_Beacon_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_DEAUTH:
+    return encodeFrame<Tins::Dot11Deauthentication>(writer, RadiotapFrame::dot11_mgmt_Deauthentication_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_DIASSOC:
+    return encodeFrame<Tins::Dot11Disassoc>(writer, RadiotapFrame::dot11_mgmt_Disassoc_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_PROBE_REQ:
+    return encodeFrame<Tins::Dot11ProbeRequest>(writer, RadiotapFrame::dot11_mgmt_ProbeRequest_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_PROBE_RESP:
+    return encodeFrame<Tins::Dot11ProbeResponse>(writer, RadiotapFrame::dot11_mgmt_ProbeResponse_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_REASSOC_REQ:
+    return encodeFrame<Tins::Dot11ReAssocRequest>(writer, RadiotapFrame::dot11_mgmt_ReassocRequest_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11_REASSOC_RESP:
+    return encodeFrame<Tins::Dot11ReAssocResponse>(writer, RadiotapFrame::dot11_mgmt_ReassocResponse_index, *innerPdu);
+  case Tins::PDU::PDUType::DOT11:
+    return encodeFrame<Tins::Dot11>(writer, RadiotapFrame::dot11_Unsupported_index, *innerPdu);
+  default:
+    writer.writeUnionIndex(RadiotapFrame::Unsupported_index);
+    encodeUnsupported(writer, *innerPdu);
+    return RadiotapFrame::Unsupported_index;
   }
+}
 
-  return std::unique_ptr<Layer2::Radiotap>(dst);
+void Converter::encodeUnsupported(Writer &writer, const Tins::PDU &src) {
+  std::map<int, std::string>::iterator it = _names.find(src.pdu_type());
+  if (it == _names.end()) {
+    // Names are only computed once per type, since tins always allocates a new
+    // string for them.
+    it = _names.insert(std::make_pair(src.pdu_type(), std::string())).first;
+    it->second = Tins::Utils::to_string(src.pdu_type());
+    _numBufferGrowths++;
+  }
+  writer.writeString(it->second);
+}
+
+void Converter::track(size_t &capacity, size_t current) {
+  if (current > capacity) {
+    capacity = current;
+    _numBufferGrowths++;
+  }
 }
 
 }
@@ -1,49 +1,233 @@
 #pragma once
 
+#include "./dedup.hpp"
+#include "./frame.hpp"
 #include "./pdus.hpp"
-#include <avro/Encoder.hh>
+#include "./predicates.hpp"
+#include "./writer.hpp"
+#include <algorithm>
+#include <map>
+#include <string>
 #include <tins/tins.h>
+#include <vector>
 
 /**
- * Converters between tins PDU data structures and Avro records.
+ * Encoders from tins PDU data structures to Avro records.
  *
  */
 
 namespace Layer2 {
 
-std::unique_ptr<Layer2::Ethernet2> convert(const Tins::EthernetII &src);
-std::unique_ptr<Layer2::Radiotap> convert(const Tins::RadioTap &src);
-std::unique_ptr<Layer2::Unsupported> convert(const Tins::PDU &src);
+/**
+ * Build a tins PDU from a raw frame's bytes.
+ *
+ * Returns `NULL` if the frame's link type isn't supported, and throws
+ * `Tins::malformed_packet` if the frame can't be parsed.
+ *
+ */
+std::unique_ptr<Tins::PDU> parse(const Frame &frame);
+
+// Size of the header preceding each raw frame.
+#define LAYER2_RAW_HEADER_SIZE 20
+
+/**
+ * Write a raw frame, without decoding it.
+ *
+ * The frame's bytes are preceded by a fixed-size header holding (all
+ * little-endian) its timestamp in microseconds (8 bytes), then its captured
+ * length, its length on the wire, and its PCAP link type (4 bytes each).
+ *
+ */
+void encodeRaw(Writer &writer, const Frame &frame);
 
+/**
+ * Compact identifier of a PDU's innermost frame type, used to index batches.
+ *
+ * PDUs are tagged with their `Pdu` frame branch's index, plus for radiotap
+ * PDUs (the last branch) that of their own frame's branch. Each innermost
+ * frame type therefore gets its own tag (e.g. 2 for a radiotap PDU without an
+ * inner frame, 17 for a beacon).
+ *
+ */
+inline uint8_t frameTag(size_t pduIndex, size_t radiotapIndex = 0) {
+  return pduIndex + radiotapIndex;
 }
 
-namespace avro {
-
-template <>
-struct codec_traits<Tins::Packet> {
-
-  static void encode(Encoder &encoder, const Tins::Packet &src) {
-    Layer2::Pdu dst;
-    dst.timestamp = src.timestamp().seconds() * 1000 + src.timestamp().microseconds() / 1000;
-    const Tins::PDU *pdu = src.pdu();
-    if (pdu) {
-      dst.size = pdu->size();
-      switch (pdu->pdu_type()) {
-      case Tins::PDU::PDUType::ETHERNET_II:
-        dst.frame.set_Ethernet2(*Layer2::convert(static_cast<const Tins::EthernetII &>(*pdu)));
-        break;
-      case Tins::PDU::PDUType::RADIOTAP:
-        dst.frame.set_Radiotap(*Layer2::convert(static_cast<const Tins::RadioTap &>(*pdu)));
-        break;
-      default:
-        dst.frame.set_Unsupported(*Layer2::convert(*pdu));
-      }
-    } else {
-      dst.size = 0;
-    }
-    avro::encode(encoder, dst);
-  }
+// Bit set in the tags of frames flagged as duplicates (see `DedupMode`), all
+// frame types' tags are below it.
+#define LAYER2_DUPLICATE_TAG 0x80
+
+/**
+ * How frames are parsed before being encoded.
+ *
+ * Both produce the same PDUs, except in two cases for radiotap frames. The
+ * native parser doesn't reject truncated tagged parameters (see
+ * `parseRadiotap`). It also always sets PDUs' `size` to the frame's captured
+ * length, whereas tins sums the sizes of the layers it parsed, which is
+ * smaller when an inner layer (e.g. an unencrypted IP packet) declares a
+ * shorter length than what was captured.
+ *
+ */
+enum class Parser {
+  TINS, // Build tins PDUs.
+  NATIVE // Read radiotap frames directly (others still go through tins).
+};
+
+/**
+ * Encoder of raw frames as Avro `Pdu` records.
+ *
+ * Frames are parsed with tins by default, then fields are read from the tins
+ * PDUs and written straight to the output, in the schema's order, without
+ * going through the generated records (nor avro's encoder). Radiotap frames
+ * can instead be parsed natively, into a reusable record. Either way, the
+ * output is identical to encoding the equivalent `Pdu` record.
+ *
+ * Each wrapper should have its own instance, it isn't thread-safe.
+ *
+ */
+class Converter {
+public:
+  Converter();
+
+  void setParser(Parser parser) { _parser = parser; }
+
+  /**
+   * Maximum number of payload bytes written for ethernet frames (the rest is
+   * dropped, the PDU's size is unaffected). Unlimited by default.
+   *
+   * Payloads are always written as captured, checksums and lengths included,
+   * even if they are invalid.
+   *
+   */
+  void setPayloadSnap(uint32_t payloadSnap) { _payloadSnap = payloadSnap; }
+
+  uint32_t payloadSnap() const { return _payloadSnap; }
+
+  /**
+   * Only keep frames matching at least one of these predicates (all frames
+   * are kept when there are none).
+   *
+   * Radiotap frames are always parsed natively when predicates are set, to
+   * extract their fields. Those matching are then encoded from the parsed
+   * record with the native parser, and parsed again with tins otherwise.
+   *
+   */
+  void setPredicates(const std::vector<Predicate> &predicates);
+
+  /**
+   * How to handle retransmitted 802.11 frames (see `Deduplicator`). These are
+   * detected before anything else, in particular before predicates are
+   * evaluated: dropped duplicates never match any.
+   *
+   */
+  void setDedup(DedupMode dedup) { _dedup = dedup; }
+
+  /**
+   * Whether a frame matches the predicates, without encoding it. Malformed
+   * radiotap frames never match when there are predicates.
+   *
+   */
+  bool accept(const Frame &frame);
+
+  /**
+   * Extract a frame's fields, without encoding it. Returns `NULL` if the frame
+   * is malformed or doesn't match the predicates; the values returned are only
+   * valid until the next call.
+   *
+   */
+  const FieldValues *extract(const Frame &frame);
+
+  /**
+   * Parse and encode a frame, returning `false` if it is malformed or doesn't
+   * match the predicates (in which case nothing is written).
+   *
+   */
+  bool encode(Writer &writer, const Frame &frame);
+
+  /**
+   * Tag of the last frame encoded (see `frameTag`).
+   *
+   */
+  uint8_t tag() const { return _tag; }
+
+  /**
+   * Whether the last frame accepted (or extracted, or encoded) is a duplicate,
+   * when they are tagged.
+   *
+   */
+  bool duplicate() const { return _duplicate; }
+
+  /**
+   * Number of duplicates detected (whether dropped or tagged).
+   *
+   */
+  uint32_t numDuplicates() const { return _numDuplicates; }
+
+  /**
+   * Number of times the converter's reusable storage had to grow: arrays of
+   * natively parsed records outgrowing their largest capacity so far, and
+   * unsupported PDU names added to the cache. This doesn't account for the
+   * allocations tins makes while parsing.
+   *
+   */
+  uint32_t numBufferGrowths() const { return _numBufferGrowths; }
+
+  /**
+   * Number of frames each predicate matched since the last call to
+   * `clearMatches` (a frame can match several).
+   *
+   */
+  const std::vector<uint32_t> &numMatches() const { return _numMatches; }
+
+  void clearMatches() { std::fill(_numMatches.begin(), _numMatches.end(), 0); }
+
+private:
+  Parser _parser;
+  Layer2::Radiotap _radiotap; // Populated by the native parser.
+  std::map<int, std::string> _names; // Unsupported PDU names, by PDU type.
+  // Largest capacity seen for each of the record's arrays, to detect growths.
+  size_t _flagsCapacity;
+  std::vector<size_t> _capabilitiesCapacities; // By radiotap frame branch.
+  uint32_t _numBufferGrowths;
+  uint8_t _tag;
+  std::vector<Predicate> _predicates;
+  std::vector<uint32_t> _numMatches; // By predicate.
+  FieldValues _values; // Scratch space to evaluate predicates.
+  uint32_t _payloadSnap;
+  DedupMode _dedup;
+  Deduplicator _deduplicator;
+  bool _duplicate;
+  uint32_t _numDuplicates;
+
+  /**
+   * Whether a frame should be dropped as a duplicate, updating counters. This
+   * must be called exactly once per frame.
+   *
+   */
+  bool suppress(const Frame &frame);
+
+  /**
+   * Whether the last extracted values match any predicate, updating counters.
+   *
+   */
+  bool matches();
+
+  /**
+   * Encode a tins PDU parsed from a given frame (`pdu` may be `NULL` if the
+   * frame's link type isn't supported).
+   *
+   */
+  void encodePdu(Writer &writer, const Frame &frame, const Tins::PDU *pdu);
+
+  /**
+   * Returns the index of the radiotap frame's branch written.
+   *
+   */
+  size_t encodeRadiotap(Writer &writer, const Tins::RadioTap &src);
+
+  void encodeUnsupported(Writer &writer, const Tins::PDU &src);
 
+  void track(size_t &capacity, size_t current);
 };
 
 }
@@ -0,0 +1,269 @@
+#include "columns.hpp"
+#include <cmath>
+#include <string.h>
+
+namespace Layer2 {
+
+// Ethernet header size, the rest of the frame goes into the data pool.
+#define LAYER2_ETHERNET_HEADER_SIZE 14
+
+// Columns' Arrow schema, in layout order.
+static const std::vector<ArrowField> ARROW_FIELDS = {
+  {"timestamp", ArrowType::TIMESTAMP_US, false},
+  {"addr1", ArrowType::UINT64, true},
+  {"addr2", ArrowType::UINT64, true},
+  {"addr3", ArrowType::UINT64, true},
+  {"size", ArrowType::UINT32, false},
+  {"seqNum", ArrowType::INT32, true},
+  {"rate", ArrowType::INT32, true},
+  {"freq", ArrowType::INT32, true},
+  {"type", ArrowType::UINT8, false},
+  {"data", ArrowType::BINARY, false}
+};
+
+/**
+ * Value of a field, or a default if the frame doesn't have it.
+ *
+ */
+static int64_t getOr(const FieldValues &values, Field field, int64_t value) {
+  return values.has(field) ? values.get(field) : value;
+}
+
+static double getAddr(const FieldValues &values, Field field) {
+  return values.has(field) ? (double) values.get(field) : NAN;
+}
+
+/**
+ * Append the first `n` values of a column to `dst`, returning the position
+ * right after them.
+ *
+ */
+template <typename T>
+static uint8_t *copyColumn(uint8_t *dst, const std::vector<T> &column, size_t n) {
+  memcpy(dst, column.data(), n * sizeof(T));
+  return dst + n * sizeof(T);
+}
+
+/**
+ * Helper to lay out an Arrow record batch's body, column by column.
+ *
+ */
+class ArrowBody {
+public:
+  ArrowBody(
+    uint8_t *data,
+    int64_t length,
+    std::vector<ArrowNode> &nodes,
+    std::vector<ArrowBuffer> &buffers
+  ) :
+  _data(data),
+  _length(length),
+  _pos(0),
+  _nodes(nodes),
+  _buffers(buffers) {
+    _nodes.clear();
+    _buffers.clear();
+  }
+
+  /**
+   * Start a column, returning its validity bitmap (initially all null), or
+   * `NULL` if the column isn't nullable.
+   *
+   */
+  uint8_t *column(bool nullable) {
+    _nodes.push_back({_length, 0});
+    if (!nullable) {
+      buffer(0);
+      return NULL;
+    }
+    size_t len = (_length + 7) / 8;
+    uint8_t *validity = buffer(len);
+    memset(validity, 0, len);
+    return validity;
+  }
+
+  /**
+   * Mark a value of the current column as null, or valid.
+   *
+   */
+  void setValid(uint8_t *validity, size_t index, bool valid) {
+    if (valid) {
+      validity[index / 8] |= 1 << (index % 8);
+    } else {
+      _nodes.back().nullCount++;
+    }
+  }
+
+  /**
+   * Add one of the current column's buffers, padded.
+   *
+   */
+  uint8_t *buffer(size_t len) {
+    uint8_t *data = _data + _pos;
+    memset(data + len, 0, arrowPad(len) - len);
+    _buffers.push_back({(int64_t) _pos, (int64_t) len});
+    _pos += arrowPad(len);
+    return data;
+  }
+
+  size_t size() const { return _pos; }
+
+private:
+  uint8_t *_data;
+  int64_t _length;
+  size_t _pos;
+  std::vector<ArrowNode> &_nodes;
+  std::vector<ArrowBuffer> &_buffers;
+};
+
+/**
+ * Add a nullable column, `absent` values becoming nulls.
+ *
+ */
+template <typename T, typename U>
+static void addNullable(ArrowBody &body, const std::vector<U> &column, size_t n, U absent) {
+  uint8_t *validity = body.column(true);
+  T *values = (T *) body.buffer(n * sizeof(T));
+  for (size_t i = 0; i < n; i++) {
+    bool valid = !(column[i] == absent || column[i] != column[i]); // Or NaN.
+    values[i] = valid ? (T) column[i] : 0;
+    body.setValid(validity, i, valid);
+  }
+}
+
+template <typename T>
+static void eraseColumn(std::vector<T> &column, size_t n) {
+  column.erase(column.begin(), column.begin() + n);
+}
+
+void Columns::add(const Frame &frame, const FieldValues &values, size_t maxData) {
+  _timestamps.push_back((int64_t) frame.ts.tv_sec * 1000000 + frame.ts.tv_usec);
+  _addrs[0].push_back(getAddr(values, Field::ADDR1));
+  _addrs[1].push_back(getAddr(values, Field::ADDR2));
+  _addrs[2].push_back(getAddr(values, Field::ADDR3));
+  _sizes.push_back(frame.caplen);
+  _seqNums.push_back(getOr(values, Field::SEQ_NUM, -1));
+  _rates.push_back(getOr(values, Field::RATE, -1));
+  _freqs.push_back(getOr(values, Field::FREQ, -1));
+  _types.push_back(values.get(Field::TYPE));
+
+  if (values.has(Field::PAYLOAD_TYPE)) { // Only set for ethernet frames.
+    size_t len = frame.caplen - LAYER2_ETHERNET_HEADER_SIZE;
+    if (len > maxData) {
+      len = maxData;
+    }
+    const uint8_t *data = frame.data + LAYER2_ETHERNET_HEADER_SIZE;
+    _data.insert(_data.end(), data, data + len);
+  }
+  _dataEnds.push_back(_data.size());
+}
+
+Columns::Columns() : _format(Format::NATIVE) {
+  _dataEnds.push_back(0);
+  // Metadata only depends on the number of columns and buffers (one validity
+  // and one value buffer per column, plus one for binary data).
+  _nodes.resize(ARROW_FIELDS.size());
+  _buffers.resize(2 * ARROW_FIELDS.size() + 1);
+  writeArrowRecordBatch(_header, 0, _nodes, _buffers, 0);
+  _headerSize = _header.size();
+}
+
+void Columns::arrowSchema(std::vector<uint8_t> &dst) {
+  writeArrowSchema(dst, ARROW_FIELDS);
+}
+
+size_t Columns::flush(uint8_t *dst, size_t len, size_t &numBytes) {
+  size_t n = size();
+  while (n && byteSize(n) > len) {
+    n--;
+  }
+
+  numBytes = byteSize(n);
+  if (_format == Format::NATIVE) {
+    flushNative(dst, n);
+  } else {
+    flushArrow(dst, n);
+  }
+  erase(n);
+  return n;
+}
+
+size_t Columns::layoutSize(size_t n, size_t dataLen) const {
+  if (_format == Format::NATIVE) {
+    return LAYER2_COLUMNS_ROW_SIZE * n + sizeof(uint32_t) + dataLen;
+  }
+  size_t validity = arrowPad((n + 7) / 8);
+  return _headerSize +
+    arrowPad(8 * n) + // Timestamps.
+    3 * (validity + arrowPad(8 * n)) + // Addresses.
+    arrowPad(4 * n) + // Sizes.
+    3 * (validity + arrowPad(4 * n)) + // Sequence numbers, rates, frequencies.
+    arrowPad(n) + // Types.
+    arrowPad(4 * (n + 1)) + arrowPad(dataLen);
+}
+
+void Columns::flushNative(uint8_t *dst, size_t n) {
+  double *timestamps = (double *) dst;
+  for (size_t i = 0; i < n; i++) {
+    timestamps[i] = _timestamps[i] / 1e3;
+  }
+  dst += n * sizeof(double);
+  for (size_t i = 0; i < 3; i++) {
+    dst = copyColumn(dst, _addrs[i], n);
+  }
+  dst = copyColumn(dst, _sizes, n);
+  dst = copyColumn(dst, _seqNums, n);
+  dst = copyColumn(dst, _rates, n);
+  dst = copyColumn(dst, _freqs, n);
+  dst = copyColumn(dst, _dataEnds, n + 1);
+  dst = copyColumn(dst, _types, n);
+  memcpy(dst, _data.data(), _dataEnds[n]);
+}
+
+void Columns::flushArrow(uint8_t *dst, size_t n) {
+  ArrowBody body(dst + _headerSize, n, _nodes, _buffers);
+
+  body.column(false);
+  memcpy(body.buffer(n * sizeof(int64_t)), _timestamps.data(), n * sizeof(int64_t));
+  for (size_t i = 0; i < 3; i++) {
+    addNullable<uint64_t>(body, _addrs[i], n, (double) NAN);
+  }
+  body.column(false);
+  memcpy(body.buffer(n * sizeof(uint32_t)), _sizes.data(), n * sizeof(uint32_t));
+  addNullable<int32_t>(body, _seqNums, n, -1);
+  addNullable<int32_t>(body, _rates, n, -1);
+  addNullable<int32_t>(body, _freqs, n, -1);
+  body.column(false);
+  memcpy(body.buffer(n), _types.data(), n);
+  body.column(false);
+  size_t offsetsLen = (n + 1) * sizeof(uint32_t);
+  memcpy(body.buffer(offsetsLen), _dataEnds.data(), offsetsLen);
+  memcpy(body.buffer(_dataEnds[n]), _data.data(), _dataEnds[n]);
+
+  _header.clear();
+  writeArrowRecordBatch(_header, n, _nodes, _buffers, body.size());
+  memcpy(dst, _header.data(), _header.size());
+}
+
+void Columns::erase(size_t n) {
+  if (!n) {
+    return;
+  }
+  eraseColumn(_timestamps, n);
+  for (size_t i = 0; i < 3; i++) {
+    eraseColumn(_addrs[i], n);
+  }
+  eraseColumn(_sizes, n);
+  eraseColumn(_seqNums, n);
+  eraseColumn(_rates, n);
+  eraseColumn(_freqs, n);
+  eraseColumn(_types, n);
+  uint32_t dataLen = _dataEnds[n];
+  eraseColumn(_data, dataLen);
+  eraseColumn(_dataEnds, n);
+  for (size_t i = 0; i < _dataEnds.size(); i++) {
+    _dataEnds[i] -= dataLen; // Offsets are relative to the first row's.
+  }
+}
+
+}
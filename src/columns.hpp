@@ -0,0 +1,127 @@
+#pragma once
+
+#include "./arrow.hpp"
+#include "./frame.hpp"
+#include "./predicates.hpp"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Columnar (struct of arrays) batches, for consumers which would rather
+ * aggregate over typed arrays than walk decoded PDUs.
+ *
+ */
+
+namespace Layer2 {
+
+// Bytes taken by each row across all fixed-width columns (including its entry
+// in the data offsets column, which holds one more entry than there are rows).
+#define LAYER2_COLUMNS_ROW_SIZE 53
+
+/**
+ * Pending rows of frames' fields, laid out into a batch's buffer on demand.
+ *
+ * Rows are first accumulated column by column (in vectors reused across
+ * batches), since the final position of each column depends on how many rows
+ * end up in the batch. `flush` then writes as many rows as fit; any remaining
+ * rows are kept for the next batch. For `n` rows, the layout is (all values
+ * in native byte order, each column directly following the previous one):
+ *
+ *  + `Float64` timestamp (milliseconds, with microsecond precision).
+ *  + `Float64` addr1, addr2, addr3 (48-bit addresses, first byte most
+ *    significant, `NaN` when absent).
+ *  + `Uint32` size (captured length).
+ *  + `Int32` seqNum, rate, freq (-1 when absent).
+ *  + `Uint32` data offsets (`n + 1` entries, relative to the data pool).
+ *  + `Uint8` type (frame type tag, see `frameTag`).
+ *  + Data pool (ethernet frames' payload, empty for others).
+ *
+ * The layout must start at an 8-byte aligned address (so that the columns can
+ * be viewed as typed arrays without copying).
+ *
+ * Rows can instead be laid out as an Arrow IPC record batch message (see
+ * `arrowSchema` for the corresponding schema), with the same columns except
+ * that absent values are null, timestamps are in microseconds, addresses are
+ * unsigned 64-bit integers, and data is a binary column.
+ *
+ */
+class Columns {
+public:
+  enum class Format { NATIVE, ARROW };
+
+  Columns();
+
+  size_t size() const { return _types.size(); }
+
+  void setFormat(Format format) { _format = format; }
+
+  /**
+   * Append the Arrow IPC schema message matching record batches.
+   *
+   */
+  static void arrowSchema(std::vector<uint8_t> &dst);
+
+  /**
+   * Add a frame's row, truncating its data to at most `maxData` bytes.
+   *
+   */
+  void add(const Frame &frame, const FieldValues &values, size_t maxData);
+
+  /**
+   * Bytes needed to lay out the first `n` pending rows.
+   *
+   */
+  size_t byteSize(size_t n) const { return layoutSize(n, _dataEnds[n]); }
+
+  /**
+   * Bytes needed to lay out a single row without data.
+   *
+   */
+  size_t minSize() const { return layoutSize(1, 0); }
+
+  /**
+   * Largest amount of data a single row can hold to fit in `len` bytes (at
+   * least `minSize`).
+   *
+   */
+  size_t maxData(size_t len) const { return (len - minSize()) & ~((size_t) 7); }
+
+  /**
+   * Lay out as many pending rows as fit in `len` bytes at `dst` (which must be
+   * 8-byte aligned), returning the number of rows written. The number of bytes
+   * used is stored in `numBytes`.
+   *
+   */
+  size_t flush(uint8_t *dst, size_t len, size_t &numBytes);
+
+private:
+  std::vector<int64_t> _timestamps; // Microseconds, as in Arrow batches.
+  std::vector<double> _addrs[3];
+  std::vector<uint32_t> _sizes;
+  std::vector<int32_t> _seqNums;
+  std::vector<int32_t> _rates;
+  std::vector<int32_t> _freqs;
+  std::vector<uint32_t> _dataEnds; // Cumulative data size, after each row.
+  std::vector<uint8_t> _types;
+  std::vector<uint8_t> _data;
+  Format _format;
+  // Scratch space for Arrow record batches' metadata.
+  std::vector<uint8_t> _header;
+  size_t _headerSize; // Constant, since the number of buffers is.
+  std::vector<ArrowNode> _nodes;
+  std::vector<ArrowBuffer> _buffers;
+
+  size_t layoutSize(size_t n, size_t dataLen) const;
+
+  void flushNative(uint8_t *dst, size_t n);
+
+  void flushArrow(uint8_t *dst, size_t n);
+
+  /**
+   * Drop the first `n` rows, once flushed.
+   *
+   */
+  void erase(size_t n);
+};
+
+}
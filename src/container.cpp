@@ -0,0 +1,198 @@
+#include "container.hpp"
+#include "writer.hpp"
+#include <random>
+#include <stdexcept>
+#include <string.h>
+
+namespace Layer2 {
+
+// Bytes starting each object container file.
+static const uint8_t MAGIC[] = {'O', 'b', 'j', 1};
+
+/**
+ * Insert a file's sequence number before its path's extension.
+ *
+ */
+static std::string getRotatedPath(const std::string &path, size_t index) {
+  size_t slash = path.rfind('/');
+  size_t dot = path.rfind('.');
+  if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+    dot = path.size(); // No extension.
+  }
+  return path.substr(0, dot) + "." + std::to_string(index) + path.substr(dot);
+}
+
+ContainerWriter::ContainerWriter(const ContainerConfiguration &config) :
+_config(config),
+_closing(false),
+_numFiles(0) {
+  memset(&_deflater, 0, sizeof(_deflater));
+  if (
+    _config.codec == Codec::DEFLATE &&
+    deflateInit2(&_deflater, _config.level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK
+  ) {
+    throw std::runtime_error("invalid compression level");
+  }
+  try {
+    open(); // Synchronously, to surface any error right away.
+  } catch (std::runtime_error &err) {
+    if (_config.codec == Codec::DEFLATE) {
+      deflateEnd(&_deflater);
+    }
+    throw;
+  }
+  _thread = std::thread(&ContainerWriter::run, this);
+}
+
+ContainerWriter::~ContainerWriter() {
+  try {
+    close();
+  } catch (std::runtime_error &err) {
+    // Already reported, if `close` was called explicitly.
+  }
+  if (_config.codec == Codec::DEFLATE) {
+    deflateEnd(&_deflater);
+  }
+}
+
+void ContainerWriter::append(const uint8_t *data, size_t len, size_t count) {
+  Block block;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_error.empty()) {
+      throw std::runtime_error(_error);
+    }
+    if (_closing) {
+      throw std::runtime_error("archive closed");
+    }
+    if (!_free.empty()) {
+      block = std::move(_free.back());
+      _free.pop_back();
+    }
+  }
+  // Copied outside of the lock, to not hold up the background thread.
+  block.data.assign(data, data + len);
+  block.count = count;
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _pending.push_back(std::move(block));
+  }
+  _cond.notify_one();
+}
+
+void ContainerWriter::close() {
+  {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _closing = true;
+  }
+  _cond.notify_one();
+  if (_thread.joinable()) {
+    _thread.join();
+  }
+  if (!_error.empty()) {
+    throw std::runtime_error(_error);
+  }
+}
+
+void ContainerWriter::run() {
+  std::unique_lock<std::mutex> lock(_mutex);
+  while (true) {
+    _cond.wait(lock, [this] { return _closing || !_pending.empty(); });
+    if (_pending.empty()) {
+      break; // Closing, and all blocks were written.
+    }
+    Block block = std::move(_pending.front());
+    _pending.pop_front();
+    lock.unlock();
+
+    std::string error;
+    try {
+      if (shouldRotate()) {
+        open();
+      }
+      write(block);
+    } catch (std::runtime_error &err) {
+      error = err.what();
+    }
+
+    lock.lock();
+    _free.push_back(std::move(block));
+    if (!error.empty()) {
+      _error = error;
+      _pending.clear();
+      break;
+    }
+  }
+  lock.unlock();
+
+  try {
+    _file->flush();
+  } catch (std::runtime_error &err) {
+    std::lock_guard<std::mutex> lock(_mutex); // Read from the main thread.
+    if (_error.empty()) {
+      _error = err.what();
+    }
+  }
+  _file.reset();
+}
+
+void ContainerWriter::open() {
+  if (_file) {
+    _file->flush();
+  }
+  std::string path = _config.path;
+  if (_config.maxSize || _config.maxAge) {
+    path = getRotatedPath(path, _numFiles);
+  }
+  // Works whether avro returns an `auto_ptr` (older versions) or not.
+  _file.reset(avro::fileOutputStream(path.c_str()).release());
+  _numFiles++;
+  _openedAt = std::chrono::steady_clock::now();
+
+  std::random_device random;
+  for (size_t i = 0; i < LAYER2_SYNC_SIZE; i++) {
+    _sync[i] = random();
+  }
+
+  Writer writer(*_file);
+  writer.writeFixed<sizeof(MAGIC)>(MAGIC);
+  writer.writeLong(2); // Metadata map, in a single block.
+  writer.writeString("avro.schema");
+  writer.writeString(_config.schema);
+  writer.writeString("avro.codec");
+  writer.writeString(_config.codec == Codec::DEFLATE ? "deflate" : "null");
+  writer.writeLong(0);
+  writer.writeFixed<LAYER2_SYNC_SIZE>(_sync);
+}
+
+bool ContainerWriter::shouldRotate() const {
+  if (_config.maxSize && _file->byteCount() >= _config.maxSize) {
+    return true;
+  }
+  return _config.maxAge && (
+    std::chrono::steady_clock::now() - _openedAt >=
+    std::chrono::milliseconds(_config.maxAge)
+  );
+}
+
+void ContainerWriter::write(const Block &block) {
+  Writer writer(*_file);
+  writer.writeLong(block.count);
+  if (_config.codec == Codec::NONE) {
+    writer.writeBytes(block.data.data(), block.data.size());
+  } else {
+    deflateReset(&_deflater);
+    _compressed.resize(deflateBound(&_deflater, block.data.size()));
+    _deflater.next_in = (Bytef *) block.data.data();
+    _deflater.avail_in = block.data.size();
+    _deflater.next_out = _compressed.data();
+    _deflater.avail_out = _compressed.size();
+    if (deflate(&_deflater, Z_FINISH) != Z_STREAM_END) {
+      throw std::runtime_error("compression failed");
+    }
+    writer.writeBytes(_compressed.data(), _deflater.total_out);
+  }
+  writer.writeFixed<LAYER2_SYNC_SIZE>(_sync);
+}
+
+}
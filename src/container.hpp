@@ -0,0 +1,125 @@
+#pragma once
+
+#include <avro/Stream.hh>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+/**
+ * Avro object container files, to archive encoded PDUs without decoding them.
+ *
+ */
+
+namespace Layer2 {
+
+// Size of the marker following each block (and the header).
+#define LAYER2_SYNC_SIZE 16
+
+/**
+ * Block compression codec.
+ *
+ */
+enum class Codec {
+  NONE, // Avro's `null` codec.
+  DEFLATE // Raw deflate (RFC 1951), via zlib.
+};
+
+struct ContainerConfiguration {
+  std::string path; // See `ContainerWriter` for how rotated files are named.
+  std::string schema; // Writer schema, as JSON.
+  Codec codec;
+  int level; // Compression level, for deflate.
+  uint64_t maxSize; // Bytes after which to rotate files (0 to never).
+  uint32_t maxAge; // Milliseconds after which to rotate files (0 to never).
+
+  ContainerConfiguration() :
+  codec(Codec::NONE),
+  level(Z_DEFAULT_COMPRESSION),
+  maxSize(0),
+  maxAge(0) {}
+};
+
+/**
+ * Writer of Avro object container files.
+ *
+ * Each call to `append` adds a block of already encoded records (typically a
+ * batch of PDUs). Blocks are copied then compressed and written from a
+ * background thread, so that appending is cheap for the calling thread.
+ *
+ * Files are rotated once they exceed `maxSize` bytes or are older than
+ * `maxAge` (checked before writing each block, so a file may slightly exceed
+ * either). When either limit is set, file names get a sequence number before
+ * their extension (e.g. `pdus.avro` becomes `pdus.0.avro`, `pdus.1.avro`,
+ * ...), otherwise `path` is used as is.
+ *
+ * Errors from the background thread (e.g. a full disk) stop all further
+ * writes and are thrown by the next call to `append` or `close`.
+ *
+ */
+class ContainerWriter {
+public:
+  /**
+   * Open the first file, throwing `std::runtime_error` if it can't be.
+   *
+   */
+  explicit ContainerWriter(const ContainerConfiguration &config);
+
+  ~ContainerWriter();
+
+  /**
+   * Queue a block of `count` records (`len` encoded bytes).
+   *
+   */
+  void append(const uint8_t *data, size_t len, size_t count);
+
+  /**
+   * Write all pending blocks, then close the current file. No blocks can be
+   * appended afterwards.
+   *
+   */
+  void close();
+
+private:
+  struct Block {
+    std::vector<uint8_t> data;
+    size_t count;
+  };
+
+  ContainerConfiguration _config;
+  std::mutex _mutex;
+  std::condition_variable _cond;
+  std::deque<Block> _pending; // Blocks waiting to be written.
+  std::vector<Block> _free; // Written blocks, reused to avoid allocations.
+  bool _closing;
+  std::string _error;
+  std::thread _thread;
+
+  // Only accessed from the background thread (once started).
+  std::unique_ptr<avro::OutputStream> _file;
+  size_t _numFiles;
+  std::chrono::steady_clock::time_point _openedAt;
+  uint8_t _sync[LAYER2_SYNC_SIZE];
+  z_stream _deflater;
+  std::vector<uint8_t> _compressed;
+
+  void run();
+
+  /**
+   * Close the current file (if any), and open the next one.
+   *
+   */
+  void open();
+
+  bool shouldRotate() const;
+
+  void write(const Block &block);
+};
+
+}
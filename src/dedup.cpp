@@ -0,0 +1,56 @@
+#include "dedup.hpp"
+#include <pcap/pcap.h>
+
+namespace Layer2 {
+
+// Number of transmitters cached, must be a power of two.
+#define LAYER2_DEDUP_CAPACITY 4096
+
+// Offset of the sequence control field in management and data headers.
+#define LAYER2_SEQ_CONTROL_OFFSET 22
+
+Deduplicator::Deduplicator() : _entries(LAYER2_DEDUP_CAPACITY, Entry()) {}
+
+bool Deduplicator::check(const Frame &frame) {
+  size_t offset; // Of the 802.11 header.
+  switch (frame.linkType) {
+  case DLT_IEEE802_11:
+    offset = 0;
+    break;
+  case DLT_IEEE802_11_RADIO:
+    if (frame.caplen < 4) {
+      return false;
+    }
+    offset = frame.data[2] | (frame.data[3] << 8);
+    break;
+  default:
+    return false;
+  }
+  if (frame.caplen < offset + LAYER2_SEQ_CONTROL_OFFSET + 2) {
+    return false;
+  }
+  const uint8_t *header = frame.data + offset;
+  uint8_t type = (header[0] >> 2) & 3;
+  if (type != 0 && type != 2) {
+    return false; // Only management and data frames have a sequence number.
+  }
+
+  uint64_t addr = 0;
+  for (size_t i = 0; i < 6; i++) {
+    addr = (addr << 8) | header[10 + i];
+  }
+  uint16_t seqControl = header[LAYER2_SEQ_CONTROL_OFFSET] |
+    (header[LAYER2_SEQ_CONTROL_OFFSET + 1] << 8);
+  bool retry = header[1] & 0x08;
+
+  // Addresses are mostly unique in their lower bytes, a multiplicative hash
+  // is enough to spread them.
+  addr |= (uint64_t) 1 << 48; // So that no used entry has a null address.
+  Entry &entry = _entries[((addr * 0x9e3779b97f4a7c15ULL) >> 32) & (_entries.size() - 1)];
+  bool duplicate = retry && entry.addr == addr && entry.seqControl == seqControl;
+  entry.addr = addr;
+  entry.seqControl = seqControl;
+  return duplicate;
+}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "./frame.hpp"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Detection of retransmitted 802.11 frames.
+ *
+ */
+
+namespace Layer2 {
+
+/**
+ * What to do with duplicate frames.
+ *
+ */
+enum class DedupMode {
+  NONE, // Don't look for duplicates.
+  DROP, // Discard them.
+  TAG // Keep them, flagged (see `LAYER2_DUPLICATE_TAG`).
+};
+
+/**
+ * Cache of the latest sequence control field sent by each transmitter.
+ *
+ * A management or data frame is a duplicate if its retry flag is set and its
+ * transmitter's (`addr2`) previous frame had the same sequence and fragment
+ * numbers, i.e. it is a retransmission of a frame that was already captured.
+ * Only the frames' raw bytes are read, so this is cheap enough to run before
+ * any parsing.
+ *
+ * The cache is direct-mapped on a hash of the transmitter's address: it never
+ * allocates after construction, but a transmitter's entry can be evicted by
+ * another's (in which case its next retransmission isn't detected). Sequence
+ * numbers are also tracked per transmitter rather than per traffic identifier,
+ * so retransmissions interleaved across QoS queues can be missed.
+ *
+ */
+class Deduplicator {
+public:
+  Deduplicator();
+
+  /**
+   * Whether a frame is a duplicate, updating the cache.
+   *
+   */
+  bool check(const Frame &frame);
+
+private:
+  struct Entry {
+    uint64_t addr; // Transmitter address, 0 for unused entries.
+    uint16_t seqControl;
+  };
+
+  std::vector<Entry> _entries; // Capacity is a power of two.
+};
+
+}
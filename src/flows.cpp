@@ -0,0 +1,157 @@
+#include "flows.hpp"
+#include <pcap/pcap.h>
+#include <string.h>
+
+namespace Layer2 {
+
+#define LAYER2_ETHERTYPE_IPV4 0x0800
+#define LAYER2_ETHERTYPE_IPV6 0x86dd
+
+// Initial number of slots, must be a power of two.
+#define LAYER2_FLOWS_CAPACITY 1024
+
+// Capture time between two sweeps, in microseconds.
+#define LAYER2_FLOWS_SWEEP_INTERVAL 1000000
+
+static uint16_t readShort(const uint8_t *data) {
+  return (data[0] << 8) | data[1];
+}
+
+/**
+ * Whether an IP protocol's header starts with source and destination ports.
+ *
+ */
+static bool hasPorts(uint8_t protocol) {
+  return protocol == 6 || protocol == 17 || protocol == 132; // TCP, UDP, SCTP.
+}
+
+/**
+ * Fill in a frame's key, returning `false` if it isn't an Ethernet II frame.
+ *
+ * Frames with truncated (or unsupported, e.g. with IPv6 extension headers) IP
+ * headers are aggregated on as much of the key as could be read.
+ *
+ */
+static bool readKey(const Frame &frame, FlowKey &key) {
+  if (frame.linkType != DLT_EN10MB || frame.caplen < 14) {
+    return false;
+  }
+  memset(&key, 0, sizeof(key));
+  memcpy(key.dstAddr, frame.data, 6);
+  memcpy(key.srcAddr, frame.data + 6, 6);
+  key.payloadType = readShort(frame.data + 12);
+
+  const uint8_t *ip = frame.data + 14;
+  size_t len = frame.caplen - 14;
+  size_t headerSize;
+  bool fragment = false;
+  if (
+    key.payloadType == LAYER2_ETHERTYPE_IPV4 &&
+    len >= 20 &&
+    (ip[0] >> 4) == 4 &&
+    (ip[0] & 0xf) >= 5
+  ) {
+    key.ipVersion = 4;
+    key.protocol = ip[9];
+    memcpy(key.srcIp, ip + 12, 4);
+    memcpy(key.dstIp, ip + 16, 4);
+    headerSize = (ip[0] & 0xf) * 4;
+    fragment = readShort(ip + 6) & 0x1fff; // Only the first has ports.
+  } else if (
+    key.payloadType == LAYER2_ETHERTYPE_IPV6 &&
+    len >= 40 &&
+    (ip[0] >> 4) == 6
+  ) {
+    key.ipVersion = 6;
+    key.protocol = ip[6];
+    memcpy(key.srcIp, ip + 8, 16);
+    memcpy(key.dstIp, ip + 24, 16);
+    headerSize = 40;
+  } else {
+    return true;
+  }
+  if (!fragment && hasPorts(key.protocol) && len >= headerSize + 4) {
+    key.srcPort = readShort(ip + headerSize);
+    key.dstPort = readShort(ip + headerSize + 2);
+  }
+  return true;
+}
+
+void encodeFlow(Writer &writer, const Flow &flow) {
+  const FlowKey &key = flow.key;
+  writer.writeFixed<6>(key.srcAddr);
+  writer.writeFixed<6>(key.dstAddr);
+  writer.writeInt(key.payloadType);
+  if (key.ipVersion) {
+    size_t ipSize = key.ipVersion == 4 ? 4 : 16;
+    writer.writeUnionIndex(1);
+    writer.writeBytes(key.srcIp, ipSize);
+    writer.writeBytes(key.dstIp, ipSize);
+    writer.writeInt(key.protocol);
+    writer.writeInt(key.srcPort);
+    writer.writeInt(key.dstPort);
+  } else {
+    writer.writeUnionIndex(0);
+  }
+  const FlowCounters &counters = flow.counters;
+  writer.writeLong(counters.first / 1000);
+  writer.writeLong(counters.last / 1000);
+  writer.writeLong(counters.numPackets);
+  writer.writeLong(counters.numOctets);
+}
+
+FlowTable::FlowTable() :
+_flows(LAYER2_FLOWS_CAPACITY),
+_idleTimeout(15000000),
+_activeTimeout(60000000),
+_clock(0),
+_nextSweep(0) {}
+
+bool FlowTable::add(const Frame &frame) {
+  FlowKey key;
+  if (!readKey(frame, key)) {
+    return false;
+  }
+  int64_t ts = (int64_t) frame.ts.tv_sec * 1000000 + frame.ts.tv_usec;
+  if (ts > _clock) {
+    _clock = ts;
+  }
+  if (_clock >= _nextSweep) {
+    sweep(_clock);
+  }
+
+  bool inserted;
+  FlowCounters &counters = _flows.get(key, inserted);
+  if (inserted) {
+    counters.first = ts;
+    counters.last = ts;
+  } else if (ts > counters.last) {
+    counters.last = ts;
+  }
+  counters.numPackets++;
+  counters.numOctets += frame.len;
+  return true;
+}
+
+void FlowTable::sweep(int64_t now) {
+  if (now > _clock) {
+    _clock = now;
+  }
+  _nextSweep = _clock + LAYER2_FLOWS_SWEEP_INTERVAL;
+  _flows.removeIf([this](const FlowKey &key, const FlowCounters &counters) {
+    if (!isExpired(counters)) {
+      return false;
+    }
+    _expired.push_back({key, counters});
+    return true;
+  });
+}
+
+bool FlowTable::isExpired(const FlowCounters &counters) const {
+  return (
+    _clock - counters.last >= _idleTimeout ||
+    (_activeTimeout && _clock - counters.first >= _activeTimeout)
+  );
+}
+
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include "./frame.hpp"
+#include "./table.hpp"
+#include "./writer.hpp"
+#include <deque>
+#include <stdint.h>
+
+/**
+ * Aggregation of Ethernet II traffic into flows, natively.
+ *
+ */
+
+namespace Layer2 {
+
+// Upper bound on the size of an encoded flow record.
+#define LAYER2_MAX_FLOW_SIZE 128
+
+/**
+ * What frames are aggregated on.
+ *
+ * Keys are compared bytewise, so they must be zeroed before being filled in
+ * (unused IP fields included).
+ *
+ */
+struct FlowKey {
+  uint8_t srcAddr[6];
+  uint8_t dstAddr[6];
+  uint16_t payloadType;
+  uint8_t ipVersion; // 0 if the frame doesn't carry an IP packet, 4 or 6.
+  uint8_t protocol;
+  uint16_t srcPort;
+  uint16_t dstPort;
+  uint8_t srcIp[16]; // Only the first 4 bytes are used for IPv4.
+  uint8_t dstIp[16];
+};
+
+struct FlowCounters {
+  int64_t first; // Timestamps, in microseconds.
+  int64_t last;
+  uint64_t numPackets;
+  uint64_t numOctets;
+};
+
+struct Flow {
+  FlowKey key;
+  FlowCounters counters;
+};
+
+/**
+ * Write a flow as a `Flow` record (see `etc/idls/Flow.avdl`).
+ *
+ */
+void encodeFlow(Writer &writer, const Flow &flow);
+
+/**
+ * Table of active flows.
+ *
+ * Time is driven by the frames' timestamps, so that captures are aggregated
+ * the same way whether they are live or read from a file.
+ *
+ * A flow expires once no frames were added to it for `idleTimeout`, or once it
+ * started more than `activeTimeout` ago (so that long-lived flows are still
+ * reported periodically). Expired flows are removed from the table and queued
+ * until they are consumed from `expired`. The table is swept for expired flows
+ * at most once per second of capture time.
+ *
+ */
+class FlowTable {
+public:
+  FlowTable();
+
+  /**
+   * Timeouts, in milliseconds. An active timeout of 0 disables it.
+   *
+   */
+  void setIdleTimeout(uint32_t timeout) { _idleTimeout = (int64_t) timeout * 1000; }
+
+  void setActiveTimeout(uint32_t timeout) { _activeTimeout = (int64_t) timeout * 1000; }
+
+  /**
+   * Count a frame towards its flow, returning `false` if it isn't an Ethernet
+   * II frame (in which case it is ignored).
+   *
+   */
+  bool add(const Frame &frame);
+
+  /**
+   * Expire flows as of time `now` (in microseconds, it is ignored if earlier
+   * than the latest frame's timestamp).
+   *
+   */
+  void sweep(int64_t now);
+
+  size_t size() const { return _flows.size(); }
+
+  std::deque<Flow> &expired() { return _expired; }
+
+private:
+  Table<FlowKey, FlowCounters> _flows;
+  std::deque<Flow> _expired;
+  int64_t _idleTimeout; // Microseconds.
+  int64_t _activeTimeout;
+  int64_t _clock; // Latest timestamp seen.
+  int64_t _nextSweep;
+
+  bool isExpired(const FlowCounters &counters) const;
+};
+
+}
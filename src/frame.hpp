@@ -0,0 +1,24 @@
+#pragma once
+
+#include <stdint.h>
+#include <sys/time.h>
+
+namespace Layer2 {
+
+/**
+ * Raw captured frame.
+ *
+ * The data isn't owned by the frame, it typically points directly inside the
+ * capture backend's memory and is only valid until the backend moves on to the
+ * next frame.
+ *
+ */
+struct Frame {
+  const uint8_t *data;
+  uint32_t caplen; // Number of bytes available at `data`.
+  uint32_t len; // Length of the frame on the wire.
+  struct timeval ts;
+  int linkType; // PCAP `DLT_*` value.
+};
+
+}
@@ -1,3 +1,4 @@
+#include "archive.hpp"
 #include "utils.hpp"
 #include "wrapper.hpp"
 
@@ -11,6 +12,12 @@ void Init(v8::Handle<v8::Object> exports) {
     Nan::GetFunction(Wrapper::Init()).ToLocalChecked()
   );
 
+  Nan::Set(
+    exports,
+    Nan::New<v8::String>("Archive").ToLocalChecked(),
+    Nan::GetFunction(Archive::Init()).ToLocalChecked()
+  );
+
   Nan::Set(
     exports,
     Nan::New<v8::String>("stringifyAddress").ToLocalChecked(),
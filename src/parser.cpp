@@ -0,0 +1,455 @@
+#include "parser.hpp"
+#include <string.h>
+
+namespace Layer2 {
+
+// 802.11 frame types and subtypes (from the frame control field).
+
+#define LAYER2_DOT11_MGMT 0
+#define LAYER2_DOT11_CTRL 1
+#define LAYER2_DOT11_DATA 2
+
+#define LAYER2_DOT11_ASSOC_REQ 0
+#define LAYER2_DOT11_ASSOC_RESP 1
+#define LAYER2_DOT11_REASSOC_REQ 2
+#define LAYER2_DOT11_REASSOC_RESP 3
+#define LAYER2_DOT11_PROBE_REQ 4
+#define LAYER2_DOT11_PROBE_RESP 5
+#define LAYER2_DOT11_BEACON 8
+#define LAYER2_DOT11_DISASSOC 10
+#define LAYER2_DOT11_AUTH 11
+#define LAYER2_DOT11_DEAUTH 12
+
+#define LAYER2_DOT11_BLOCK_ACK_REQ 8
+#define LAYER2_DOT11_BLOCK_ACK 9
+#define LAYER2_DOT11_PS_POLL 10
+#define LAYER2_DOT11_RTS 11
+#define LAYER2_DOT11_ACK 13
+#define LAYER2_DOT11_CF_END 14
+#define LAYER2_DOT11_END_CF_ACK 15
+
+// Header sizes (common part, then up to the transmitter address).
+#define LAYER2_DOT11_HEADER_SIZE 10
+#define LAYER2_DOT11_CTRL_TA_SIZE 16
+
+/**
+ * Cursor over a frame's bytes, all values are little-endian.
+ *
+ * Reads past the end don't fail immediately, they are only reported via `ok`
+ * once the whole header has been read (truncated frames are rare).
+ *
+ */
+class Cursor {
+public:
+  Cursor(const uint8_t *data, uint32_t len) :
+  _data(data),
+  _len(len),
+  _pos(0) {}
+
+  bool ok() const { return _pos <= _len; }
+
+  void skip(uint32_t n) { _pos += n; }
+
+  void align(uint32_t n) { _pos = (_pos + n - 1) & ~(n - 1); }
+
+  uint8_t readUint8() {
+    uint8_t n = _pos < _len ? _data[_pos] : 0;
+    _pos++;
+    return n;
+  }
+
+  uint16_t readUint16() {
+    uint16_t n = readUint8();
+    return n | (uint16_t) readUint8() << 8;
+  }
+
+  uint32_t readUint32() {
+    uint32_t n = readUint16();
+    return n | (uint32_t) readUint16() << 16;
+  }
+
+  uint64_t readUint64() {
+    uint64_t n = readUint32();
+    return n | (uint64_t) readUint32() << 32;
+  }
+
+  void readAddr(boost::array<uint8_t, 6> &addr) {
+    if (_pos + 6 <= _len) {
+      memcpy(addr.data(), _data + _pos, 6);
+    }
+    _pos += 6;
+  }
+
+private:
+  const uint8_t *_data;
+  uint32_t _len;
+  uint32_t _pos;
+};
+
+// 802.11.
+
+static void parseDot11Header(Cursor &cursor, Layer2::dot11_Header &dst) {
+  cursor.skip(1); // Protocol version, type, and subtype.
+  uint8_t flags = cursor.readUint8();
+  dst.toDs = flags & 0x01;
+  dst.fromDs = flags & 0x02;
+  dst.moreFrag = flags & 0x04;
+  dst.retry = flags & 0x08;
+  dst.powerMgmt = flags & 0x10;
+  dst.wep = flags & 0x40;
+  dst.order = flags & 0x80;
+  dst.durationId = cursor.readUint16();
+  cursor.readAddr(dst.addr1);
+}
+
+/**
+ * Parse the addresses and sequence control common to data and management
+ * frames (both records have the same fields).
+ *
+ */
+template <typename H>
+static void parseDot11ExtHeader(Cursor &cursor, const Layer2::dot11_Header &header, H &dst) {
+  cursor.readAddr(dst.addr2);
+  cursor.readAddr(dst.addr3);
+  uint16_t seqControl = cursor.readUint16();
+  dst.fragNum = seqControl & 0xf;
+  dst.seqNum = seqControl >> 4;
+  if (header.toDs && header.fromDs) {
+    cursor.readAddr(dst.addr4);
+  } else {
+    dst.addr4.fill(0);
+  }
+}
+
+static void parseDot11Capabilities(
+  Cursor &cursor,
+  std::vector<Layer2::dot11_mgmt_Capability> &dst
+) {
+  dst.clear();
+  uint16_t bits = cursor.readUint16();
+  // Capabilities are declared in the same order as their bits.
+  for (int i = 0; i < 16; i++) {
+    if (bits & (1 << i)) {
+      dst.push_back((Layer2::dot11_mgmt_Capability) i);
+    }
+  }
+}
+
+static void parseDot11Mgmt(Cursor &cursor, uint8_t subtype, Layer2::Radiotap::frame_t &dst) {
+  Layer2::dot11_Header header;
+  parseDot11Header(cursor, header);
+  switch (subtype) {
+  case LAYER2_DOT11_ASSOC_REQ:
+    {
+      Layer2::dot11_mgmt_AssocRequest &frame = dst.emplace_dot11_mgmt_AssocRequest();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      parseDot11Capabilities(cursor, frame.capabilities);
+      frame.listenInterval = cursor.readUint16();
+    }
+    break;
+  case LAYER2_DOT11_ASSOC_RESP:
+    {
+      Layer2::dot11_mgmt_AssocResponse &frame = dst.emplace_dot11_mgmt_AssocResponse();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      parseDot11Capabilities(cursor, frame.capabilities);
+      frame.statusCode = cursor.readUint16();
+      frame.aid = cursor.readUint16();
+    }
+    break;
+  case LAYER2_DOT11_REASSOC_REQ:
+    {
+      Layer2::dot11_mgmt_ReassocRequest &frame = dst.emplace_dot11_mgmt_ReassocRequest();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      parseDot11Capabilities(cursor, frame.capabilities);
+      frame.listenInterval = cursor.readUint16();
+      cursor.readAddr(frame.currentAp);
+    }
+    break;
+  case LAYER2_DOT11_REASSOC_RESP:
+    {
+      Layer2::dot11_mgmt_ReassocResponse &frame = dst.emplace_dot11_mgmt_ReassocResponse();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      parseDot11Capabilities(cursor, frame.capabilities);
+      frame.statusCode = cursor.readUint16();
+      frame.aid = cursor.readUint16();
+    }
+    break;
+  case LAYER2_DOT11_PROBE_REQ:
+    {
+      Layer2::dot11_mgmt_ProbeRequest &frame = dst.emplace_dot11_mgmt_ProbeRequest();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+    }
+    break;
+  case LAYER2_DOT11_PROBE_RESP:
+    {
+      Layer2::dot11_mgmt_ProbeResponse &frame = dst.emplace_dot11_mgmt_ProbeResponse();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      frame.timestamp = cursor.readUint64();
+      frame.interval = cursor.readUint16();
+      parseDot11Capabilities(cursor, frame.capabilities);
+    }
+    break;
+  case LAYER2_DOT11_BEACON:
+    {
+      Layer2::dot11_mgmt_Beacon &frame = dst.emplace_dot11_mgmt_Beacon();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      frame.timestamp = cursor.readUint64();
+      frame.interval = cursor.readUint16();
+      parseDot11Capabilities(cursor, frame.capabilities);
+    }
+    break;
+  case LAYER2_DOT11_DISASSOC:
+    {
+      Layer2::dot11_mgmt_Disassoc &frame = dst.emplace_dot11_mgmt_Disassoc();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      frame.reasonCode = cursor.readUint16();
+    }
+    break;
+  case LAYER2_DOT11_AUTH:
+    {
+      Layer2::dot11_mgmt_Authentication &frame = dst.emplace_dot11_mgmt_Authentication();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      frame.authAlgorithm = cursor.readUint16();
+      frame.authSeqNumber = cursor.readUint16();
+      frame.statusCode = cursor.readUint16();
+    }
+    break;
+  case LAYER2_DOT11_DEAUTH:
+    {
+      Layer2::dot11_mgmt_Deauthentication &frame = dst.emplace_dot11_mgmt_Deauthentication();
+      frame.header = header;
+      parseDot11ExtHeader(cursor, header, frame.mgmtHeader);
+      frame.reasonCode = cursor.readUint16();
+    }
+    break;
+  default:
+    {
+      Layer2::dot11_Unsupported &frame = dst.emplace_dot11_Unsupported();
+      frame.header = header;
+      frame.type = LAYER2_DOT11_MGMT;
+      frame.subtype = subtype;
+    }
+  }
+}
+
+static void parseDot11Ctrl(Cursor &cursor, uint8_t subtype, Layer2::Radiotap::frame_t &dst) {
+  Layer2::dot11_Header header;
+  parseDot11Header(cursor, header);
+  // Only the transmitter address follows (except for acknowledgments), tins
+  // requires it but doesn't expose it.
+  switch (subtype) {
+  case LAYER2_DOT11_ACK:
+    dst.emplace_dot11_ctrl_Ack().header = header;
+    break;
+  case LAYER2_DOT11_BLOCK_ACK:
+    {
+      // Control fields aren't extracted yet (same as when converting tins'
+      // PDUs), they keep their default value.
+      Layer2::dot11_ctrl_BlockAck &frame = dst.emplace_dot11_ctrl_BlockAck();
+      frame.header = header;
+      frame.barControl = frame.startSeq = frame.fragNum = 0;
+      cursor.skip(LAYER2_DOT11_CTRL_TA_SIZE - LAYER2_DOT11_HEADER_SIZE + 12);
+    }
+    break;
+  case LAYER2_DOT11_BLOCK_ACK_REQ:
+    {
+      Layer2::dot11_ctrl_BlockAckRequest &frame = dst.emplace_dot11_ctrl_BlockAckRequest();
+      frame.header = header;
+      frame.barControl = frame.startSeq = frame.fragNum = 0;
+      cursor.skip(LAYER2_DOT11_CTRL_TA_SIZE - LAYER2_DOT11_HEADER_SIZE + 4);
+    }
+    break;
+  case LAYER2_DOT11_CF_END:
+    dst.emplace_dot11_ctrl_CfEnd().header = header;
+    cursor.skip(LAYER2_DOT11_CTRL_TA_SIZE - LAYER2_DOT11_HEADER_SIZE);
+    break;
+  case LAYER2_DOT11_END_CF_ACK:
+    dst.emplace_dot11_ctrl_EndCfAck().header = header;
+    cursor.skip(LAYER2_DOT11_CTRL_TA_SIZE - LAYER2_DOT11_HEADER_SIZE);
+    break;
+  case LAYER2_DOT11_PS_POLL:
+    dst.emplace_dot11_ctrl_PsPoll().header = header;
+    cursor.skip(LAYER2_DOT11_CTRL_TA_SIZE - LAYER2_DOT11_HEADER_SIZE);
+    break;
+  case LAYER2_DOT11_RTS:
+    dst.emplace_dot11_ctrl_Rts().header = header;
+    cursor.skip(LAYER2_DOT11_CTRL_TA_SIZE - LAYER2_DOT11_HEADER_SIZE);
+    break;
+  default:
+    {
+      Layer2::dot11_Unsupported &frame = dst.emplace_dot11_Unsupported();
+      frame.header = header;
+      frame.type = LAYER2_DOT11_CTRL;
+      frame.subtype = subtype;
+    }
+  }
+}
+
+static void parseDot11Data(Cursor &cursor, uint8_t subtype, Layer2::Radiotap::frame_t &dst) {
+  Layer2::dot11_Header header;
+  parseDot11Header(cursor, header);
+  if (subtype <= 4) { // Same cutoff as tins, later subtypes all have QoS.
+    Layer2::dot11_data_Data &frame = dst.emplace_dot11_data_Data();
+    frame.header = header;
+    parseDot11ExtHeader(cursor, header, frame.dataHeader);
+  } else {
+    Layer2::dot11_data_QosData &frame = dst.emplace_dot11_data_QosData();
+    frame.header = header;
+    parseDot11ExtHeader(cursor, header, frame.dataHeader);
+    frame.qosControl = cursor.readUint16();
+  }
+}
+
+/**
+ * Parse an 802.11 frame, returning `false` if it is truncated.
+ *
+ */
+static bool parseDot11(const uint8_t *data, uint32_t len, Layer2::Radiotap::frame_t &dst) {
+  if (len < LAYER2_DOT11_HEADER_SIZE) {
+    return false;
+  }
+  uint8_t type = (data[0] >> 2) & 0x3;
+  uint8_t subtype = data[0] >> 4;
+  Cursor cursor(data, len);
+  switch (type) {
+  case LAYER2_DOT11_MGMT:
+    parseDot11Mgmt(cursor, subtype, dst);
+    break;
+  case LAYER2_DOT11_CTRL:
+    parseDot11Ctrl(cursor, subtype, dst);
+    break;
+  case LAYER2_DOT11_DATA:
+    parseDot11Data(cursor, subtype, dst);
+    break;
+  default:
+    {
+      Layer2::dot11_Unsupported &frame = dst.emplace_dot11_Unsupported();
+      parseDot11Header(cursor, frame.header);
+      frame.type = type;
+      frame.subtype = subtype;
+    }
+  }
+  return cursor.ok();
+}
+
+// Radiotap.
+
+// Present flags for the fields we extract (all in the first namespace).
+#define LAYER2_RADIOTAP_TSFT 0x1
+#define LAYER2_RADIOTAP_FLAGS 0x2
+#define LAYER2_RADIOTAP_RATE 0x4
+#define LAYER2_RADIOTAP_CHANNEL 0x8
+#define LAYER2_RADIOTAP_EXT 0x80000000
+
+// Frame flags.
+#define LAYER2_RADIOTAP_FLAG_FCS 0x10
+
+static void parseRadiotapFlags(uint8_t bits, std::vector<Layer2::radiotap_Flag> &dst) {
+  dst.clear();
+  // Flags are declared in the same order as their bits.
+  for (int i = 0; i < 8; i++) {
+    if (bits & (1 << i)) {
+      dst.push_back((Layer2::radiotap_Flag) i);
+    }
+  }
+}
+
+static Layer2::radiotap_ChannelType getChannelType(uint16_t bits) {
+  // Only channels with a single flag set are recognized (same as tins).
+  switch (bits) {
+  case 0x0010:
+    return Layer2::radiotap_ChannelType::TURBO;
+  case 0x0020:
+    return Layer2::radiotap_ChannelType::CCK;
+  case 0x0040:
+    return Layer2::radiotap_ChannelType::OFDM;
+  case 0x0080:
+    return Layer2::radiotap_ChannelType::TWO_GZ;
+  case 0x0100:
+    return Layer2::radiotap_ChannelType::FIVE_GZ;
+  case 0x0200:
+    return Layer2::radiotap_ChannelType::PASSIVE;
+  case 0x0400:
+    return Layer2::radiotap_ChannelType::DYN_CCK_OFDM;
+  case 0x0800:
+    return Layer2::radiotap_ChannelType::GFSK;
+  default:
+    return Layer2::radiotap_ChannelType();
+  }
+}
+
+bool parseRadiotap(const Frame &frame, Layer2::Radiotap &dst) {
+  if (frame.caplen < 8) {
+    return false;
+  }
+  uint16_t headerLen = frame.data[2] | (uint16_t) frame.data[3] << 8;
+  if (headerLen < 8 || headerLen > frame.caplen) {
+    return false;
+  }
+  Cursor cursor(frame.data, headerLen);
+  cursor.skip(4); // Version, padding, and length.
+  uint32_t present = cursor.readUint32();
+  uint32_t word = present;
+  while (word & LAYER2_RADIOTAP_EXT) {
+    word = cursor.readUint32(); // Extended bitmaps, fields come after.
+  }
+
+  // Fields are aligned to their natural size, relative to the header's start.
+  if (present & LAYER2_RADIOTAP_TSFT) {
+    cursor.align(8);
+    dst.tsft.emplace_long() = cursor.readUint64();
+  } else {
+    dst.tsft.set_null();
+  }
+
+  uint8_t flags = 0;
+  if (present & LAYER2_RADIOTAP_FLAGS) {
+    flags = cursor.readUint8();
+    parseRadiotapFlags(flags, dst.flags.emplace_array());
+  } else {
+    dst.flags.set_null();
+  }
+
+  if (present & LAYER2_RADIOTAP_RATE) {
+    dst.rate.emplace_int() = cursor.readUint8();
+  } else {
+    dst.rate.set_null();
+  }
+
+  if (present & LAYER2_RADIOTAP_CHANNEL) {
+    cursor.align(2);
+    Layer2::radiotap_Channel &channel = dst.channel.emplace_radiotap_Channel();
+    channel.freq = cursor.readUint16();
+    channel.type = getChannelType(cursor.readUint16());
+  } else {
+    dst.channel.set_null();
+  }
+
+  if (!cursor.ok()) {
+    return false; // The fields overflowed the header.
+  }
+
+  uint32_t len = frame.caplen - headerLen;
+  if (flags & LAYER2_RADIOTAP_FLAG_FCS) {
+    if (len < 4) {
+      return false;
+    }
+    len -= 4; // Frame check sequence, at the very end.
+  }
+  if (!len) {
+    dst.frame.set_null();
+    return true;
+  }
+  return parseDot11(frame.data + headerLen, len, dst.frame);
+}
+
+}
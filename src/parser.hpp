@@ -0,0 +1,29 @@
+#pragma once
+
+#include "./frame.hpp"
+#include "./pdus.hpp"
+
+/**
+ * Native parsing of radiotap frames, without going through tins.
+ *
+ */
+
+namespace Layer2 {
+
+/**
+ * Populate a radiotap record directly from a raw frame's bytes.
+ *
+ * This only reads the fields our records contain, in place, so it doesn't
+ * allocate (beyond growing the record's arrays the first few times) unlike
+ * tins, which builds a full tree of PDUs for each frame. Records produced are
+ * the same as those converted from tins' PDUs; the only difference is that
+ * management frames' tagged parameters aren't validated (tins rejects frames
+ * where they are truncated).
+ *
+ * Returns `false` if the frame is malformed (truncated headers), in which case
+ * the record's contents are undefined.
+ *
+ */
+bool parseRadiotap(const Frame &frame, Layer2::Radiotap &dst);
+
+}
@@ -1,31 +1,15 @@
 /**
- * Licensed to the Apache Software Foundation (ASF) under one
- * or more contributor license agreements.  See the NOTICE file
- * distributed with this work for additional information
- * regarding copyright ownership.  The ASF licenses this file
- * to you under the Apache License, Version 2.0 (the
- * "License"); you may not use this file except in compliance
- * with the License.  You may obtain a copy of the License at
+ * Generated by `etc/scripts/compile-idls`, do not edit.
  *
- *     http://www.apache.org/licenses/LICENSE-2.0
- *
- * Unless required by applicable law or agreed to in writing, software
- * distributed under the License is distributed on an "AS IS" BASIS,
- * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
- * See the License for the specific language governing permissions and
- * limitations under the License.
  */
 
+#pragma once
 
-#ifndef SRC_PDUS_HPP_4119412750__H_
-#define SRC_PDUS_HPP_4119412750__H_
-
-
-#include <sstream>
-#include "boost/any.hpp"
-#include "avro/Specific.hh"
-#include "avro/Encoder.hh"
-#include "avro/Decoder.hh"
+#include <map>
+#include <string>
+#include <vector>
+#include "boost/array.hpp"
+#include "avro/Exception.hh"
 
 namespace Layer2 {
 struct Unsupported {
@@ -377,142 +361,247 @@ struct radiotap_Channel {
         { }
 };
 
-struct _63_Union__0__ {
+struct Radiotap_tsft_Union {
 private:
     size_t idx_;
-    boost::any value_;
+    int64_t long_;
 public:
+    static const size_t null_index = 0;
+    static const size_t long_index = 1;
     size_t idx() const { return idx_; }
     bool is_null() const {
         return (idx_ == 0);
     }
     void set_null() {
         idx_ = 0;
-        value_ = boost::any();
     }
-    int64_t get_long() const;
+    const int64_t& get_long() const;
+    int64_t& emplace_long();
     void set_long(const int64_t& v);
-    _63_Union__0__();
+    Radiotap_tsft_Union() :
+        idx_(0),
+        long_(int64_t())
+        { }
 };
 
-struct _63_Union__1__ {
+struct Radiotap_flags_Union {
 private:
     size_t idx_;
-    boost::any value_;
+    std::vector<radiotap_Flag > array_;
 public:
+    static const size_t null_index = 0;
+    static const size_t array_index = 1;
     size_t idx() const { return idx_; }
     bool is_null() const {
         return (idx_ == 0);
     }
     void set_null() {
         idx_ = 0;
-        value_ = boost::any();
     }
-    std::vector<radiotap_Flag > get_array() const;
+    const std::vector<radiotap_Flag >& get_array() const;
+    std::vector<radiotap_Flag >& emplace_array();
     void set_array(const std::vector<radiotap_Flag >& v);
-    _63_Union__1__();
+    Radiotap_flags_Union() :
+        idx_(0),
+        array_(std::vector<radiotap_Flag >())
+        { }
 };
 
-struct _63_Union__2__ {
+struct Radiotap_rate_Union {
 private:
     size_t idx_;
-    boost::any value_;
+    int32_t int_;
 public:
+    static const size_t null_index = 0;
+    static const size_t int_index = 1;
     size_t idx() const { return idx_; }
     bool is_null() const {
         return (idx_ == 0);
     }
     void set_null() {
         idx_ = 0;
-        value_ = boost::any();
     }
-    int32_t get_int() const;
+    const int32_t& get_int() const;
+    int32_t& emplace_int();
     void set_int(const int32_t& v);
-    _63_Union__2__();
+    Radiotap_rate_Union() :
+        idx_(0),
+        int_(int32_t())
+        { }
 };
 
-struct _63_Union__3__ {
+struct Radiotap_channel_Union {
 private:
     size_t idx_;
-    boost::any value_;
+    radiotap_Channel radiotap_Channel_;
 public:
+    static const size_t null_index = 0;
+    static const size_t radiotap_Channel_index = 1;
     size_t idx() const { return idx_; }
     bool is_null() const {
         return (idx_ == 0);
     }
     void set_null() {
         idx_ = 0;
-        value_ = boost::any();
     }
-    radiotap_Channel get_radiotap_Channel() const;
+    const radiotap_Channel& get_radiotap_Channel() const;
+    radiotap_Channel& emplace_radiotap_Channel();
     void set_radiotap_Channel(const radiotap_Channel& v);
-    _63_Union__3__();
+    Radiotap_channel_Union() :
+        idx_(0),
+        radiotap_Channel_(radiotap_Channel())
+        { }
 };
 
-struct _63_Union__4__ {
+struct Radiotap_frame_Union {
 private:
     size_t idx_;
-    boost::any value_;
+    Unsupported Unsupported_;
+    dot11_Unsupported dot11_Unsupported_;
+    dot11_ctrl_Ack dot11_ctrl_Ack_;
+    dot11_ctrl_BlockAck dot11_ctrl_BlockAck_;
+    dot11_ctrl_BlockAckRequest dot11_ctrl_BlockAckRequest_;
+    dot11_ctrl_CfEnd dot11_ctrl_CfEnd_;
+    dot11_ctrl_EndCfAck dot11_ctrl_EndCfAck_;
+    dot11_ctrl_PsPoll dot11_ctrl_PsPoll_;
+    dot11_ctrl_Rts dot11_ctrl_Rts_;
+    dot11_data_Data dot11_data_Data_;
+    dot11_data_QosData dot11_data_QosData_;
+    dot11_mgmt_AssocRequest dot11_mgmt_AssocRequest_;
+    dot11_mgmt_AssocResponse dot11_mgmt_AssocResponse_;
+    dot11_mgmt_Authentication dot11_mgmt_Authentication_;
+    dot11_mgmt_Beacon dot11_mgmt_Beacon_;
+    dot11_mgmt_Deauthentication dot11_mgmt_Deauthentication_;
+    dot11_mgmt_Disassoc dot11_mgmt_Disassoc_;
+    dot11_mgmt_ProbeRequest dot11_mgmt_ProbeRequest_;
+    dot11_mgmt_ProbeResponse dot11_mgmt_ProbeResponse_;
+    dot11_mgmt_ReassocRequest dot11_mgmt_ReassocRequest_;
+    dot11_mgmt_ReassocResponse dot11_mgmt_ReassocResponse_;
 public:
+    static const size_t null_index = 0;
+    static const size_t Unsupported_index = 1;
+    static const size_t dot11_Unsupported_index = 2;
+    static const size_t dot11_ctrl_Ack_index = 3;
+    static const size_t dot11_ctrl_BlockAck_index = 4;
+    static const size_t dot11_ctrl_BlockAckRequest_index = 5;
+    static const size_t dot11_ctrl_CfEnd_index = 6;
+    static const size_t dot11_ctrl_EndCfAck_index = 7;
+    static const size_t dot11_ctrl_PsPoll_index = 8;
+    static const size_t dot11_ctrl_Rts_index = 9;
+    static const size_t dot11_data_Data_index = 10;
+    static const size_t dot11_data_QosData_index = 11;
+    static const size_t dot11_mgmt_AssocRequest_index = 12;
+    static const size_t dot11_mgmt_AssocResponse_index = 13;
+    static const size_t dot11_mgmt_Authentication_index = 14;
+    static const size_t dot11_mgmt_Beacon_index = 15;
+    static const size_t dot11_mgmt_Deauthentication_index = 16;
+    static const size_t dot11_mgmt_Disassoc_index = 17;
+    static const size_t dot11_mgmt_ProbeRequest_index = 18;
+    static const size_t dot11_mgmt_ProbeResponse_index = 19;
+    static const size_t dot11_mgmt_ReassocRequest_index = 20;
+    static const size_t dot11_mgmt_ReassocResponse_index = 21;
     size_t idx() const { return idx_; }
     bool is_null() const {
         return (idx_ == 0);
     }
     void set_null() {
         idx_ = 0;
-        value_ = boost::any();
     }
-    Unsupported get_Unsupported() const;
+    const Unsupported& get_Unsupported() const;
+    Unsupported& emplace_Unsupported();
     void set_Unsupported(const Unsupported& v);
-    dot11_Unsupported get_dot11_Unsupported() const;
+    const dot11_Unsupported& get_dot11_Unsupported() const;
+    dot11_Unsupported& emplace_dot11_Unsupported();
     void set_dot11_Unsupported(const dot11_Unsupported& v);
-    dot11_ctrl_Ack get_dot11_ctrl_Ack() const;
+    const dot11_ctrl_Ack& get_dot11_ctrl_Ack() const;
+    dot11_ctrl_Ack& emplace_dot11_ctrl_Ack();
     void set_dot11_ctrl_Ack(const dot11_ctrl_Ack& v);
-    dot11_ctrl_BlockAck get_dot11_ctrl_BlockAck() const;
+    const dot11_ctrl_BlockAck& get_dot11_ctrl_BlockAck() const;
+    dot11_ctrl_BlockAck& emplace_dot11_ctrl_BlockAck();
     void set_dot11_ctrl_BlockAck(const dot11_ctrl_BlockAck& v);
-    dot11_ctrl_BlockAckRequest get_dot11_ctrl_BlockAckRequest() const;
+    const dot11_ctrl_BlockAckRequest& get_dot11_ctrl_BlockAckRequest() const;
+    dot11_ctrl_BlockAckRequest& emplace_dot11_ctrl_BlockAckRequest();
     void set_dot11_ctrl_BlockAckRequest(const dot11_ctrl_BlockAckRequest& v);
-    dot11_ctrl_CfEnd get_dot11_ctrl_CfEnd() const;
+    const dot11_ctrl_CfEnd& get_dot11_ctrl_CfEnd() const;
+    dot11_ctrl_CfEnd& emplace_dot11_ctrl_CfEnd();
     void set_dot11_ctrl_CfEnd(const dot11_ctrl_CfEnd& v);
-    dot11_ctrl_EndCfAck get_dot11_ctrl_EndCfAck() const;
+    const dot11_ctrl_EndCfAck& get_dot11_ctrl_EndCfAck() const;
+    dot11_ctrl_EndCfAck& emplace_dot11_ctrl_EndCfAck();
     void set_dot11_ctrl_EndCfAck(const dot11_ctrl_EndCfAck& v);
-    dot11_ctrl_PsPoll get_dot11_ctrl_PsPoll() const;
+    const dot11_ctrl_PsPoll& get_dot11_ctrl_PsPoll() const;
+    dot11_ctrl_PsPoll& emplace_dot11_ctrl_PsPoll();
     void set_dot11_ctrl_PsPoll(const dot11_ctrl_PsPoll& v);
-    dot11_ctrl_Rts get_dot11_ctrl_Rts() const;
+    const dot11_ctrl_Rts& get_dot11_ctrl_Rts() const;
+    dot11_ctrl_Rts& emplace_dot11_ctrl_Rts();
     void set_dot11_ctrl_Rts(const dot11_ctrl_Rts& v);
-    dot11_data_Data get_dot11_data_Data() const;
+    const dot11_data_Data& get_dot11_data_Data() const;
+    dot11_data_Data& emplace_dot11_data_Data();
     void set_dot11_data_Data(const dot11_data_Data& v);
-    dot11_data_QosData get_dot11_data_QosData() const;
+    const dot11_data_QosData& get_dot11_data_QosData() const;
+    dot11_data_QosData& emplace_dot11_data_QosData();
     void set_dot11_data_QosData(const dot11_data_QosData& v);
-    dot11_mgmt_AssocRequest get_dot11_mgmt_AssocRequest() const;
+    const dot11_mgmt_AssocRequest& get_dot11_mgmt_AssocRequest() const;
+    dot11_mgmt_AssocRequest& emplace_dot11_mgmt_AssocRequest();
     void set_dot11_mgmt_AssocRequest(const dot11_mgmt_AssocRequest& v);
-    dot11_mgmt_AssocResponse get_dot11_mgmt_AssocResponse() const;
+    const dot11_mgmt_AssocResponse& get_dot11_mgmt_AssocResponse() const;
+    dot11_mgmt_AssocResponse& emplace_dot11_mgmt_AssocResponse();
     void set_dot11_mgmt_AssocResponse(const dot11_mgmt_AssocResponse& v);
-    dot11_mgmt_Authentication get_dot11_mgmt_Authentication() const;
+    const dot11_mgmt_Authentication& get_dot11_mgmt_Authentication() const;
+    dot11_mgmt_Authentication& emplace_dot11_mgmt_Authentication();
     void set_dot11_mgmt_Authentication(const dot11_mgmt_Authentication& v);
-    dot11_mgmt_Beacon get_dot11_mgmt_Beacon() const;
+    const dot11_mgmt_Beacon& get_dot11_mgmt_Beacon() const;
+    dot11_mgmt_Beacon& emplace_dot11_mgmt_Beacon();
     void set_dot11_mgmt_Beacon(const dot11_mgmt_Beacon& v);
-    dot11_mgmt_Deauthentication get_dot11_mgmt_Deauthentication() const;
+    const dot11_mgmt_Deauthentication& get_dot11_mgmt_Deauthentication() const;
+    dot11_mgmt_Deauthentication& emplace_dot11_mgmt_Deauthentication();
     void set_dot11_mgmt_Deauthentication(const dot11_mgmt_Deauthentication& v);
-    dot11_mgmt_Disassoc get_dot11_mgmt_Disassoc() const;
+    const dot11_mgmt_Disassoc& get_dot11_mgmt_Disassoc() const;
+    dot11_mgmt_Disassoc& emplace_dot11_mgmt_Disassoc();
     void set_dot11_mgmt_Disassoc(const dot11_mgmt_Disassoc& v);
-    dot11_mgmt_ProbeRequest get_dot11_mgmt_ProbeRequest() const;
+    const dot11_mgmt_ProbeRequest& get_dot11_mgmt_ProbeRequest() const;
+    dot11_mgmt_ProbeRequest& emplace_dot11_mgmt_ProbeRequest();
     void set_dot11_mgmt_ProbeRequest(const dot11_mgmt_ProbeRequest& v);
-    dot11_mgmt_ProbeResponse get_dot11_mgmt_ProbeResponse() const;
+    const dot11_mgmt_ProbeResponse& get_dot11_mgmt_ProbeResponse() const;
+    dot11_mgmt_ProbeResponse& emplace_dot11_mgmt_ProbeResponse();
     void set_dot11_mgmt_ProbeResponse(const dot11_mgmt_ProbeResponse& v);
-    dot11_mgmt_ReassocRequest get_dot11_mgmt_ReassocRequest() const;
+    const dot11_mgmt_ReassocRequest& get_dot11_mgmt_ReassocRequest() const;
+    dot11_mgmt_ReassocRequest& emplace_dot11_mgmt_ReassocRequest();
     void set_dot11_mgmt_ReassocRequest(const dot11_mgmt_ReassocRequest& v);
-    dot11_mgmt_ReassocResponse get_dot11_mgmt_ReassocResponse() const;
+    const dot11_mgmt_ReassocResponse& get_dot11_mgmt_ReassocResponse() const;
+    dot11_mgmt_ReassocResponse& emplace_dot11_mgmt_ReassocResponse();
     void set_dot11_mgmt_ReassocResponse(const dot11_mgmt_ReassocResponse& v);
-    _63_Union__4__();
+    Radiotap_frame_Union() :
+        idx_(0),
+        Unsupported_(Unsupported()),
+        dot11_Unsupported_(dot11_Unsupported()),
+        dot11_ctrl_Ack_(dot11_ctrl_Ack()),
+        dot11_ctrl_BlockAck_(dot11_ctrl_BlockAck()),
+        dot11_ctrl_BlockAckRequest_(dot11_ctrl_BlockAckRequest()),
+        dot11_ctrl_CfEnd_(dot11_ctrl_CfEnd()),
+        dot11_ctrl_EndCfAck_(dot11_ctrl_EndCfAck()),
+        dot11_ctrl_PsPoll_(dot11_ctrl_PsPoll()),
+        dot11_ctrl_Rts_(dot11_ctrl_Rts()),
+        dot11_data_Data_(dot11_data_Data()),
+        dot11_data_QosData_(dot11_data_QosData()),
+        dot11_mgmt_AssocRequest_(dot11_mgmt_AssocRequest()),
+        dot11_mgmt_AssocResponse_(dot11_mgmt_AssocResponse()),
+        dot11_mgmt_Authentication_(dot11_mgmt_Authentication()),
+        dot11_mgmt_Beacon_(dot11_mgmt_Beacon()),
+        dot11_mgmt_Deauthentication_(dot11_mgmt_Deauthentication()),
+        dot11_mgmt_Disassoc_(dot11_mgmt_Disassoc()),
+        dot11_mgmt_ProbeRequest_(dot11_mgmt_ProbeRequest()),
+        dot11_mgmt_ProbeResponse_(dot11_mgmt_ProbeResponse()),
+        dot11_mgmt_ReassocRequest_(dot11_mgmt_ReassocRequest()),
+        dot11_mgmt_ReassocResponse_(dot11_mgmt_ReassocResponse())
+        { }
 };
 
 struct Radiotap {
-    typedef _63_Union__0__ tsft_t;
-    typedef _63_Union__1__ flags_t;
-    typedef _63_Union__2__ rate_t;
-    typedef _63_Union__3__ channel_t;
-    typedef _63_Union__4__ frame_t;
+    typedef Radiotap_tsft_Union tsft_t;
+    typedef Radiotap_flags_Union flags_t;
+    typedef Radiotap_rate_Union rate_t;
+    typedef Radiotap_channel_Union channel_t;
+    typedef Radiotap_frame_Union frame_t;
     tsft_t tsft;
     flags_t flags;
     rate_t rate;
@@ -527,23 +616,36 @@ struct Radiotap {
         { }
 };
 
-struct _63_Union__5__ {
+struct Pdu_frame_Union {
 private:
     size_t idx_;
-    boost::any value_;
+    Unsupported Unsupported_;
+    Ethernet2 Ethernet2_;
+    Radiotap Radiotap_;
 public:
+    static const size_t Unsupported_index = 0;
+    static const size_t Ethernet2_index = 1;
+    static const size_t Radiotap_index = 2;
     size_t idx() const { return idx_; }
-    Unsupported get_Unsupported() const;
+    const Unsupported& get_Unsupported() const;
+    Unsupported& emplace_Unsupported();
     void set_Unsupported(const Unsupported& v);
-    Ethernet2 get_Ethernet2() const;
+    const Ethernet2& get_Ethernet2() const;
+    Ethernet2& emplace_Ethernet2();
     void set_Ethernet2(const Ethernet2& v);
-    Radiotap get_Radiotap() const;
+    const Radiotap& get_Radiotap() const;
+    Radiotap& emplace_Radiotap();
     void set_Radiotap(const Radiotap& v);
-    _63_Union__5__();
+    Pdu_frame_Union() :
+        idx_(0),
+        Unsupported_(Unsupported()),
+        Ethernet2_(Ethernet2()),
+        Radiotap_(Radiotap())
+        { }
 };
 
 struct Pdu {
-    typedef _63_Union__5__ frame_t;
+    typedef Pdu_frame_Union frame_t;
     int32_t size;
     int64_t timestamp;
     frame_t frame;
@@ -554,2743 +656,1064 @@ struct Pdu {
         { }
 };
 
-struct _63_Union__6__ {
-private:
-    size_t idx_;
-    boost::any value_;
-public:
-    size_t idx() const { return idx_; }
-    Unsupported get_Unsupported() const;
-    void set_Unsupported(const Unsupported& v);
-    boost::array<uint8_t, 6> get_MacAddr() const;
-    void set_MacAddr(const boost::array<uint8_t, 6>& v);
-    Ethernet2 get_Ethernet2() const;
-    void set_Ethernet2(const Ethernet2& v);
-    dot11_Header get_dot11_Header() const;
-    void set_dot11_Header(const dot11_Header& v);
-    dot11_Unsupported get_dot11_Unsupported() const;
-    void set_dot11_Unsupported(const dot11_Unsupported& v);
-    dot11_ctrl_Ack get_dot11_ctrl_Ack() const;
-    void set_dot11_ctrl_Ack(const dot11_ctrl_Ack& v);
-    dot11_ctrl_BlockAck get_dot11_ctrl_BlockAck() const;
-    void set_dot11_ctrl_BlockAck(const dot11_ctrl_BlockAck& v);
-    dot11_ctrl_BlockAckRequest get_dot11_ctrl_BlockAckRequest() const;
-    void set_dot11_ctrl_BlockAckRequest(const dot11_ctrl_BlockAckRequest& v);
-    dot11_ctrl_CfEnd get_dot11_ctrl_CfEnd() const;
-    void set_dot11_ctrl_CfEnd(const dot11_ctrl_CfEnd& v);
-    dot11_ctrl_EndCfAck get_dot11_ctrl_EndCfAck() const;
-    void set_dot11_ctrl_EndCfAck(const dot11_ctrl_EndCfAck& v);
-    dot11_ctrl_PsPoll get_dot11_ctrl_PsPoll() const;
-    void set_dot11_ctrl_PsPoll(const dot11_ctrl_PsPoll& v);
-    dot11_ctrl_Rts get_dot11_ctrl_Rts() const;
-    void set_dot11_ctrl_Rts(const dot11_ctrl_Rts& v);
-    dot11_data_Header get_dot11_data_Header() const;
-    void set_dot11_data_Header(const dot11_data_Header& v);
-    dot11_data_Data get_dot11_data_Data() const;
-    void set_dot11_data_Data(const dot11_data_Data& v);
-    dot11_data_QosData get_dot11_data_QosData() const;
-    void set_dot11_data_QosData(const dot11_data_QosData& v);
-    dot11_mgmt_Capability get_dot11_mgmt_Capability() const;
-    void set_dot11_mgmt_Capability(const dot11_mgmt_Capability& v);
-    dot11_mgmt_Header get_dot11_mgmt_Header() const;
-    void set_dot11_mgmt_Header(const dot11_mgmt_Header& v);
-    dot11_mgmt_AssocRequest get_dot11_mgmt_AssocRequest() const;
-    void set_dot11_mgmt_AssocRequest(const dot11_mgmt_AssocRequest& v);
-    dot11_mgmt_AssocResponse get_dot11_mgmt_AssocResponse() const;
-    void set_dot11_mgmt_AssocResponse(const dot11_mgmt_AssocResponse& v);
-    dot11_mgmt_Authentication get_dot11_mgmt_Authentication() const;
-    void set_dot11_mgmt_Authentication(const dot11_mgmt_Authentication& v);
-    dot11_mgmt_Beacon get_dot11_mgmt_Beacon() const;
-    void set_dot11_mgmt_Beacon(const dot11_mgmt_Beacon& v);
-    dot11_mgmt_Deauthentication get_dot11_mgmt_Deauthentication() const;
-    void set_dot11_mgmt_Deauthentication(const dot11_mgmt_Deauthentication& v);
-    dot11_mgmt_Disassoc get_dot11_mgmt_Disassoc() const;
-    void set_dot11_mgmt_Disassoc(const dot11_mgmt_Disassoc& v);
-    dot11_mgmt_ProbeRequest get_dot11_mgmt_ProbeRequest() const;
-    void set_dot11_mgmt_ProbeRequest(const dot11_mgmt_ProbeRequest& v);
-    dot11_mgmt_ProbeResponse get_dot11_mgmt_ProbeResponse() const;
-    void set_dot11_mgmt_ProbeResponse(const dot11_mgmt_ProbeResponse& v);
-    dot11_mgmt_ReassocRequest get_dot11_mgmt_ReassocRequest() const;
-    void set_dot11_mgmt_ReassocRequest(const dot11_mgmt_ReassocRequest& v);
-    dot11_mgmt_ReassocResponse get_dot11_mgmt_ReassocResponse() const;
-    void set_dot11_mgmt_ReassocResponse(const dot11_mgmt_ReassocResponse& v);
-    radiotap_Flag get_radiotap_Flag() const;
-    void set_radiotap_Flag(const radiotap_Flag& v);
-    radiotap_ChannelType get_radiotap_ChannelType() const;
-    void set_radiotap_ChannelType(const radiotap_ChannelType& v);
-    radiotap_Channel get_radiotap_Channel() const;
-    void set_radiotap_Channel(const radiotap_Channel& v);
-    Radiotap get_Radiotap() const;
-    void set_Radiotap(const Radiotap& v);
-    Pdu get_Pdu() const;
-    void set_Pdu(const Pdu& v);
-    _63_Union__6__();
-};
-
 inline
-int64_t _63_Union__0__::get_long() const {
+const int64_t& Radiotap_tsft_Union::get_long() const {
     if (idx_ != 1) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<int64_t >(value_);
+    return long_;
+}
+
+inline
+int64_t& Radiotap_tsft_Union::emplace_long() {
+    idx_ = 1;
+    return long_;
 }
 
 inline
-void _63_Union__0__::set_long(const int64_t& v) {
+void Radiotap_tsft_Union::set_long(const int64_t& v) {
     idx_ = 1;
-    value_ = v;
+    long_ = v;
 }
 
 inline
-std::vector<radiotap_Flag > _63_Union__1__::get_array() const {
+const std::vector<radiotap_Flag >& Radiotap_flags_Union::get_array() const {
     if (idx_ != 1) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<std::vector<radiotap_Flag > >(value_);
+    return array_;
+}
+
+inline
+std::vector<radiotap_Flag >& Radiotap_flags_Union::emplace_array() {
+    idx_ = 1;
+    return array_;
 }
 
 inline
-void _63_Union__1__::set_array(const std::vector<radiotap_Flag >& v) {
+void Radiotap_flags_Union::set_array(const std::vector<radiotap_Flag >& v) {
     idx_ = 1;
-    value_ = v;
+    array_ = v;
 }
 
 inline
-int32_t _63_Union__2__::get_int() const {
+const int32_t& Radiotap_rate_Union::get_int() const {
     if (idx_ != 1) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<int32_t >(value_);
+    return int_;
+}
+
+inline
+int32_t& Radiotap_rate_Union::emplace_int() {
+    idx_ = 1;
+    return int_;
 }
 
 inline
-void _63_Union__2__::set_int(const int32_t& v) {
+void Radiotap_rate_Union::set_int(const int32_t& v) {
     idx_ = 1;
-    value_ = v;
+    int_ = v;
 }
 
 inline
-radiotap_Channel _63_Union__3__::get_radiotap_Channel() const {
+const radiotap_Channel& Radiotap_channel_Union::get_radiotap_Channel() const {
     if (idx_ != 1) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<radiotap_Channel >(value_);
+    return radiotap_Channel_;
+}
+
+inline
+radiotap_Channel& Radiotap_channel_Union::emplace_radiotap_Channel() {
+    idx_ = 1;
+    return radiotap_Channel_;
 }
 
 inline
-void _63_Union__3__::set_radiotap_Channel(const radiotap_Channel& v) {
+void Radiotap_channel_Union::set_radiotap_Channel(const radiotap_Channel& v) {
     idx_ = 1;
-    value_ = v;
+    radiotap_Channel_ = v;
 }
 
 inline
-Unsupported _63_Union__4__::get_Unsupported() const {
+const Unsupported& Radiotap_frame_Union::get_Unsupported() const {
     if (idx_ != 1) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<Unsupported >(value_);
+    return Unsupported_;
+}
+
+inline
+Unsupported& Radiotap_frame_Union::emplace_Unsupported() {
+    idx_ = 1;
+    return Unsupported_;
 }
 
 inline
-void _63_Union__4__::set_Unsupported(const Unsupported& v) {
+void Radiotap_frame_Union::set_Unsupported(const Unsupported& v) {
     idx_ = 1;
-    value_ = v;
+    Unsupported_ = v;
 }
 
 inline
-dot11_Unsupported _63_Union__4__::get_dot11_Unsupported() const {
+const dot11_Unsupported& Radiotap_frame_Union::get_dot11_Unsupported() const {
     if (idx_ != 2) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_Unsupported >(value_);
+    return dot11_Unsupported_;
+}
+
+inline
+dot11_Unsupported& Radiotap_frame_Union::emplace_dot11_Unsupported() {
+    idx_ = 2;
+    return dot11_Unsupported_;
 }
 
 inline
-void _63_Union__4__::set_dot11_Unsupported(const dot11_Unsupported& v) {
+void Radiotap_frame_Union::set_dot11_Unsupported(const dot11_Unsupported& v) {
     idx_ = 2;
-    value_ = v;
+    dot11_Unsupported_ = v;
 }
 
 inline
-dot11_ctrl_Ack _63_Union__4__::get_dot11_ctrl_Ack() const {
+const dot11_ctrl_Ack& Radiotap_frame_Union::get_dot11_ctrl_Ack() const {
     if (idx_ != 3) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_ctrl_Ack >(value_);
+    return dot11_ctrl_Ack_;
+}
+
+inline
+dot11_ctrl_Ack& Radiotap_frame_Union::emplace_dot11_ctrl_Ack() {
+    idx_ = 3;
+    return dot11_ctrl_Ack_;
 }
 
 inline
-void _63_Union__4__::set_dot11_ctrl_Ack(const dot11_ctrl_Ack& v) {
+void Radiotap_frame_Union::set_dot11_ctrl_Ack(const dot11_ctrl_Ack& v) {
     idx_ = 3;
-    value_ = v;
+    dot11_ctrl_Ack_ = v;
 }
 
 inline
-dot11_ctrl_BlockAck _63_Union__4__::get_dot11_ctrl_BlockAck() const {
+const dot11_ctrl_BlockAck& Radiotap_frame_Union::get_dot11_ctrl_BlockAck() const {
     if (idx_ != 4) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_ctrl_BlockAck >(value_);
+    return dot11_ctrl_BlockAck_;
+}
+
+inline
+dot11_ctrl_BlockAck& Radiotap_frame_Union::emplace_dot11_ctrl_BlockAck() {
+    idx_ = 4;
+    return dot11_ctrl_BlockAck_;
 }
 
 inline
-void _63_Union__4__::set_dot11_ctrl_BlockAck(const dot11_ctrl_BlockAck& v) {
+void Radiotap_frame_Union::set_dot11_ctrl_BlockAck(const dot11_ctrl_BlockAck& v) {
     idx_ = 4;
-    value_ = v;
+    dot11_ctrl_BlockAck_ = v;
 }
 
 inline
-dot11_ctrl_BlockAckRequest _63_Union__4__::get_dot11_ctrl_BlockAckRequest() const {
+const dot11_ctrl_BlockAckRequest& Radiotap_frame_Union::get_dot11_ctrl_BlockAckRequest() const {
     if (idx_ != 5) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_ctrl_BlockAckRequest >(value_);
+    return dot11_ctrl_BlockAckRequest_;
+}
+
+inline
+dot11_ctrl_BlockAckRequest& Radiotap_frame_Union::emplace_dot11_ctrl_BlockAckRequest() {
+    idx_ = 5;
+    return dot11_ctrl_BlockAckRequest_;
 }
 
 inline
-void _63_Union__4__::set_dot11_ctrl_BlockAckRequest(const dot11_ctrl_BlockAckRequest& v) {
+void Radiotap_frame_Union::set_dot11_ctrl_BlockAckRequest(const dot11_ctrl_BlockAckRequest& v) {
     idx_ = 5;
-    value_ = v;
+    dot11_ctrl_BlockAckRequest_ = v;
 }
 
 inline
-dot11_ctrl_CfEnd _63_Union__4__::get_dot11_ctrl_CfEnd() const {
+const dot11_ctrl_CfEnd& Radiotap_frame_Union::get_dot11_ctrl_CfEnd() const {
     if (idx_ != 6) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_ctrl_CfEnd >(value_);
+    return dot11_ctrl_CfEnd_;
+}
+
+inline
+dot11_ctrl_CfEnd& Radiotap_frame_Union::emplace_dot11_ctrl_CfEnd() {
+    idx_ = 6;
+    return dot11_ctrl_CfEnd_;
 }
 
 inline
-void _63_Union__4__::set_dot11_ctrl_CfEnd(const dot11_ctrl_CfEnd& v) {
+void Radiotap_frame_Union::set_dot11_ctrl_CfEnd(const dot11_ctrl_CfEnd& v) {
     idx_ = 6;
-    value_ = v;
+    dot11_ctrl_CfEnd_ = v;
 }
 
 inline
-dot11_ctrl_EndCfAck _63_Union__4__::get_dot11_ctrl_EndCfAck() const {
+const dot11_ctrl_EndCfAck& Radiotap_frame_Union::get_dot11_ctrl_EndCfAck() const {
     if (idx_ != 7) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_ctrl_EndCfAck >(value_);
+    return dot11_ctrl_EndCfAck_;
+}
+
+inline
+dot11_ctrl_EndCfAck& Radiotap_frame_Union::emplace_dot11_ctrl_EndCfAck() {
+    idx_ = 7;
+    return dot11_ctrl_EndCfAck_;
 }
 
 inline
-void _63_Union__4__::set_dot11_ctrl_EndCfAck(const dot11_ctrl_EndCfAck& v) {
+void Radiotap_frame_Union::set_dot11_ctrl_EndCfAck(const dot11_ctrl_EndCfAck& v) {
     idx_ = 7;
-    value_ = v;
+    dot11_ctrl_EndCfAck_ = v;
 }
 
 inline
-dot11_ctrl_PsPoll _63_Union__4__::get_dot11_ctrl_PsPoll() const {
+const dot11_ctrl_PsPoll& Radiotap_frame_Union::get_dot11_ctrl_PsPoll() const {
     if (idx_ != 8) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_ctrl_PsPoll >(value_);
+    return dot11_ctrl_PsPoll_;
+}
+
+inline
+dot11_ctrl_PsPoll& Radiotap_frame_Union::emplace_dot11_ctrl_PsPoll() {
+    idx_ = 8;
+    return dot11_ctrl_PsPoll_;
 }
 
 inline
-void _63_Union__4__::set_dot11_ctrl_PsPoll(const dot11_ctrl_PsPoll& v) {
+void Radiotap_frame_Union::set_dot11_ctrl_PsPoll(const dot11_ctrl_PsPoll& v) {
     idx_ = 8;
-    value_ = v;
+    dot11_ctrl_PsPoll_ = v;
 }
 
 inline
-dot11_ctrl_Rts _63_Union__4__::get_dot11_ctrl_Rts() const {
+const dot11_ctrl_Rts& Radiotap_frame_Union::get_dot11_ctrl_Rts() const {
     if (idx_ != 9) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_ctrl_Rts >(value_);
+    return dot11_ctrl_Rts_;
+}
+
+inline
+dot11_ctrl_Rts& Radiotap_frame_Union::emplace_dot11_ctrl_Rts() {
+    idx_ = 9;
+    return dot11_ctrl_Rts_;
 }
 
 inline
-void _63_Union__4__::set_dot11_ctrl_Rts(const dot11_ctrl_Rts& v) {
+void Radiotap_frame_Union::set_dot11_ctrl_Rts(const dot11_ctrl_Rts& v) {
     idx_ = 9;
-    value_ = v;
+    dot11_ctrl_Rts_ = v;
 }
 
 inline
-dot11_data_Data _63_Union__4__::get_dot11_data_Data() const {
+const dot11_data_Data& Radiotap_frame_Union::get_dot11_data_Data() const {
     if (idx_ != 10) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_data_Data >(value_);
+    return dot11_data_Data_;
+}
+
+inline
+dot11_data_Data& Radiotap_frame_Union::emplace_dot11_data_Data() {
+    idx_ = 10;
+    return dot11_data_Data_;
 }
 
 inline
-void _63_Union__4__::set_dot11_data_Data(const dot11_data_Data& v) {
+void Radiotap_frame_Union::set_dot11_data_Data(const dot11_data_Data& v) {
     idx_ = 10;
-    value_ = v;
+    dot11_data_Data_ = v;
 }
 
 inline
-dot11_data_QosData _63_Union__4__::get_dot11_data_QosData() const {
+const dot11_data_QosData& Radiotap_frame_Union::get_dot11_data_QosData() const {
     if (idx_ != 11) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_data_QosData >(value_);
+    return dot11_data_QosData_;
+}
+
+inline
+dot11_data_QosData& Radiotap_frame_Union::emplace_dot11_data_QosData() {
+    idx_ = 11;
+    return dot11_data_QosData_;
 }
 
 inline
-void _63_Union__4__::set_dot11_data_QosData(const dot11_data_QosData& v) {
+void Radiotap_frame_Union::set_dot11_data_QosData(const dot11_data_QosData& v) {
     idx_ = 11;
-    value_ = v;
+    dot11_data_QosData_ = v;
 }
 
 inline
-dot11_mgmt_AssocRequest _63_Union__4__::get_dot11_mgmt_AssocRequest() const {
+const dot11_mgmt_AssocRequest& Radiotap_frame_Union::get_dot11_mgmt_AssocRequest() const {
     if (idx_ != 12) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_AssocRequest >(value_);
+    return dot11_mgmt_AssocRequest_;
+}
+
+inline
+dot11_mgmt_AssocRequest& Radiotap_frame_Union::emplace_dot11_mgmt_AssocRequest() {
+    idx_ = 12;
+    return dot11_mgmt_AssocRequest_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_AssocRequest(const dot11_mgmt_AssocRequest& v) {
+void Radiotap_frame_Union::set_dot11_mgmt_AssocRequest(const dot11_mgmt_AssocRequest& v) {
     idx_ = 12;
-    value_ = v;
+    dot11_mgmt_AssocRequest_ = v;
 }
 
 inline
-dot11_mgmt_AssocResponse _63_Union__4__::get_dot11_mgmt_AssocResponse() const {
+const dot11_mgmt_AssocResponse& Radiotap_frame_Union::get_dot11_mgmt_AssocResponse() const {
     if (idx_ != 13) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_AssocResponse >(value_);
+    return dot11_mgmt_AssocResponse_;
+}
+
+inline
+dot11_mgmt_AssocResponse& Radiotap_frame_Union::emplace_dot11_mgmt_AssocResponse() {
+    idx_ = 13;
+    return dot11_mgmt_AssocResponse_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_AssocResponse(const dot11_mgmt_AssocResponse& v) {
+void Radiotap_frame_Union::set_dot11_mgmt_AssocResponse(const dot11_mgmt_AssocResponse& v) {
     idx_ = 13;
-    value_ = v;
+    dot11_mgmt_AssocResponse_ = v;
 }
 
 inline
-dot11_mgmt_Authentication _63_Union__4__::get_dot11_mgmt_Authentication() const {
+const dot11_mgmt_Authentication& Radiotap_frame_Union::get_dot11_mgmt_Authentication() const {
     if (idx_ != 14) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_Authentication >(value_);
+    return dot11_mgmt_Authentication_;
+}
+
+inline
+dot11_mgmt_Authentication& Radiotap_frame_Union::emplace_dot11_mgmt_Authentication() {
+    idx_ = 14;
+    return dot11_mgmt_Authentication_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_Authentication(const dot11_mgmt_Authentication& v) {
+void Radiotap_frame_Union::set_dot11_mgmt_Authentication(const dot11_mgmt_Authentication& v) {
     idx_ = 14;
-    value_ = v;
+    dot11_mgmt_Authentication_ = v;
 }
 
 inline
-dot11_mgmt_Beacon _63_Union__4__::get_dot11_mgmt_Beacon() const {
+const dot11_mgmt_Beacon& Radiotap_frame_Union::get_dot11_mgmt_Beacon() const {
     if (idx_ != 15) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_Beacon >(value_);
+    return dot11_mgmt_Beacon_;
+}
+
+inline
+dot11_mgmt_Beacon& Radiotap_frame_Union::emplace_dot11_mgmt_Beacon() {
+    idx_ = 15;
+    return dot11_mgmt_Beacon_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_Beacon(const dot11_mgmt_Beacon& v) {
+void Radiotap_frame_Union::set_dot11_mgmt_Beacon(const dot11_mgmt_Beacon& v) {
     idx_ = 15;
-    value_ = v;
+    dot11_mgmt_Beacon_ = v;
 }
 
 inline
-dot11_mgmt_Deauthentication _63_Union__4__::get_dot11_mgmt_Deauthentication() const {
+const dot11_mgmt_Deauthentication& Radiotap_frame_Union::get_dot11_mgmt_Deauthentication() const {
     if (idx_ != 16) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_Deauthentication >(value_);
+    return dot11_mgmt_Deauthentication_;
+}
+
+inline
+dot11_mgmt_Deauthentication& Radiotap_frame_Union::emplace_dot11_mgmt_Deauthentication() {
+    idx_ = 16;
+    return dot11_mgmt_Deauthentication_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_Deauthentication(const dot11_mgmt_Deauthentication& v) {
+void Radiotap_frame_Union::set_dot11_mgmt_Deauthentication(const dot11_mgmt_Deauthentication& v) {
     idx_ = 16;
-    value_ = v;
+    dot11_mgmt_Deauthentication_ = v;
 }
 
 inline
-dot11_mgmt_Disassoc _63_Union__4__::get_dot11_mgmt_Disassoc() const {
+const dot11_mgmt_Disassoc& Radiotap_frame_Union::get_dot11_mgmt_Disassoc() const {
     if (idx_ != 17) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_Disassoc >(value_);
+    return dot11_mgmt_Disassoc_;
+}
+
+inline
+dot11_mgmt_Disassoc& Radiotap_frame_Union::emplace_dot11_mgmt_Disassoc() {
+    idx_ = 17;
+    return dot11_mgmt_Disassoc_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_Disassoc(const dot11_mgmt_Disassoc& v) {
+void Radiotap_frame_Union::set_dot11_mgmt_Disassoc(const dot11_mgmt_Disassoc& v) {
     idx_ = 17;
-    value_ = v;
+    dot11_mgmt_Disassoc_ = v;
 }
 
 inline
-dot11_mgmt_ProbeRequest _63_Union__4__::get_dot11_mgmt_ProbeRequest() const {
+const dot11_mgmt_ProbeRequest& Radiotap_frame_Union::get_dot11_mgmt_ProbeRequest() const {
     if (idx_ != 18) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_ProbeRequest >(value_);
+    return dot11_mgmt_ProbeRequest_;
+}
+
+inline
+dot11_mgmt_ProbeRequest& Radiotap_frame_Union::emplace_dot11_mgmt_ProbeRequest() {
+    idx_ = 18;
+    return dot11_mgmt_ProbeRequest_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_ProbeRequest(const dot11_mgmt_ProbeRequest& v) {
+void Radiotap_frame_Union::set_dot11_mgmt_ProbeRequest(const dot11_mgmt_ProbeRequest& v) {
     idx_ = 18;
-    value_ = v;
+    dot11_mgmt_ProbeRequest_ = v;
 }
 
 inline
-dot11_mgmt_ProbeResponse _63_Union__4__::get_dot11_mgmt_ProbeResponse() const {
+const dot11_mgmt_ProbeResponse& Radiotap_frame_Union::get_dot11_mgmt_ProbeResponse() const {
     if (idx_ != 19) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_ProbeResponse >(value_);
+    return dot11_mgmt_ProbeResponse_;
+}
+
+inline
+dot11_mgmt_ProbeResponse& Radiotap_frame_Union::emplace_dot11_mgmt_ProbeResponse() {
+    idx_ = 19;
+    return dot11_mgmt_ProbeResponse_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_ProbeResponse(const dot11_mgmt_ProbeResponse& v) {
+void Radiotap_frame_Union::set_dot11_mgmt_ProbeResponse(const dot11_mgmt_ProbeResponse& v) {
     idx_ = 19;
-    value_ = v;
+    dot11_mgmt_ProbeResponse_ = v;
 }
 
 inline
-dot11_mgmt_ReassocRequest _63_Union__4__::get_dot11_mgmt_ReassocRequest() const {
+const dot11_mgmt_ReassocRequest& Radiotap_frame_Union::get_dot11_mgmt_ReassocRequest() const {
     if (idx_ != 20) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<dot11_mgmt_ReassocRequest >(value_);
+    return dot11_mgmt_ReassocRequest_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_ReassocRequest(const dot11_mgmt_ReassocRequest& v) {
+dot11_mgmt_ReassocRequest& Radiotap_frame_Union::emplace_dot11_mgmt_ReassocRequest() {
     idx_ = 20;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_ReassocResponse _63_Union__4__::get_dot11_mgmt_ReassocResponse() const {
-    if (idx_ != 21) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_ReassocResponse >(value_);
+    return dot11_mgmt_ReassocRequest_;
 }
 
 inline
-void _63_Union__4__::set_dot11_mgmt_ReassocResponse(const dot11_mgmt_ReassocResponse& v) {
-    idx_ = 21;
-    value_ = v;
+void Radiotap_frame_Union::set_dot11_mgmt_ReassocRequest(const dot11_mgmt_ReassocRequest& v) {
+    idx_ = 20;
+    dot11_mgmt_ReassocRequest_ = v;
 }
 
 inline
-Unsupported _63_Union__5__::get_Unsupported() const {
-    if (idx_ != 0) {
+const dot11_mgmt_ReassocResponse& Radiotap_frame_Union::get_dot11_mgmt_ReassocResponse() const {
+    if (idx_ != 21) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<Unsupported >(value_);
-}
-
-inline
-void _63_Union__5__::set_Unsupported(const Unsupported& v) {
-    idx_ = 0;
-    value_ = v;
+    return dot11_mgmt_ReassocResponse_;
 }
 
 inline
-Ethernet2 _63_Union__5__::get_Ethernet2() const {
-    if (idx_ != 1) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<Ethernet2 >(value_);
+dot11_mgmt_ReassocResponse& Radiotap_frame_Union::emplace_dot11_mgmt_ReassocResponse() {
+    idx_ = 21;
+    return dot11_mgmt_ReassocResponse_;
 }
 
 inline
-void _63_Union__5__::set_Ethernet2(const Ethernet2& v) {
-    idx_ = 1;
-    value_ = v;
+void Radiotap_frame_Union::set_dot11_mgmt_ReassocResponse(const dot11_mgmt_ReassocResponse& v) {
+    idx_ = 21;
+    dot11_mgmt_ReassocResponse_ = v;
 }
 
 inline
-Radiotap _63_Union__5__::get_Radiotap() const {
-    if (idx_ != 2) {
+const Unsupported& Pdu_frame_Union::get_Unsupported() const {
+    if (idx_ != 0) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<Radiotap >(value_);
-}
-
-inline
-void _63_Union__5__::set_Radiotap(const Radiotap& v) {
-    idx_ = 2;
-    value_ = v;
+    return Unsupported_;
 }
 
 inline
-Unsupported _63_Union__6__::get_Unsupported() const {
-    if (idx_ != 0) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<Unsupported >(value_);
+Unsupported& Pdu_frame_Union::emplace_Unsupported() {
+    idx_ = 0;
+    return Unsupported_;
 }
 
 inline
-void _63_Union__6__::set_Unsupported(const Unsupported& v) {
+void Pdu_frame_Union::set_Unsupported(const Unsupported& v) {
     idx_ = 0;
-    value_ = v;
+    Unsupported_ = v;
 }
 
 inline
-boost::array<uint8_t, 6> _63_Union__6__::get_MacAddr() const {
+const Ethernet2& Pdu_frame_Union::get_Ethernet2() const {
     if (idx_ != 1) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<boost::array<uint8_t, 6> >(value_);
+    return Ethernet2_;
+}
+
+inline
+Ethernet2& Pdu_frame_Union::emplace_Ethernet2() {
+    idx_ = 1;
+    return Ethernet2_;
 }
 
 inline
-void _63_Union__6__::set_MacAddr(const boost::array<uint8_t, 6>& v) {
+void Pdu_frame_Union::set_Ethernet2(const Ethernet2& v) {
     idx_ = 1;
-    value_ = v;
+    Ethernet2_ = v;
 }
 
 inline
-Ethernet2 _63_Union__6__::get_Ethernet2() const {
+const Radiotap& Pdu_frame_Union::get_Radiotap() const {
     if (idx_ != 2) {
         throw avro::Exception("Invalid type for union");
     }
-    return boost::any_cast<Ethernet2 >(value_);
+    return Radiotap_;
 }
 
 inline
-void _63_Union__6__::set_Ethernet2(const Ethernet2& v) {
+Radiotap& Pdu_frame_Union::emplace_Radiotap() {
     idx_ = 2;
-    value_ = v;
+    return Radiotap_;
 }
 
 inline
-dot11_Header _63_Union__6__::get_dot11_Header() const {
-    if (idx_ != 3) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_Header >(value_);
+void Pdu_frame_Union::set_Radiotap(const Radiotap& v) {
+    idx_ = 2;
+    Radiotap_ = v;
 }
 
-inline
-void _63_Union__6__::set_dot11_Header(const dot11_Header& v) {
-    idx_ = 3;
-    value_ = v;
-}
+template <typename T> struct writer_traits;
 
-inline
-dot11_Unsupported _63_Union__6__::get_dot11_Unsupported() const {
-    if (idx_ != 4) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_Unsupported >(value_);
+template <typename W, typename T>
+inline void write(W& w, const T& v) {
+    writer_traits<T>::encode(w, v);
 }
 
-inline
-void _63_Union__6__::set_dot11_Unsupported(const dot11_Unsupported& v) {
-    idx_ = 4;
-    value_ = v;
-}
+template<> struct writer_traits<bool> {
+    template <typename W>
+    static void encode(W& w, bool v) { w.writeBoolean(v); }
+};
 
-inline
-dot11_ctrl_Ack _63_Union__6__::get_dot11_ctrl_Ack() const {
-    if (idx_ != 5) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_ctrl_Ack >(value_);
-}
+template<> struct writer_traits<int32_t> {
+    template <typename W>
+    static void encode(W& w, int32_t v) { w.writeInt(v); }
+};
 
-inline
-void _63_Union__6__::set_dot11_ctrl_Ack(const dot11_ctrl_Ack& v) {
-    idx_ = 5;
-    value_ = v;
-}
+template<> struct writer_traits<int64_t> {
+    template <typename W>
+    static void encode(W& w, int64_t v) { w.writeLong(v); }
+};
 
-inline
-dot11_ctrl_BlockAck _63_Union__6__::get_dot11_ctrl_BlockAck() const {
-    if (idx_ != 6) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_ctrl_BlockAck >(value_);
-}
+template<> struct writer_traits<float> {
+    template <typename W>
+    static void encode(W& w, float v) { w.writeFloat(v); }
+};
 
-inline
-void _63_Union__6__::set_dot11_ctrl_BlockAck(const dot11_ctrl_BlockAck& v) {
-    idx_ = 6;
-    value_ = v;
-}
+template<> struct writer_traits<double> {
+    template <typename W>
+    static void encode(W& w, double v) { w.writeDouble(v); }
+};
 
-inline
-dot11_ctrl_BlockAckRequest _63_Union__6__::get_dot11_ctrl_BlockAckRequest() const {
-    if (idx_ != 7) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_ctrl_BlockAckRequest >(value_);
-}
+template<> struct writer_traits<std::string> {
+    template <typename W>
+    static void encode(W& w, const std::string& v) { w.writeString(v); }
+};
 
-inline
-void _63_Union__6__::set_dot11_ctrl_BlockAckRequest(const dot11_ctrl_BlockAckRequest& v) {
-    idx_ = 7;
-    value_ = v;
-}
+template<> struct writer_traits<std::vector<uint8_t> > {
+    template <typename W>
+    static void encode(W& w, const std::vector<uint8_t>& v) {
+        w.writeBytes(v.data(), v.size());
+    }
+};
 
-inline
-dot11_ctrl_CfEnd _63_Union__6__::get_dot11_ctrl_CfEnd() const {
-    if (idx_ != 8) {
-        throw avro::Exception("Invalid type for union");
+template <size_t N> struct writer_traits<boost::array<uint8_t, N> > {
+    template <typename W>
+    static void encode(W& w, const boost::array<uint8_t, N>& v) {
+        w.template writeFixed<N>(v.data());
     }
-    return boost::any_cast<dot11_ctrl_CfEnd >(value_);
-}
+};
 
-inline
-void _63_Union__6__::set_dot11_ctrl_CfEnd(const dot11_ctrl_CfEnd& v) {
-    idx_ = 8;
-    value_ = v;
-}
+template <typename T> struct writer_traits<std::vector<T> > {
+    template <typename W>
+    static void encode(W& w, const std::vector<T>& v) {
+        w.writeArrayStart(v.size());
+        for (size_t i = 0; i < v.size(); i++) {
+            write(w, v[i]);
+        }
+        w.writeArrayEnd();
+    }
+};
 
-inline
-dot11_ctrl_EndCfAck _63_Union__6__::get_dot11_ctrl_EndCfAck() const {
-    if (idx_ != 9) {
-        throw avro::Exception("Invalid type for union");
+// Maps are written in a single block, same as arrays.
+template <typename T> struct writer_traits<std::map<std::string, T> > {
+    template <typename W>
+    static void encode(W& w, const std::map<std::string, T>& v) {
+        w.writeArrayStart(v.size());
+        typename std::map<std::string, T>::const_iterator it;
+        for (it = v.begin(); it != v.end(); ++it) {
+            w.writeString(it->first);
+            write(w, it->second);
+        }
+        w.writeArrayEnd();
     }
-    return boost::any_cast<dot11_ctrl_EndCfAck >(value_);
-}
+};
 
-inline
-void _63_Union__6__::set_dot11_ctrl_EndCfAck(const dot11_ctrl_EndCfAck& v) {
-    idx_ = 9;
-    value_ = v;
-}
+template<> struct writer_traits<Unsupported> {
+    template <typename W>
+    static void encode(W& w, const Unsupported& v) {
+        write(w, v.name);
+    }
+};
 
-inline
-dot11_ctrl_PsPoll _63_Union__6__::get_dot11_ctrl_PsPoll() const {
-    if (idx_ != 10) {
-        throw avro::Exception("Invalid type for union");
+template<> struct writer_traits<Ethernet2> {
+    template <typename W>
+    static void encode(W& w, const Ethernet2& v) {
+        write(w, v.srcAddr);
+        write(w, v.dstAddr);
+        write(w, v.payloadType);
+        write(w, v.data);
     }
-    return boost::any_cast<dot11_ctrl_PsPoll >(value_);
-}
+};
 
-inline
-void _63_Union__6__::set_dot11_ctrl_PsPoll(const dot11_ctrl_PsPoll& v) {
-    idx_ = 10;
-    value_ = v;
-}
+template<> struct writer_traits<dot11_Header> {
+    template <typename W>
+    static void encode(W& w, const dot11_Header& v) {
+        write(w, v.toDs);
+        write(w, v.fromDs);
+        write(w, v.moreFrag);
+        write(w, v.retry);
+        write(w, v.powerMgmt);
+        write(w, v.wep);
+        write(w, v.order);
+        write(w, v.durationId);
+        write(w, v.addr1);
+    }
+};
 
-inline
-dot11_ctrl_Rts _63_Union__6__::get_dot11_ctrl_Rts() const {
-    if (idx_ != 11) {
-        throw avro::Exception("Invalid type for union");
+template<> struct writer_traits<dot11_Unsupported> {
+    template <typename W>
+    static void encode(W& w, const dot11_Unsupported& v) {
+        write(w, v.header);
+        write(w, v.type);
+        write(w, v.subtype);
     }
-    return boost::any_cast<dot11_ctrl_Rts >(value_);
-}
+};
 
-inline
-void _63_Union__6__::set_dot11_ctrl_Rts(const dot11_ctrl_Rts& v) {
-    idx_ = 11;
-    value_ = v;
-}
+template<> struct writer_traits<dot11_ctrl_Ack> {
+    template <typename W>
+    static void encode(W& w, const dot11_ctrl_Ack& v) {
+        write(w, v.header);
+    }
+};
 
-inline
-dot11_data_Header _63_Union__6__::get_dot11_data_Header() const {
-    if (idx_ != 12) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_data_Header >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_data_Header(const dot11_data_Header& v) {
-    idx_ = 12;
-    value_ = v;
-}
-
-inline
-dot11_data_Data _63_Union__6__::get_dot11_data_Data() const {
-    if (idx_ != 13) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_data_Data >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_data_Data(const dot11_data_Data& v) {
-    idx_ = 13;
-    value_ = v;
-}
-
-inline
-dot11_data_QosData _63_Union__6__::get_dot11_data_QosData() const {
-    if (idx_ != 14) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_data_QosData >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_data_QosData(const dot11_data_QosData& v) {
-    idx_ = 14;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_Capability _63_Union__6__::get_dot11_mgmt_Capability() const {
-    if (idx_ != 15) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_Capability >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_Capability(const dot11_mgmt_Capability& v) {
-    idx_ = 15;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_Header _63_Union__6__::get_dot11_mgmt_Header() const {
-    if (idx_ != 16) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_Header >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_Header(const dot11_mgmt_Header& v) {
-    idx_ = 16;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_AssocRequest _63_Union__6__::get_dot11_mgmt_AssocRequest() const {
-    if (idx_ != 17) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_AssocRequest >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_AssocRequest(const dot11_mgmt_AssocRequest& v) {
-    idx_ = 17;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_AssocResponse _63_Union__6__::get_dot11_mgmt_AssocResponse() const {
-    if (idx_ != 18) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_AssocResponse >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_AssocResponse(const dot11_mgmt_AssocResponse& v) {
-    idx_ = 18;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_Authentication _63_Union__6__::get_dot11_mgmt_Authentication() const {
-    if (idx_ != 19) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_Authentication >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_Authentication(const dot11_mgmt_Authentication& v) {
-    idx_ = 19;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_Beacon _63_Union__6__::get_dot11_mgmt_Beacon() const {
-    if (idx_ != 20) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_Beacon >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_Beacon(const dot11_mgmt_Beacon& v) {
-    idx_ = 20;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_Deauthentication _63_Union__6__::get_dot11_mgmt_Deauthentication() const {
-    if (idx_ != 21) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_Deauthentication >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_Deauthentication(const dot11_mgmt_Deauthentication& v) {
-    idx_ = 21;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_Disassoc _63_Union__6__::get_dot11_mgmt_Disassoc() const {
-    if (idx_ != 22) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_Disassoc >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_Disassoc(const dot11_mgmt_Disassoc& v) {
-    idx_ = 22;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_ProbeRequest _63_Union__6__::get_dot11_mgmt_ProbeRequest() const {
-    if (idx_ != 23) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_ProbeRequest >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_ProbeRequest(const dot11_mgmt_ProbeRequest& v) {
-    idx_ = 23;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_ProbeResponse _63_Union__6__::get_dot11_mgmt_ProbeResponse() const {
-    if (idx_ != 24) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_ProbeResponse >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_ProbeResponse(const dot11_mgmt_ProbeResponse& v) {
-    idx_ = 24;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_ReassocRequest _63_Union__6__::get_dot11_mgmt_ReassocRequest() const {
-    if (idx_ != 25) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_ReassocRequest >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_ReassocRequest(const dot11_mgmt_ReassocRequest& v) {
-    idx_ = 25;
-    value_ = v;
-}
-
-inline
-dot11_mgmt_ReassocResponse _63_Union__6__::get_dot11_mgmt_ReassocResponse() const {
-    if (idx_ != 26) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<dot11_mgmt_ReassocResponse >(value_);
-}
-
-inline
-void _63_Union__6__::set_dot11_mgmt_ReassocResponse(const dot11_mgmt_ReassocResponse& v) {
-    idx_ = 26;
-    value_ = v;
-}
-
-inline
-radiotap_Flag _63_Union__6__::get_radiotap_Flag() const {
-    if (idx_ != 27) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<radiotap_Flag >(value_);
-}
-
-inline
-void _63_Union__6__::set_radiotap_Flag(const radiotap_Flag& v) {
-    idx_ = 27;
-    value_ = v;
-}
-
-inline
-radiotap_ChannelType _63_Union__6__::get_radiotap_ChannelType() const {
-    if (idx_ != 28) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<radiotap_ChannelType >(value_);
-}
-
-inline
-void _63_Union__6__::set_radiotap_ChannelType(const radiotap_ChannelType& v) {
-    idx_ = 28;
-    value_ = v;
-}
-
-inline
-radiotap_Channel _63_Union__6__::get_radiotap_Channel() const {
-    if (idx_ != 29) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<radiotap_Channel >(value_);
-}
-
-inline
-void _63_Union__6__::set_radiotap_Channel(const radiotap_Channel& v) {
-    idx_ = 29;
-    value_ = v;
-}
-
-inline
-Radiotap _63_Union__6__::get_Radiotap() const {
-    if (idx_ != 30) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<Radiotap >(value_);
-}
-
-inline
-void _63_Union__6__::set_Radiotap(const Radiotap& v) {
-    idx_ = 30;
-    value_ = v;
-}
-
-inline
-Pdu _63_Union__6__::get_Pdu() const {
-    if (idx_ != 31) {
-        throw avro::Exception("Invalid type for union");
-    }
-    return boost::any_cast<Pdu >(value_);
-}
-
-inline
-void _63_Union__6__::set_Pdu(const Pdu& v) {
-    idx_ = 31;
-    value_ = v;
-}
-
-inline _63_Union__0__::_63_Union__0__() : idx_(0) { }
-inline _63_Union__1__::_63_Union__1__() : idx_(0) { }
-inline _63_Union__2__::_63_Union__2__() : idx_(0) { }
-inline _63_Union__3__::_63_Union__3__() : idx_(0) { }
-inline _63_Union__4__::_63_Union__4__() : idx_(0) { }
-inline _63_Union__5__::_63_Union__5__() : idx_(0), value_(Unsupported()) { }
-inline _63_Union__6__::_63_Union__6__() : idx_(0), value_(Unsupported()) { }
-}
-namespace avro {
-template<> struct codec_traits<Layer2::Unsupported> {
-    static void encode(Encoder& e, const Layer2::Unsupported& v) {
-        avro::encode(e, v.name);
-    }
-    static void decode(Decoder& d, Layer2::Unsupported& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.name);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.name);
-        }
+template<> struct writer_traits<dot11_ctrl_BlockAck> {
+    template <typename W>
+    static void encode(W& w, const dot11_ctrl_BlockAck& v) {
+        write(w, v.header);
+        write(w, v.barControl);
+        write(w, v.startSeq);
+        write(w, v.fragNum);
     }
 };
 
-template<> struct codec_traits<Layer2::Ethernet2> {
-    static void encode(Encoder& e, const Layer2::Ethernet2& v) {
-        avro::encode(e, v.srcAddr);
-        avro::encode(e, v.dstAddr);
-        avro::encode(e, v.payloadType);
-        avro::encode(e, v.data);
-    }
-    static void decode(Decoder& d, Layer2::Ethernet2& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.srcAddr);
-                    break;
-                case 1:
-                    avro::decode(d, v.dstAddr);
-                    break;
-                case 2:
-                    avro::decode(d, v.payloadType);
-                    break;
-                case 3:
-                    avro::decode(d, v.data);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.srcAddr);
-            avro::decode(d, v.dstAddr);
-            avro::decode(d, v.payloadType);
-            avro::decode(d, v.data);
-        }
+template<> struct writer_traits<dot11_ctrl_BlockAckRequest> {
+    template <typename W>
+    static void encode(W& w, const dot11_ctrl_BlockAckRequest& v) {
+        write(w, v.header);
+        write(w, v.barControl);
+        write(w, v.startSeq);
+        write(w, v.fragNum);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_Header> {
-    static void encode(Encoder& e, const Layer2::dot11_Header& v) {
-        avro::encode(e, v.toDs);
-        avro::encode(e, v.fromDs);
-        avro::encode(e, v.moreFrag);
-        avro::encode(e, v.retry);
-        avro::encode(e, v.powerMgmt);
-        avro::encode(e, v.wep);
-        avro::encode(e, v.order);
-        avro::encode(e, v.durationId);
-        avro::encode(e, v.addr1);
-    }
-    static void decode(Decoder& d, Layer2::dot11_Header& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.toDs);
-                    break;
-                case 1:
-                    avro::decode(d, v.fromDs);
-                    break;
-                case 2:
-                    avro::decode(d, v.moreFrag);
-                    break;
-                case 3:
-                    avro::decode(d, v.retry);
-                    break;
-                case 4:
-                    avro::decode(d, v.powerMgmt);
-                    break;
-                case 5:
-                    avro::decode(d, v.wep);
-                    break;
-                case 6:
-                    avro::decode(d, v.order);
-                    break;
-                case 7:
-                    avro::decode(d, v.durationId);
-                    break;
-                case 8:
-                    avro::decode(d, v.addr1);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.toDs);
-            avro::decode(d, v.fromDs);
-            avro::decode(d, v.moreFrag);
-            avro::decode(d, v.retry);
-            avro::decode(d, v.powerMgmt);
-            avro::decode(d, v.wep);
-            avro::decode(d, v.order);
-            avro::decode(d, v.durationId);
-            avro::decode(d, v.addr1);
-        }
+template<> struct writer_traits<dot11_ctrl_CfEnd> {
+    template <typename W>
+    static void encode(W& w, const dot11_ctrl_CfEnd& v) {
+        write(w, v.header);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_Unsupported> {
-    static void encode(Encoder& e, const Layer2::dot11_Unsupported& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.type);
-        avro::encode(e, v.subtype);
-    }
-    static void decode(Decoder& d, Layer2::dot11_Unsupported& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.type);
-                    break;
-                case 2:
-                    avro::decode(d, v.subtype);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.type);
-            avro::decode(d, v.subtype);
-        }
+template<> struct writer_traits<dot11_ctrl_EndCfAck> {
+    template <typename W>
+    static void encode(W& w, const dot11_ctrl_EndCfAck& v) {
+        write(w, v.header);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_ctrl_Ack> {
-    static void encode(Encoder& e, const Layer2::dot11_ctrl_Ack& v) {
-        avro::encode(e, v.header);
-    }
-    static void decode(Decoder& d, Layer2::dot11_ctrl_Ack& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-        }
+template<> struct writer_traits<dot11_ctrl_PsPoll> {
+    template <typename W>
+    static void encode(W& w, const dot11_ctrl_PsPoll& v) {
+        write(w, v.header);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_ctrl_BlockAck> {
-    static void encode(Encoder& e, const Layer2::dot11_ctrl_BlockAck& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.barControl);
-        avro::encode(e, v.startSeq);
-        avro::encode(e, v.fragNum);
-    }
-    static void decode(Decoder& d, Layer2::dot11_ctrl_BlockAck& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.barControl);
-                    break;
-                case 2:
-                    avro::decode(d, v.startSeq);
-                    break;
-                case 3:
-                    avro::decode(d, v.fragNum);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.barControl);
-            avro::decode(d, v.startSeq);
-            avro::decode(d, v.fragNum);
-        }
+template<> struct writer_traits<dot11_ctrl_Rts> {
+    template <typename W>
+    static void encode(W& w, const dot11_ctrl_Rts& v) {
+        write(w, v.header);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_ctrl_BlockAckRequest> {
-    static void encode(Encoder& e, const Layer2::dot11_ctrl_BlockAckRequest& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.barControl);
-        avro::encode(e, v.startSeq);
-        avro::encode(e, v.fragNum);
-    }
-    static void decode(Decoder& d, Layer2::dot11_ctrl_BlockAckRequest& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.barControl);
-                    break;
-                case 2:
-                    avro::decode(d, v.startSeq);
-                    break;
-                case 3:
-                    avro::decode(d, v.fragNum);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.barControl);
-            avro::decode(d, v.startSeq);
-            avro::decode(d, v.fragNum);
-        }
+template<> struct writer_traits<dot11_data_Header> {
+    template <typename W>
+    static void encode(W& w, const dot11_data_Header& v) {
+        write(w, v.addr2);
+        write(w, v.addr3);
+        write(w, v.addr4);
+        write(w, v.fragNum);
+        write(w, v.seqNum);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_ctrl_CfEnd> {
-    static void encode(Encoder& e, const Layer2::dot11_ctrl_CfEnd& v) {
-        avro::encode(e, v.header);
-    }
-    static void decode(Decoder& d, Layer2::dot11_ctrl_CfEnd& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-        }
+template<> struct writer_traits<dot11_data_Data> {
+    template <typename W>
+    static void encode(W& w, const dot11_data_Data& v) {
+        write(w, v.header);
+        write(w, v.dataHeader);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_ctrl_EndCfAck> {
-    static void encode(Encoder& e, const Layer2::dot11_ctrl_EndCfAck& v) {
-        avro::encode(e, v.header);
-    }
-    static void decode(Decoder& d, Layer2::dot11_ctrl_EndCfAck& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-        }
+template<> struct writer_traits<dot11_data_QosData> {
+    template <typename W>
+    static void encode(W& w, const dot11_data_QosData& v) {
+        write(w, v.header);
+        write(w, v.dataHeader);
+        write(w, v.qosControl);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_ctrl_PsPoll> {
-    static void encode(Encoder& e, const Layer2::dot11_ctrl_PsPoll& v) {
-        avro::encode(e, v.header);
-    }
-    static void decode(Decoder& d, Layer2::dot11_ctrl_PsPoll& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-        }
+template<> struct writer_traits<dot11_mgmt_Capability> {
+    template <typename W>
+    static void encode(W& w, dot11_mgmt_Capability v) {
+        w.writeEnum(v);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_ctrl_Rts> {
-    static void encode(Encoder& e, const Layer2::dot11_ctrl_Rts& v) {
-        avro::encode(e, v.header);
-    }
-    static void decode(Decoder& d, Layer2::dot11_ctrl_Rts& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-        }
+template<> struct writer_traits<dot11_mgmt_Header> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_Header& v) {
+        write(w, v.addr2);
+        write(w, v.addr3);
+        write(w, v.addr4);
+        write(w, v.fragNum);
+        write(w, v.seqNum);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_data_Header> {
-    static void encode(Encoder& e, const Layer2::dot11_data_Header& v) {
-        avro::encode(e, v.addr2);
-        avro::encode(e, v.addr3);
-        avro::encode(e, v.addr4);
-        avro::encode(e, v.fragNum);
-        avro::encode(e, v.seqNum);
-    }
-    static void decode(Decoder& d, Layer2::dot11_data_Header& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.addr2);
-                    break;
-                case 1:
-                    avro::decode(d, v.addr3);
-                    break;
-                case 2:
-                    avro::decode(d, v.addr4);
-                    break;
-                case 3:
-                    avro::decode(d, v.fragNum);
-                    break;
-                case 4:
-                    avro::decode(d, v.seqNum);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.addr2);
-            avro::decode(d, v.addr3);
-            avro::decode(d, v.addr4);
-            avro::decode(d, v.fragNum);
-            avro::decode(d, v.seqNum);
-        }
+template<> struct writer_traits<dot11_mgmt_AssocRequest> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_AssocRequest& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.capabilities);
+        write(w, v.listenInterval);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_data_Data> {
-    static void encode(Encoder& e, const Layer2::dot11_data_Data& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.dataHeader);
-    }
-    static void decode(Decoder& d, Layer2::dot11_data_Data& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.dataHeader);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.dataHeader);
-        }
+template<> struct writer_traits<dot11_mgmt_AssocResponse> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_AssocResponse& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.capabilities);
+        write(w, v.statusCode);
+        write(w, v.aid);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_data_QosData> {
-    static void encode(Encoder& e, const Layer2::dot11_data_QosData& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.dataHeader);
-        avro::encode(e, v.qosControl);
-    }
-    static void decode(Decoder& d, Layer2::dot11_data_QosData& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.dataHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.qosControl);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.dataHeader);
-            avro::decode(d, v.qosControl);
-        }
-    }
-};
-
-template<> struct codec_traits<Layer2::dot11_mgmt_Capability> {
-    static void encode(Encoder& e, Layer2::dot11_mgmt_Capability v) {
-		if (v < Layer2::ESS || v > Layer2::IMMEDIATE_BLOCK_ACK)
-		{
-			std::ostringstream error;
-			error << "enum value " << v << " is out of bound for Layer2::dot11_mgmt_Capability and cannot be encoded";
-			throw avro::Exception(error.str());
-		}
-        e.encodeEnum(v);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_Capability& v) {
-		size_t index = d.decodeEnum();
-		if (index < Layer2::ESS || index > Layer2::IMMEDIATE_BLOCK_ACK)
-		{
-			std::ostringstream error;
-			error << "enum value " << index << " is out of bound for Layer2::dot11_mgmt_Capability and cannot be decoded";
-			throw avro::Exception(error.str());
-		}
-        v = static_cast<Layer2::dot11_mgmt_Capability>(index);
-    }
-};
-
-template<> struct codec_traits<Layer2::dot11_mgmt_Header> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_Header& v) {
-        avro::encode(e, v.addr2);
-        avro::encode(e, v.addr3);
-        avro::encode(e, v.addr4);
-        avro::encode(e, v.fragNum);
-        avro::encode(e, v.seqNum);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_Header& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.addr2);
-                    break;
-                case 1:
-                    avro::decode(d, v.addr3);
-                    break;
-                case 2:
-                    avro::decode(d, v.addr4);
-                    break;
-                case 3:
-                    avro::decode(d, v.fragNum);
-                    break;
-                case 4:
-                    avro::decode(d, v.seqNum);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.addr2);
-            avro::decode(d, v.addr3);
-            avro::decode(d, v.addr4);
-            avro::decode(d, v.fragNum);
-            avro::decode(d, v.seqNum);
-        }
+template<> struct writer_traits<dot11_mgmt_Authentication> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_Authentication& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.authAlgorithm);
+        write(w, v.authSeqNumber);
+        write(w, v.statusCode);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_AssocRequest> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_AssocRequest& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.capabilities);
-        avro::encode(e, v.listenInterval);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_AssocRequest& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.capabilities);
-                    break;
-                case 3:
-                    avro::decode(d, v.listenInterval);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.capabilities);
-            avro::decode(d, v.listenInterval);
-        }
-    }
-};
-
-template<> struct codec_traits<Layer2::dot11_mgmt_AssocResponse> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_AssocResponse& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.capabilities);
-        avro::encode(e, v.statusCode);
-        avro::encode(e, v.aid);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_AssocResponse& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.capabilities);
-                    break;
-                case 3:
-                    avro::decode(d, v.statusCode);
-                    break;
-                case 4:
-                    avro::decode(d, v.aid);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.capabilities);
-            avro::decode(d, v.statusCode);
-            avro::decode(d, v.aid);
-        }
+template<> struct writer_traits<dot11_mgmt_Beacon> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_Beacon& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.timestamp);
+        write(w, v.interval);
+        write(w, v.capabilities);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_Authentication> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_Authentication& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.authAlgorithm);
-        avro::encode(e, v.authSeqNumber);
-        avro::encode(e, v.statusCode);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_Authentication& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.authAlgorithm);
-                    break;
-                case 3:
-                    avro::decode(d, v.authSeqNumber);
-                    break;
-                case 4:
-                    avro::decode(d, v.statusCode);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.authAlgorithm);
-            avro::decode(d, v.authSeqNumber);
-            avro::decode(d, v.statusCode);
-        }
+template<> struct writer_traits<dot11_mgmt_Deauthentication> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_Deauthentication& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.reasonCode);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_Beacon> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_Beacon& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.timestamp);
-        avro::encode(e, v.interval);
-        avro::encode(e, v.capabilities);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_Beacon& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.timestamp);
-                    break;
-                case 3:
-                    avro::decode(d, v.interval);
-                    break;
-                case 4:
-                    avro::decode(d, v.capabilities);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.timestamp);
-            avro::decode(d, v.interval);
-            avro::decode(d, v.capabilities);
-        }
+template<> struct writer_traits<dot11_mgmt_Disassoc> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_Disassoc& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.reasonCode);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_Deauthentication> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_Deauthentication& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.reasonCode);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_Deauthentication& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.reasonCode);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.reasonCode);
-        }
+template<> struct writer_traits<dot11_mgmt_ProbeRequest> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_ProbeRequest& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_Disassoc> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_Disassoc& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.reasonCode);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_Disassoc& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.reasonCode);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.reasonCode);
-        }
+template<> struct writer_traits<dot11_mgmt_ProbeResponse> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_ProbeResponse& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.timestamp);
+        write(w, v.interval);
+        write(w, v.capabilities);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_ProbeRequest> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_ProbeRequest& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_ProbeRequest& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-        }
+template<> struct writer_traits<dot11_mgmt_ReassocRequest> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_ReassocRequest& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.capabilities);
+        write(w, v.listenInterval);
+        write(w, v.currentAp);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_ProbeResponse> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_ProbeResponse& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.timestamp);
-        avro::encode(e, v.interval);
-        avro::encode(e, v.capabilities);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_ProbeResponse& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.timestamp);
-                    break;
-                case 3:
-                    avro::decode(d, v.interval);
-                    break;
-                case 4:
-                    avro::decode(d, v.capabilities);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.timestamp);
-            avro::decode(d, v.interval);
-            avro::decode(d, v.capabilities);
-        }
+template<> struct writer_traits<dot11_mgmt_ReassocResponse> {
+    template <typename W>
+    static void encode(W& w, const dot11_mgmt_ReassocResponse& v) {
+        write(w, v.header);
+        write(w, v.mgmtHeader);
+        write(w, v.capabilities);
+        write(w, v.statusCode);
+        write(w, v.aid);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_ReassocRequest> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_ReassocRequest& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.capabilities);
-        avro::encode(e, v.listenInterval);
-        avro::encode(e, v.currentAp);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_ReassocRequest& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.capabilities);
-                    break;
-                case 3:
-                    avro::decode(d, v.listenInterval);
-                    break;
-                case 4:
-                    avro::decode(d, v.currentAp);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.capabilities);
-            avro::decode(d, v.listenInterval);
-            avro::decode(d, v.currentAp);
-        }
+template<> struct writer_traits<radiotap_Flag> {
+    template <typename W>
+    static void encode(W& w, radiotap_Flag v) {
+        w.writeEnum(v);
     }
 };
 
-template<> struct codec_traits<Layer2::dot11_mgmt_ReassocResponse> {
-    static void encode(Encoder& e, const Layer2::dot11_mgmt_ReassocResponse& v) {
-        avro::encode(e, v.header);
-        avro::encode(e, v.mgmtHeader);
-        avro::encode(e, v.capabilities);
-        avro::encode(e, v.statusCode);
-        avro::encode(e, v.aid);
-    }
-    static void decode(Decoder& d, Layer2::dot11_mgmt_ReassocResponse& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.header);
-                    break;
-                case 1:
-                    avro::decode(d, v.mgmtHeader);
-                    break;
-                case 2:
-                    avro::decode(d, v.capabilities);
-                    break;
-                case 3:
-                    avro::decode(d, v.statusCode);
-                    break;
-                case 4:
-                    avro::decode(d, v.aid);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.header);
-            avro::decode(d, v.mgmtHeader);
-            avro::decode(d, v.capabilities);
-            avro::decode(d, v.statusCode);
-            avro::decode(d, v.aid);
-        }
+template<> struct writer_traits<radiotap_ChannelType> {
+    template <typename W>
+    static void encode(W& w, radiotap_ChannelType v) {
+        w.writeEnum(v);
     }
 };
 
-template<> struct codec_traits<Layer2::radiotap_Flag> {
-    static void encode(Encoder& e, Layer2::radiotap_Flag v) {
-		if (v < Layer2::CFP || v > Layer2::SHORT_GI)
-		{
-			std::ostringstream error;
-			error << "enum value " << v << " is out of bound for Layer2::radiotap_Flag and cannot be encoded";
-			throw avro::Exception(error.str());
-		}
-        e.encodeEnum(v);
-    }
-    static void decode(Decoder& d, Layer2::radiotap_Flag& v) {
-		size_t index = d.decodeEnum();
-		if (index < Layer2::CFP || index > Layer2::SHORT_GI)
-		{
-			std::ostringstream error;
-			error << "enum value " << index << " is out of bound for Layer2::radiotap_Flag and cannot be decoded";
-			throw avro::Exception(error.str());
-		}
-        v = static_cast<Layer2::radiotap_Flag>(index);
-    }
-};
-
-template<> struct codec_traits<Layer2::radiotap_ChannelType> {
-    static void encode(Encoder& e, Layer2::radiotap_ChannelType v) {
-		if (v < Layer2::TURBO || v > Layer2::GFSK)
-		{
-			std::ostringstream error;
-			error << "enum value " << v << " is out of bound for Layer2::radiotap_ChannelType and cannot be encoded";
-			throw avro::Exception(error.str());
-		}
-        e.encodeEnum(v);
-    }
-    static void decode(Decoder& d, Layer2::radiotap_ChannelType& v) {
-		size_t index = d.decodeEnum();
-		if (index < Layer2::TURBO || index > Layer2::GFSK)
-		{
-			std::ostringstream error;
-			error << "enum value " << index << " is out of bound for Layer2::radiotap_ChannelType and cannot be decoded";
-			throw avro::Exception(error.str());
-		}
-        v = static_cast<Layer2::radiotap_ChannelType>(index);
-    }
-};
-
-template<> struct codec_traits<Layer2::radiotap_Channel> {
-    static void encode(Encoder& e, const Layer2::radiotap_Channel& v) {
-        avro::encode(e, v.freq);
-        avro::encode(e, v.type);
-    }
-    static void decode(Decoder& d, Layer2::radiotap_Channel& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.freq);
-                    break;
-                case 1:
-                    avro::decode(d, v.type);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.freq);
-            avro::decode(d, v.type);
-        }
+template<> struct writer_traits<radiotap_Channel> {
+    template <typename W>
+    static void encode(W& w, const radiotap_Channel& v) {
+        write(w, v.freq);
+        write(w, v.type);
     }
 };
 
-template<> struct codec_traits<Layer2::_63_Union__0__> {
-    static void encode(Encoder& e, Layer2::_63_Union__0__ v) {
-        e.encodeUnionIndex(v.idx());
+template<> struct writer_traits<Radiotap_tsft_Union> {
+    template <typename W>
+    static void encode(W& w, const Radiotap_tsft_Union& v) {
+        w.writeUnionIndex(v.idx());
         switch (v.idx()) {
-        case 0:
-            e.encodeNull();
-            break;
-        case 1:
-            avro::encode(e, v.get_long());
-            break;
-        }
-    }
-    static void decode(Decoder& d, Layer2::_63_Union__0__& v) {
-        size_t n = d.decodeUnionIndex();
-        if (n >= 2) { throw avro::Exception("Union index too big"); }
-        switch (n) {
-        case 0:
-            d.decodeNull();
-            v.set_null();
-            break;
-        case 1:
-            {
-                int64_t vv;
-                avro::decode(d, vv);
-                v.set_long(vv);
-            }
+        case Radiotap_tsft_Union::long_index:
+            write(w, v.get_long());
             break;
         }
     }
 };
 
-template<> struct codec_traits<Layer2::_63_Union__1__> {
-    static void encode(Encoder& e, Layer2::_63_Union__1__ v) {
-        e.encodeUnionIndex(v.idx());
+template<> struct writer_traits<Radiotap_flags_Union> {
+    template <typename W>
+    static void encode(W& w, const Radiotap_flags_Union& v) {
+        w.writeUnionIndex(v.idx());
         switch (v.idx()) {
-        case 0:
-            e.encodeNull();
-            break;
-        case 1:
-            avro::encode(e, v.get_array());
-            break;
-        }
-    }
-    static void decode(Decoder& d, Layer2::_63_Union__1__& v) {
-        size_t n = d.decodeUnionIndex();
-        if (n >= 2) { throw avro::Exception("Union index too big"); }
-        switch (n) {
-        case 0:
-            d.decodeNull();
-            v.set_null();
-            break;
-        case 1:
-            {
-                std::vector<Layer2::radiotap_Flag > vv;
-                avro::decode(d, vv);
-                v.set_array(vv);
-            }
+        case Radiotap_flags_Union::array_index:
+            write(w, v.get_array());
             break;
         }
     }
 };
 
-template<> struct codec_traits<Layer2::_63_Union__2__> {
-    static void encode(Encoder& e, Layer2::_63_Union__2__ v) {
-        e.encodeUnionIndex(v.idx());
+template<> struct writer_traits<Radiotap_rate_Union> {
+    template <typename W>
+    static void encode(W& w, const Radiotap_rate_Union& v) {
+        w.writeUnionIndex(v.idx());
         switch (v.idx()) {
-        case 0:
-            e.encodeNull();
-            break;
-        case 1:
-            avro::encode(e, v.get_int());
-            break;
-        }
-    }
-    static void decode(Decoder& d, Layer2::_63_Union__2__& v) {
-        size_t n = d.decodeUnionIndex();
-        if (n >= 2) { throw avro::Exception("Union index too big"); }
-        switch (n) {
-        case 0:
-            d.decodeNull();
-            v.set_null();
-            break;
-        case 1:
-            {
-                int32_t vv;
-                avro::decode(d, vv);
-                v.set_int(vv);
-            }
+        case Radiotap_rate_Union::int_index:
+            write(w, v.get_int());
             break;
         }
     }
 };
 
-template<> struct codec_traits<Layer2::_63_Union__3__> {
-    static void encode(Encoder& e, Layer2::_63_Union__3__ v) {
-        e.encodeUnionIndex(v.idx());
+template<> struct writer_traits<Radiotap_channel_Union> {
+    template <typename W>
+    static void encode(W& w, const Radiotap_channel_Union& v) {
+        w.writeUnionIndex(v.idx());
         switch (v.idx()) {
-        case 0:
-            e.encodeNull();
-            break;
-        case 1:
-            avro::encode(e, v.get_radiotap_Channel());
-            break;
-        }
-    }
-    static void decode(Decoder& d, Layer2::_63_Union__3__& v) {
-        size_t n = d.decodeUnionIndex();
-        if (n >= 2) { throw avro::Exception("Union index too big"); }
-        switch (n) {
-        case 0:
-            d.decodeNull();
-            v.set_null();
-            break;
-        case 1:
-            {
-                Layer2::radiotap_Channel vv;
-                avro::decode(d, vv);
-                v.set_radiotap_Channel(vv);
-            }
+        case Radiotap_channel_Union::radiotap_Channel_index:
+            write(w, v.get_radiotap_Channel());
             break;
         }
     }
 };
 
-template<> struct codec_traits<Layer2::_63_Union__4__> {
-    static void encode(Encoder& e, Layer2::_63_Union__4__ v) {
-        e.encodeUnionIndex(v.idx());
+template<> struct writer_traits<Radiotap_frame_Union> {
+    template <typename W>
+    static void encode(W& w, const Radiotap_frame_Union& v) {
+        w.writeUnionIndex(v.idx());
         switch (v.idx()) {
-        case 0:
-            e.encodeNull();
+        case Radiotap_frame_Union::Unsupported_index:
+            write(w, v.get_Unsupported());
             break;
-        case 1:
-            avro::encode(e, v.get_Unsupported());
+        case Radiotap_frame_Union::dot11_Unsupported_index:
+            write(w, v.get_dot11_Unsupported());
             break;
-        case 2:
-            avro::encode(e, v.get_dot11_Unsupported());
+        case Radiotap_frame_Union::dot11_ctrl_Ack_index:
+            write(w, v.get_dot11_ctrl_Ack());
             break;
-        case 3:
-            avro::encode(e, v.get_dot11_ctrl_Ack());
+        case Radiotap_frame_Union::dot11_ctrl_BlockAck_index:
+            write(w, v.get_dot11_ctrl_BlockAck());
             break;
-        case 4:
-            avro::encode(e, v.get_dot11_ctrl_BlockAck());
+        case Radiotap_frame_Union::dot11_ctrl_BlockAckRequest_index:
+            write(w, v.get_dot11_ctrl_BlockAckRequest());
             break;
-        case 5:
-            avro::encode(e, v.get_dot11_ctrl_BlockAckRequest());
+        case Radiotap_frame_Union::dot11_ctrl_CfEnd_index:
+            write(w, v.get_dot11_ctrl_CfEnd());
             break;
-        case 6:
-            avro::encode(e, v.get_dot11_ctrl_CfEnd());
+        case Radiotap_frame_Union::dot11_ctrl_EndCfAck_index:
+            write(w, v.get_dot11_ctrl_EndCfAck());
             break;
-        case 7:
-            avro::encode(e, v.get_dot11_ctrl_EndCfAck());
+        case Radiotap_frame_Union::dot11_ctrl_PsPoll_index:
+            write(w, v.get_dot11_ctrl_PsPoll());
             break;
-        case 8:
-            avro::encode(e, v.get_dot11_ctrl_PsPoll());
+        case Radiotap_frame_Union::dot11_ctrl_Rts_index:
+            write(w, v.get_dot11_ctrl_Rts());
             break;
-        case 9:
-            avro::encode(e, v.get_dot11_ctrl_Rts());
+        case Radiotap_frame_Union::dot11_data_Data_index:
+            write(w, v.get_dot11_data_Data());
             break;
-        case 10:
-            avro::encode(e, v.get_dot11_data_Data());
+        case Radiotap_frame_Union::dot11_data_QosData_index:
+            write(w, v.get_dot11_data_QosData());
             break;
-        case 11:
-            avro::encode(e, v.get_dot11_data_QosData());
+        case Radiotap_frame_Union::dot11_mgmt_AssocRequest_index:
+            write(w, v.get_dot11_mgmt_AssocRequest());
             break;
-        case 12:
-            avro::encode(e, v.get_dot11_mgmt_AssocRequest());
+        case Radiotap_frame_Union::dot11_mgmt_AssocResponse_index:
+            write(w, v.get_dot11_mgmt_AssocResponse());
             break;
-        case 13:
-            avro::encode(e, v.get_dot11_mgmt_AssocResponse());
+        case Radiotap_frame_Union::dot11_mgmt_Authentication_index:
+            write(w, v.get_dot11_mgmt_Authentication());
             break;
-        case 14:
-            avro::encode(e, v.get_dot11_mgmt_Authentication());
+        case Radiotap_frame_Union::dot11_mgmt_Beacon_index:
+            write(w, v.get_dot11_mgmt_Beacon());
             break;
-        case 15:
-            avro::encode(e, v.get_dot11_mgmt_Beacon());
+        case Radiotap_frame_Union::dot11_mgmt_Deauthentication_index:
+            write(w, v.get_dot11_mgmt_Deauthentication());
             break;
-        case 16:
-            avro::encode(e, v.get_dot11_mgmt_Deauthentication());
+        case Radiotap_frame_Union::dot11_mgmt_Disassoc_index:
+            write(w, v.get_dot11_mgmt_Disassoc());
             break;
-        case 17:
-            avro::encode(e, v.get_dot11_mgmt_Disassoc());
+        case Radiotap_frame_Union::dot11_mgmt_ProbeRequest_index:
+            write(w, v.get_dot11_mgmt_ProbeRequest());
             break;
-        case 18:
-            avro::encode(e, v.get_dot11_mgmt_ProbeRequest());
+        case Radiotap_frame_Union::dot11_mgmt_ProbeResponse_index:
+            write(w, v.get_dot11_mgmt_ProbeResponse());
             break;
-        case 19:
-            avro::encode(e, v.get_dot11_mgmt_ProbeResponse());
+        case Radiotap_frame_Union::dot11_mgmt_ReassocRequest_index:
+            write(w, v.get_dot11_mgmt_ReassocRequest());
             break;
-        case 20:
-            avro::encode(e, v.get_dot11_mgmt_ReassocRequest());
-            break;
-        case 21:
-            avro::encode(e, v.get_dot11_mgmt_ReassocResponse());
-            break;
-        }
-    }
-    static void decode(Decoder& d, Layer2::_63_Union__4__& v) {
-        size_t n = d.decodeUnionIndex();
-        if (n >= 22) { throw avro::Exception("Union index too big"); }
-        switch (n) {
-        case 0:
-            d.decodeNull();
-            v.set_null();
-            break;
-        case 1:
-            {
-                Layer2::Unsupported vv;
-                avro::decode(d, vv);
-                v.set_Unsupported(vv);
-            }
-            break;
-        case 2:
-            {
-                Layer2::dot11_Unsupported vv;
-                avro::decode(d, vv);
-                v.set_dot11_Unsupported(vv);
-            }
-            break;
-        case 3:
-            {
-                Layer2::dot11_ctrl_Ack vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_Ack(vv);
-            }
-            break;
-        case 4:
-            {
-                Layer2::dot11_ctrl_BlockAck vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_BlockAck(vv);
-            }
-            break;
-        case 5:
-            {
-                Layer2::dot11_ctrl_BlockAckRequest vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_BlockAckRequest(vv);
-            }
-            break;
-        case 6:
-            {
-                Layer2::dot11_ctrl_CfEnd vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_CfEnd(vv);
-            }
-            break;
-        case 7:
-            {
-                Layer2::dot11_ctrl_EndCfAck vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_EndCfAck(vv);
-            }
-            break;
-        case 8:
-            {
-                Layer2::dot11_ctrl_PsPoll vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_PsPoll(vv);
-            }
-            break;
-        case 9:
-            {
-                Layer2::dot11_ctrl_Rts vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_Rts(vv);
-            }
-            break;
-        case 10:
-            {
-                Layer2::dot11_data_Data vv;
-                avro::decode(d, vv);
-                v.set_dot11_data_Data(vv);
-            }
-            break;
-        case 11:
-            {
-                Layer2::dot11_data_QosData vv;
-                avro::decode(d, vv);
-                v.set_dot11_data_QosData(vv);
-            }
-            break;
-        case 12:
-            {
-                Layer2::dot11_mgmt_AssocRequest vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_AssocRequest(vv);
-            }
-            break;
-        case 13:
-            {
-                Layer2::dot11_mgmt_AssocResponse vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_AssocResponse(vv);
-            }
-            break;
-        case 14:
-            {
-                Layer2::dot11_mgmt_Authentication vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Authentication(vv);
-            }
-            break;
-        case 15:
-            {
-                Layer2::dot11_mgmt_Beacon vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Beacon(vv);
-            }
-            break;
-        case 16:
-            {
-                Layer2::dot11_mgmt_Deauthentication vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Deauthentication(vv);
-            }
-            break;
-        case 17:
-            {
-                Layer2::dot11_mgmt_Disassoc vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Disassoc(vv);
-            }
-            break;
-        case 18:
-            {
-                Layer2::dot11_mgmt_ProbeRequest vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_ProbeRequest(vv);
-            }
-            break;
-        case 19:
-            {
-                Layer2::dot11_mgmt_ProbeResponse vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_ProbeResponse(vv);
-            }
-            break;
-        case 20:
-            {
-                Layer2::dot11_mgmt_ReassocRequest vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_ReassocRequest(vv);
-            }
-            break;
-        case 21:
-            {
-                Layer2::dot11_mgmt_ReassocResponse vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_ReassocResponse(vv);
-            }
+        case Radiotap_frame_Union::dot11_mgmt_ReassocResponse_index:
+            write(w, v.get_dot11_mgmt_ReassocResponse());
             break;
         }
     }
 };
 
-template<> struct codec_traits<Layer2::Radiotap> {
-    static void encode(Encoder& e, const Layer2::Radiotap& v) {
-        avro::encode(e, v.tsft);
-        avro::encode(e, v.flags);
-        avro::encode(e, v.rate);
-        avro::encode(e, v.channel);
-        avro::encode(e, v.frame);
-    }
-    static void decode(Decoder& d, Layer2::Radiotap& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.tsft);
-                    break;
-                case 1:
-                    avro::decode(d, v.flags);
-                    break;
-                case 2:
-                    avro::decode(d, v.rate);
-                    break;
-                case 3:
-                    avro::decode(d, v.channel);
-                    break;
-                case 4:
-                    avro::decode(d, v.frame);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.tsft);
-            avro::decode(d, v.flags);
-            avro::decode(d, v.rate);
-            avro::decode(d, v.channel);
-            avro::decode(d, v.frame);
-        }
+template<> struct writer_traits<Radiotap> {
+    template <typename W>
+    static void encode(W& w, const Radiotap& v) {
+        write(w, v.tsft);
+        write(w, v.flags);
+        write(w, v.rate);
+        write(w, v.channel);
+        write(w, v.frame);
     }
 };
 
-template<> struct codec_traits<Layer2::_63_Union__5__> {
-    static void encode(Encoder& e, Layer2::_63_Union__5__ v) {
-        e.encodeUnionIndex(v.idx());
+template<> struct writer_traits<Pdu_frame_Union> {
+    template <typename W>
+    static void encode(W& w, const Pdu_frame_Union& v) {
+        w.writeUnionIndex(v.idx());
         switch (v.idx()) {
-        case 0:
-            avro::encode(e, v.get_Unsupported());
+        case Pdu_frame_Union::Unsupported_index:
+            write(w, v.get_Unsupported());
             break;
-        case 1:
-            avro::encode(e, v.get_Ethernet2());
+        case Pdu_frame_Union::Ethernet2_index:
+            write(w, v.get_Ethernet2());
             break;
-        case 2:
-            avro::encode(e, v.get_Radiotap());
-            break;
-        }
-    }
-    static void decode(Decoder& d, Layer2::_63_Union__5__& v) {
-        size_t n = d.decodeUnionIndex();
-        if (n >= 3) { throw avro::Exception("Union index too big"); }
-        switch (n) {
-        case 0:
-            {
-                Layer2::Unsupported vv;
-                avro::decode(d, vv);
-                v.set_Unsupported(vv);
-            }
-            break;
-        case 1:
-            {
-                Layer2::Ethernet2 vv;
-                avro::decode(d, vv);
-                v.set_Ethernet2(vv);
-            }
-            break;
-        case 2:
-            {
-                Layer2::Radiotap vv;
-                avro::decode(d, vv);
-                v.set_Radiotap(vv);
-            }
+        case Pdu_frame_Union::Radiotap_index:
+            write(w, v.get_Radiotap());
             break;
         }
     }
 };
 
-template<> struct codec_traits<Layer2::Pdu> {
-    static void encode(Encoder& e, const Layer2::Pdu& v) {
-        avro::encode(e, v.size);
-        avro::encode(e, v.timestamp);
-        avro::encode(e, v.frame);
-    }
-    static void decode(Decoder& d, Layer2::Pdu& v) {
-        if (avro::ResolvingDecoder *rd =
-            dynamic_cast<avro::ResolvingDecoder *>(&d)) {
-            const std::vector<size_t> fo = rd->fieldOrder();
-            for (std::vector<size_t>::const_iterator it = fo.begin();
-                it != fo.end(); ++it) {
-                switch (*it) {
-                case 0:
-                    avro::decode(d, v.size);
-                    break;
-                case 1:
-                    avro::decode(d, v.timestamp);
-                    break;
-                case 2:
-                    avro::decode(d, v.frame);
-                    break;
-                default:
-                    break;
-                }
-            }
-        } else {
-            avro::decode(d, v.size);
-            avro::decode(d, v.timestamp);
-            avro::decode(d, v.frame);
-        }
-    }
-};
-
-template<> struct codec_traits<Layer2::_63_Union__6__> {
-    static void encode(Encoder& e, Layer2::_63_Union__6__ v) {
-        e.encodeUnionIndex(v.idx());
-        switch (v.idx()) {
-        case 0:
-            avro::encode(e, v.get_Unsupported());
-            break;
-        case 1:
-            avro::encode(e, v.get_MacAddr());
-            break;
-        case 2:
-            avro::encode(e, v.get_Ethernet2());
-            break;
-        case 3:
-            avro::encode(e, v.get_dot11_Header());
-            break;
-        case 4:
-            avro::encode(e, v.get_dot11_Unsupported());
-            break;
-        case 5:
-            avro::encode(e, v.get_dot11_ctrl_Ack());
-            break;
-        case 6:
-            avro::encode(e, v.get_dot11_ctrl_BlockAck());
-            break;
-        case 7:
-            avro::encode(e, v.get_dot11_ctrl_BlockAckRequest());
-            break;
-        case 8:
-            avro::encode(e, v.get_dot11_ctrl_CfEnd());
-            break;
-        case 9:
-            avro::encode(e, v.get_dot11_ctrl_EndCfAck());
-            break;
-        case 10:
-            avro::encode(e, v.get_dot11_ctrl_PsPoll());
-            break;
-        case 11:
-            avro::encode(e, v.get_dot11_ctrl_Rts());
-            break;
-        case 12:
-            avro::encode(e, v.get_dot11_data_Header());
-            break;
-        case 13:
-            avro::encode(e, v.get_dot11_data_Data());
-            break;
-        case 14:
-            avro::encode(e, v.get_dot11_data_QosData());
-            break;
-        case 15:
-            avro::encode(e, v.get_dot11_mgmt_Capability());
-            break;
-        case 16:
-            avro::encode(e, v.get_dot11_mgmt_Header());
-            break;
-        case 17:
-            avro::encode(e, v.get_dot11_mgmt_AssocRequest());
-            break;
-        case 18:
-            avro::encode(e, v.get_dot11_mgmt_AssocResponse());
-            break;
-        case 19:
-            avro::encode(e, v.get_dot11_mgmt_Authentication());
-            break;
-        case 20:
-            avro::encode(e, v.get_dot11_mgmt_Beacon());
-            break;
-        case 21:
-            avro::encode(e, v.get_dot11_mgmt_Deauthentication());
-            break;
-        case 22:
-            avro::encode(e, v.get_dot11_mgmt_Disassoc());
-            break;
-        case 23:
-            avro::encode(e, v.get_dot11_mgmt_ProbeRequest());
-            break;
-        case 24:
-            avro::encode(e, v.get_dot11_mgmt_ProbeResponse());
-            break;
-        case 25:
-            avro::encode(e, v.get_dot11_mgmt_ReassocRequest());
-            break;
-        case 26:
-            avro::encode(e, v.get_dot11_mgmt_ReassocResponse());
-            break;
-        case 27:
-            avro::encode(e, v.get_radiotap_Flag());
-            break;
-        case 28:
-            avro::encode(e, v.get_radiotap_ChannelType());
-            break;
-        case 29:
-            avro::encode(e, v.get_radiotap_Channel());
-            break;
-        case 30:
-            avro::encode(e, v.get_Radiotap());
-            break;
-        case 31:
-            avro::encode(e, v.get_Pdu());
-            break;
-        }
-    }
-    static void decode(Decoder& d, Layer2::_63_Union__6__& v) {
-        size_t n = d.decodeUnionIndex();
-        if (n >= 32) { throw avro::Exception("Union index too big"); }
-        switch (n) {
-        case 0:
-            {
-                Layer2::Unsupported vv;
-                avro::decode(d, vv);
-                v.set_Unsupported(vv);
-            }
-            break;
-        case 1:
-            {
-                boost::array<uint8_t, 6> vv;
-                avro::decode(d, vv);
-                v.set_MacAddr(vv);
-            }
-            break;
-        case 2:
-            {
-                Layer2::Ethernet2 vv;
-                avro::decode(d, vv);
-                v.set_Ethernet2(vv);
-            }
-            break;
-        case 3:
-            {
-                Layer2::dot11_Header vv;
-                avro::decode(d, vv);
-                v.set_dot11_Header(vv);
-            }
-            break;
-        case 4:
-            {
-                Layer2::dot11_Unsupported vv;
-                avro::decode(d, vv);
-                v.set_dot11_Unsupported(vv);
-            }
-            break;
-        case 5:
-            {
-                Layer2::dot11_ctrl_Ack vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_Ack(vv);
-            }
-            break;
-        case 6:
-            {
-                Layer2::dot11_ctrl_BlockAck vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_BlockAck(vv);
-            }
-            break;
-        case 7:
-            {
-                Layer2::dot11_ctrl_BlockAckRequest vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_BlockAckRequest(vv);
-            }
-            break;
-        case 8:
-            {
-                Layer2::dot11_ctrl_CfEnd vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_CfEnd(vv);
-            }
-            break;
-        case 9:
-            {
-                Layer2::dot11_ctrl_EndCfAck vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_EndCfAck(vv);
-            }
-            break;
-        case 10:
-            {
-                Layer2::dot11_ctrl_PsPoll vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_PsPoll(vv);
-            }
-            break;
-        case 11:
-            {
-                Layer2::dot11_ctrl_Rts vv;
-                avro::decode(d, vv);
-                v.set_dot11_ctrl_Rts(vv);
-            }
-            break;
-        case 12:
-            {
-                Layer2::dot11_data_Header vv;
-                avro::decode(d, vv);
-                v.set_dot11_data_Header(vv);
-            }
-            break;
-        case 13:
-            {
-                Layer2::dot11_data_Data vv;
-                avro::decode(d, vv);
-                v.set_dot11_data_Data(vv);
-            }
-            break;
-        case 14:
-            {
-                Layer2::dot11_data_QosData vv;
-                avro::decode(d, vv);
-                v.set_dot11_data_QosData(vv);
-            }
-            break;
-        case 15:
-            {
-                Layer2::dot11_mgmt_Capability vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Capability(vv);
-            }
-            break;
-        case 16:
-            {
-                Layer2::dot11_mgmt_Header vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Header(vv);
-            }
-            break;
-        case 17:
-            {
-                Layer2::dot11_mgmt_AssocRequest vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_AssocRequest(vv);
-            }
-            break;
-        case 18:
-            {
-                Layer2::dot11_mgmt_AssocResponse vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_AssocResponse(vv);
-            }
-            break;
-        case 19:
-            {
-                Layer2::dot11_mgmt_Authentication vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Authentication(vv);
-            }
-            break;
-        case 20:
-            {
-                Layer2::dot11_mgmt_Beacon vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Beacon(vv);
-            }
-            break;
-        case 21:
-            {
-                Layer2::dot11_mgmt_Deauthentication vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Deauthentication(vv);
-            }
-            break;
-        case 22:
-            {
-                Layer2::dot11_mgmt_Disassoc vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_Disassoc(vv);
-            }
-            break;
-        case 23:
-            {
-                Layer2::dot11_mgmt_ProbeRequest vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_ProbeRequest(vv);
-            }
-            break;
-        case 24:
-            {
-                Layer2::dot11_mgmt_ProbeResponse vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_ProbeResponse(vv);
-            }
-            break;
-        case 25:
-            {
-                Layer2::dot11_mgmt_ReassocRequest vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_ReassocRequest(vv);
-            }
-            break;
-        case 26:
-            {
-                Layer2::dot11_mgmt_ReassocResponse vv;
-                avro::decode(d, vv);
-                v.set_dot11_mgmt_ReassocResponse(vv);
-            }
-            break;
-        case 27:
-            {
-                Layer2::radiotap_Flag vv;
-                avro::decode(d, vv);
-                v.set_radiotap_Flag(vv);
-            }
-            break;
-        case 28:
-            {
-                Layer2::radiotap_ChannelType vv;
-                avro::decode(d, vv);
-                v.set_radiotap_ChannelType(vv);
-            }
-            break;
-        case 29:
-            {
-                Layer2::radiotap_Channel vv;
-                avro::decode(d, vv);
-                v.set_radiotap_Channel(vv);
-            }
-            break;
-        case 30:
-            {
-                Layer2::Radiotap vv;
-                avro::decode(d, vv);
-                v.set_Radiotap(vv);
-            }
-            break;
-        case 31:
-            {
-                Layer2::Pdu vv;
-                avro::decode(d, vv);
-                v.set_Pdu(vv);
-            }
-            break;
-        }
+template<> struct writer_traits<Pdu> {
+    template <typename W>
+    static void encode(W& w, const Pdu& v) {
+        write(w, v.size);
+        write(w, v.timestamp);
+        write(w, v.frame);
     }
 };
 
 }
-#endif
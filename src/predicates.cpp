@@ -0,0 +1,531 @@
+#include "codecs.hpp"
+#include "predicates.hpp"
+#include <ctype.h>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Layer2 {
+
+typedef Layer2::Pdu::frame_t PduFrame;
+typedef Layer2::Radiotap::frame_t RadiotapFrame;
+
+// Field values.
+
+/**
+ * Read a MAC address as a 48-bit integer (first byte most significant).
+ *
+ */
+static int64_t readAddr(const uint8_t *data) {
+  int64_t n = 0;
+  for (size_t i = 0; i < 6; i++) {
+    n = (n << 8) | data[i];
+  }
+  return n;
+}
+
+static void extractHeader(const Layer2::dot11_Header &src, FieldValues &dst) {
+  dst.set(Field::TO_DS, src.toDs);
+  dst.set(Field::FROM_DS, src.fromDs);
+  dst.set(Field::MORE_FRAG, src.moreFrag);
+  dst.set(Field::RETRY, src.retry);
+  dst.set(Field::POWER_MGMT, src.powerMgmt);
+  dst.set(Field::WEP, src.wep);
+  dst.set(Field::ORDER, src.order);
+  dst.set(Field::DURATION_ID, src.durationId);
+  dst.set(Field::ADDR1, readAddr(src.addr1.data()));
+}
+
+/**
+ * Extract fields shared by data and management frames' headers (their types
+ * are distinct but have the same fields).
+ *
+ */
+template <typename T>
+static void extractAddresses(const T &src, FieldValues &dst) {
+  dst.set(Field::ADDR2, readAddr(src.addr2.data()));
+  dst.set(Field::ADDR3, readAddr(src.addr3.data()));
+  dst.set(Field::ADDR4, readAddr(src.addr4.data()));
+  dst.set(Field::FRAG_NUM, src.fragNum);
+  dst.set(Field::SEQ_NUM, src.seqNum);
+}
+
+template <typename T>
+static void extractMgmt(const T &src, FieldValues &dst) {
+  extractHeader(src.header, dst);
+  extractAddresses(src.mgmtHeader, dst);
+}
+
+/**
+ * Derive the BSSID, following the same rules as `Dot11Frame.getApAddr` in
+ * `lib/utils.js`. It is absent when both DS bits are set, or when the frame
+ * doesn't contain the corresponding address (e.g. for most control frames).
+ *
+ */
+static void extractBssid(FieldValues &dst) {
+  Field field;
+  switch (dst.get(Field::TO_DS) + 2 * dst.get(Field::FROM_DS)) {
+  case 0:
+    field = Field::ADDR3;
+    break;
+  case 1:
+    field = Field::ADDR1;
+    break;
+  case 2:
+    field = Field::ADDR2;
+    break;
+  default:
+    return;
+  }
+  if (dst.has(field)) {
+    dst.set(Field::BSSID, dst.get(field));
+  }
+}
+
+static void extractDot11(const Layer2::Radiotap::frame_t &frame, FieldValues &dst) {
+  switch (frame.idx()) {
+  case RadiotapFrame::dot11_Unsupported_index:
+    extractHeader(frame.get_dot11_Unsupported().header, dst);
+    break;
+  case RadiotapFrame::dot11_ctrl_Ack_index:
+    extractHeader(frame.get_dot11_ctrl_Ack().header, dst);
+    break;
+  case RadiotapFrame::dot11_ctrl_BlockAck_index:
+    extractHeader(frame.get_dot11_ctrl_BlockAck().header, dst);
+    break;
+  case RadiotapFrame::dot11_ctrl_BlockAckRequest_index:
+    extractHeader(frame.get_dot11_ctrl_BlockAckRequest().header, dst);
+    break;
+  case RadiotapFrame::dot11_ctrl_CfEnd_index:
+    extractHeader(frame.get_dot11_ctrl_CfEnd().header, dst);
+    break;
+  case RadiotapFrame::dot11_ctrl_EndCfAck_index:
+    extractHeader(frame.get_dot11_ctrl_EndCfAck().header, dst);
+    break;
+  case RadiotapFrame::dot11_ctrl_PsPoll_index:
+    extractHeader(frame.get_dot11_ctrl_PsPoll().header, dst);
+    break;
+  case RadiotapFrame::dot11_ctrl_Rts_index:
+    extractHeader(frame.get_dot11_ctrl_Rts().header, dst);
+    break;
+  case RadiotapFrame::dot11_data_Data_index:
+    extractHeader(frame.get_dot11_data_Data().header, dst);
+    extractAddresses(frame.get_dot11_data_Data().dataHeader, dst);
+    break;
+  case RadiotapFrame::dot11_data_QosData_index:
+    extractHeader(frame.get_dot11_data_QosData().header, dst);
+    extractAddresses(frame.get_dot11_data_QosData().dataHeader, dst);
+    dst.set(Field::QOS_CONTROL, frame.get_dot11_data_QosData().qosControl);
+    break;
+  case RadiotapFrame::dot11_mgmt_AssocRequest_index:
+    extractMgmt(frame.get_dot11_mgmt_AssocRequest(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_AssocResponse_index:
+    extractMgmt(frame.get_dot11_mgmt_AssocResponse(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_Authentication_index:
+    extractMgmt(frame.get_dot11_mgmt_Authentication(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_Beacon_index:
+    extractMgmt(frame.get_dot11_mgmt_Beacon(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_Deauthentication_index:
+    extractMgmt(frame.get_dot11_mgmt_Deauthentication(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_Disassoc_index:
+    extractMgmt(frame.get_dot11_mgmt_Disassoc(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_ProbeRequest_index:
+    extractMgmt(frame.get_dot11_mgmt_ProbeRequest(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_ProbeResponse_index:
+    extractMgmt(frame.get_dot11_mgmt_ProbeResponse(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_ReassocRequest_index:
+    extractMgmt(frame.get_dot11_mgmt_ReassocRequest(), dst);
+    break;
+  case RadiotapFrame::dot11_mgmt_ReassocResponse_index:
+    extractMgmt(frame.get_dot11_mgmt_ReassocResponse(), dst);
+    break;
+  default:
+    return; // Not an 802.11 frame.
+  }
+  extractBssid(dst);
+}
+
+void FieldValues::extract(const Frame &frame, const Layer2::Radiotap *radiotap) {
+  _present = 0;
+  set(Field::LEN, frame.len);
+  if (radiotap) {
+    set(Field::TYPE, frameTag(PduFrame::Radiotap_index, radiotap->frame.idx()));
+    if (!radiotap->tsft.is_null()) {
+      set(Field::TSFT, radiotap->tsft.get_long());
+    }
+    if (!radiotap->rate.is_null()) {
+      set(Field::RATE, radiotap->rate.get_int());
+    }
+    if (!radiotap->channel.is_null()) {
+      set(Field::FREQ, radiotap->channel.get_radiotap_Channel().freq);
+    }
+    extractDot11(radiotap->frame, *this);
+  } else if (frame.linkType == DLT_EN10MB && frame.caplen >= 14) {
+    set(Field::TYPE, frameTag(PduFrame::Ethernet2_index));
+    set(Field::DST_ADDR, readAddr(frame.data));
+    set(Field::SRC_ADDR, readAddr(frame.data + 6));
+    set(Field::PAYLOAD_TYPE, (frame.data[12] << 8) | frame.data[13]);
+  } else {
+    set(Field::TYPE, frameTag(PduFrame::Unsupported_index));
+  }
+}
+
+// Compilation.
+
+static const struct {
+  const char *name;
+  Field field;
+} FIELDS[] = {
+  {"type", Field::TYPE},
+  {"len", Field::LEN},
+  {"tsft", Field::TSFT},
+  {"rate", Field::RATE},
+  {"freq", Field::FREQ},
+  {"toDs", Field::TO_DS},
+  {"fromDs", Field::FROM_DS},
+  {"moreFrag", Field::MORE_FRAG},
+  {"retry", Field::RETRY},
+  {"powerMgmt", Field::POWER_MGMT},
+  {"wep", Field::WEP},
+  {"order", Field::ORDER},
+  {"durationId", Field::DURATION_ID},
+  {"addr1", Field::ADDR1},
+  {"addr2", Field::ADDR2},
+  {"addr3", Field::ADDR3},
+  {"addr4", Field::ADDR4},
+  {"bssid", Field::BSSID},
+  {"fragNum", Field::FRAG_NUM},
+  {"seqNum", Field::SEQ_NUM},
+  {"qosControl", Field::QOS_CONTROL},
+  {"srcAddr", Field::SRC_ADDR},
+  {"dstAddr", Field::DST_ADDR},
+  {"payloadType", Field::PAYLOAD_TYPE}
+};
+
+/**
+ * Mask of the tags corresponding to a frame type name (see
+ * `getFrameTypeNames` in `lib/utils.js`), 0 if the name is unknown.
+ *
+ * Both unsupported branches share the same name.
+ *
+ */
+static uint64_t getTypeMask(const std::string &name) {
+  static const struct {
+    const char *name;
+    size_t radiotapIndex; // Only used for radiotap frames.
+  } RADIOTAP_FRAMES[] = {
+    {"Radiotap", RadiotapFrame::null_index},
+    {"Unsupported", RadiotapFrame::Unsupported_index},
+    {"dot11.Unsupported", RadiotapFrame::dot11_Unsupported_index},
+    {"dot11.ctrl.Ack", RadiotapFrame::dot11_ctrl_Ack_index},
+    {"dot11.ctrl.BlockAck", RadiotapFrame::dot11_ctrl_BlockAck_index},
+    {"dot11.ctrl.BlockAckRequest", RadiotapFrame::dot11_ctrl_BlockAckRequest_index},
+    {"dot11.ctrl.CfEnd", RadiotapFrame::dot11_ctrl_CfEnd_index},
+    {"dot11.ctrl.EndCfAck", RadiotapFrame::dot11_ctrl_EndCfAck_index},
+    {"dot11.ctrl.PsPoll", RadiotapFrame::dot11_ctrl_PsPoll_index},
+    {"dot11.ctrl.Rts", RadiotapFrame::dot11_ctrl_Rts_index},
+    {"dot11.data.Data", RadiotapFrame::dot11_data_Data_index},
+    {"dot11.data.QosData", RadiotapFrame::dot11_data_QosData_index},
+    {"dot11.mgmt.AssocRequest", RadiotapFrame::dot11_mgmt_AssocRequest_index},
+    {"dot11.mgmt.AssocResponse", RadiotapFrame::dot11_mgmt_AssocResponse_index},
+    {"dot11.mgmt.Authentication", RadiotapFrame::dot11_mgmt_Authentication_index},
+    {"dot11.mgmt.Beacon", RadiotapFrame::dot11_mgmt_Beacon_index},
+    {"dot11.mgmt.Deauthentication", RadiotapFrame::dot11_mgmt_Deauthentication_index},
+    {"dot11.mgmt.Disassoc", RadiotapFrame::dot11_mgmt_Disassoc_index},
+    {"dot11.mgmt.ProbeRequest", RadiotapFrame::dot11_mgmt_ProbeRequest_index},
+    {"dot11.mgmt.ProbeResponse", RadiotapFrame::dot11_mgmt_ProbeResponse_index},
+    {"dot11.mgmt.ReassocRequest", RadiotapFrame::dot11_mgmt_ReassocRequest_index},
+    {"dot11.mgmt.ReassocResponse", RadiotapFrame::dot11_mgmt_ReassocResponse_index}
+  };
+
+  uint64_t mask = 0;
+  if (name == "Unsupported") {
+    mask |= 1ULL << frameTag(PduFrame::Unsupported_index);
+  } else if (name == "Ethernet2") {
+    mask |= 1ULL << frameTag(PduFrame::Ethernet2_index);
+  }
+  for (size_t i = 0; i < sizeof(RADIOTAP_FRAMES) / sizeof(RADIOTAP_FRAMES[0]); i++) {
+    if (name == RADIOTAP_FRAMES[i].name) {
+      mask |= 1ULL << frameTag(PduFrame::Radiotap_index, RADIOTAP_FRAMES[i].radiotapIndex);
+    }
+  }
+  return mask;
+}
+
+/**
+ * Recursive descent parser, emitting a predicate's program as it goes.
+ *
+ *  expr := term ('or' term)*
+ *  term := factor ('and' factor)*
+ *  factor := 'not' factor | '(' expr ')' | field [op value]
+ *
+ */
+class PredicateCompiler {
+public:
+  PredicateCompiler(const std::string &expr, Predicate &predicate) :
+  _expr(expr),
+  _pos(0),
+  _program(predicate._program),
+  _depth(0),
+  _maxDepth(0) {}
+
+  /**
+   * Returns the largest stack size needed to evaluate the program.
+   *
+   */
+  size_t compile() {
+    next();
+    parseExpr();
+    if (!_token.empty()) {
+      fail("unexpected " + _token);
+    }
+    return _maxDepth;
+  }
+
+private:
+  const std::string &_expr;
+  size_t _pos;
+  std::string _token; // Current token, empty at the end of the expression.
+  std::vector<Predicate::Instruction> &_program;
+  size_t _depth;
+  size_t _maxDepth;
+
+  static bool isWordChar(char c) {
+    return isalnum(c) || c == '_' || c == '.' || c == ':' || c == '-';
+  }
+
+  void fail(const std::string &reason) {
+    throw std::runtime_error("invalid predicate: " + reason);
+  }
+
+  void next() {
+    while (_pos < _expr.size() && isspace(_expr[_pos])) {
+      _pos++;
+    }
+    size_t start = _pos;
+    if (_pos == _expr.size()) {
+      _token.clear();
+      return;
+    }
+    char c = _expr[_pos];
+    if (isWordChar(c)) {
+      while (_pos < _expr.size() && isWordChar(_expr[_pos])) {
+        _pos++;
+      }
+    } else if (c == '(' || c == ')') {
+      _pos++;
+    } else if (strchr("=!<>", c)) {
+      _pos++;
+      if (_pos < _expr.size() && _expr[_pos] == '=') {
+        _pos++;
+      }
+    } else {
+      fail(std::string("unexpected character ") + c);
+    }
+    _token = _expr.substr(start, _pos - start);
+  }
+
+  void emit(Predicate::Opcode opcode, Field field = Field::TYPE, int64_t value = 0) {
+    Predicate::Instruction instruction = {opcode, field, value};
+    _program.push_back(instruction);
+    switch (opcode) {
+    case Predicate::Opcode::AND:
+    case Predicate::Opcode::OR:
+      _depth--;
+      break;
+    case Predicate::Opcode::NOT:
+      break;
+    default:
+      if (++_depth > _maxDepth) {
+        _maxDepth = _depth;
+      }
+    }
+  }
+
+  void parseExpr() {
+    parseTerm();
+    while (_token == "or") {
+      next();
+      parseTerm();
+      emit(Predicate::Opcode::OR);
+    }
+  }
+
+  void parseTerm() {
+    parseFactor();
+    while (_token == "and") {
+      next();
+      parseFactor();
+      emit(Predicate::Opcode::AND);
+    }
+  }
+
+  void parseFactor() {
+    if (_token == "not") {
+      next();
+      parseFactor();
+      emit(Predicate::Opcode::NOT);
+    } else if (_token == "(") {
+      next();
+      parseExpr();
+      if (_token != ")") {
+        fail("missing )");
+      }
+      next();
+    } else {
+      parseComparison();
+    }
+  }
+
+  void parseComparison() {
+    Field field = parseField();
+    Predicate::Opcode opcode;
+    if (_token == "==") {
+      opcode = Predicate::Opcode::EQ;
+    } else if (_token == "!=") {
+      opcode = Predicate::Opcode::NE;
+    } else if (_token == "<") {
+      opcode = Predicate::Opcode::LT;
+    } else if (_token == "<=") {
+      opcode = Predicate::Opcode::LE;
+    } else if (_token == ">") {
+      opcode = Predicate::Opcode::GT;
+    } else if (_token == ">=") {
+      opcode = Predicate::Opcode::GE;
+    } else {
+      if (field == Field::TYPE) {
+        fail("type must be compared");
+      }
+      emit(Predicate::Opcode::TRUTHY, field);
+      return;
+    }
+    next();
+
+    if (field == Field::TYPE) {
+      if (opcode != Predicate::Opcode::EQ && opcode != Predicate::Opcode::NE) {
+        fail("type only supports equality");
+      }
+      uint64_t mask = getTypeMask(_token);
+      if (!mask) {
+        fail("unknown type " + _token);
+      }
+      next();
+      emit(Predicate::Opcode::TYPE, field, mask);
+      if (opcode == Predicate::Opcode::NE) {
+        emit(Predicate::Opcode::NOT);
+      }
+      return;
+    }
+    emit(opcode, field, parseValue());
+  }
+
+  Field parseField() {
+    for (size_t i = 0; i < sizeof(FIELDS) / sizeof(FIELDS[0]); i++) {
+      if (_token == FIELDS[i].name) {
+        next();
+        return FIELDS[i].field;
+      }
+    }
+    fail(_token.empty() ? "missing field" : "unknown field " + _token);
+    return Field::TYPE; // Unreachable.
+  }
+
+  int64_t parseValue() {
+    std::string token = _token;
+    next();
+    if (token == "true") {
+      return 1;
+    }
+    if (token == "false") {
+      return 0;
+    }
+
+    uint8_t addr[6];
+    char end;
+    if (
+      token.size() == 17 &&
+      sscanf(
+        token.c_str(), "%2hhx:%2hhx:%2hhx:%2hhx:%2hhx:%2hhx%c",
+        &addr[0], &addr[1], &addr[2], &addr[3], &addr[4], &addr[5], &end
+      ) == 6
+    ) {
+      return readAddr(addr);
+    }
+
+    const char *start = token.c_str();
+    char *stop;
+    bool negative = *start == '-';
+    bool hex = !strncmp(start + negative, "0x", 2);
+    int64_t value = strtoll(start, &stop, hex ? 16 : 10);
+    if (token.empty() || *stop) {
+      fail("invalid value " + token);
+    }
+    return value;
+  }
+};
+
+// Predicate.
+
+Predicate::Predicate(const std::string &expr) {
+  PredicateCompiler compiler(expr, *this);
+  _stack.resize(compiler.compile());
+}
+
+bool Predicate::matches(const FieldValues &values) const {
+  uint8_t *top = _stack.data(); // Next free slot.
+  for (size_t i = 0; i < _program.size(); i++) {
+    const Instruction &instruction = _program[i];
+    Field field = instruction.field;
+    int64_t value = instruction.value;
+    bool present = values.has(field);
+    switch (instruction.opcode) {
+    case Opcode::AND:
+      top--;
+      top[-1] = top[-1] && top[0];
+      break;
+    case Opcode::OR:
+      top--;
+      top[-1] = top[-1] || top[0];
+      break;
+    case Opcode::NOT:
+      top[-1] = !top[-1];
+      break;
+    case Opcode::TYPE:
+      *top++ = (value >> values.get(Field::TYPE)) & 1;
+      break;
+    case Opcode::TRUTHY:
+      *top++ = present && values.get(field);
+      break;
+    case Opcode::EQ:
+      *top++ = present && values.get(field) == value;
+      break;
+    case Opcode::NE:
+      *top++ = present && values.get(field) != value;
+      break;
+    case Opcode::LT:
+      *top++ = present && values.get(field) < value;
+      break;
+    case Opcode::LE:
+      *top++ = present && values.get(field) <= value;
+      break;
+    case Opcode::GT:
+      *top++ = present && values.get(field) > value;
+      break;
+    case Opcode::GE:
+      *top++ = present && values.get(field) >= value;
+      break;
+    }
+  }
+  return top[-1];
+}
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "./frame.hpp"
+#include "./pdus.hpp"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Predicates over frames' fields, evaluated natively before encoding.
+ *
+ */
+
+namespace Layer2 {
+
+/**
+ * Fields predicates can refer to.
+ *
+ * Names match the corresponding IDL fields (see `Predicate`), except for
+ * `type` (the frame's tag, see `frameTag`), `len` (the frame's length on the
+ * wire), and `bssid` (derived from the 802.11 header's address fields).
+ *
+ */
+enum class Field {
+  TYPE,
+  LEN,
+  TSFT,
+  RATE,
+  FREQ,
+  TO_DS,
+  FROM_DS,
+  MORE_FRAG,
+  RETRY,
+  POWER_MGMT,
+  WEP,
+  ORDER,
+  DURATION_ID,
+  ADDR1,
+  ADDR2,
+  ADDR3,
+  ADDR4,
+  BSSID,
+  FRAG_NUM,
+  SEQ_NUM,
+  QOS_CONTROL,
+  SRC_ADDR,
+  DST_ADDR,
+  PAYLOAD_TYPE,
+  COUNT // Number of fields, must come last.
+};
+
+/**
+ * Values of a frame's fields.
+ *
+ * All values are stored as integers (addresses in network order, booleans as
+ * 0 or 1). Fields which don't exist for a given frame (e.g. `retry` for
+ * ethernet frames) are marked as absent, any comparison on them is false.
+ *
+ */
+class FieldValues {
+public:
+  FieldValues() : _present(0) {}
+
+  /**
+   * Extract all fields from a frame.
+   *
+   * `radiotap` must be the natively parsed record of radiotap frames (and
+   * `NULL` for other link types).
+   *
+   */
+  void extract(const Frame &frame, const Layer2::Radiotap *radiotap);
+
+  bool has(Field field) const { return _present & bit(field); }
+
+  int64_t get(Field field) const { return _values[(size_t) field]; }
+
+  void set(Field field, int64_t value) {
+    _values[(size_t) field] = value;
+    _present |= bit(field);
+  }
+
+private:
+  int64_t _values[(size_t) Field::COUNT];
+  uint32_t _present;
+
+  static uint32_t bit(Field field) { return 1U << (size_t) field; }
+};
+
+/**
+ * Compiled predicate.
+ *
+ * Expressions combine comparisons with `and`, `or`, `not`, and parentheses.
+ * Comparisons are of the form `<field> <op> <value>` where the operator is one
+ * of `==`, `!=`, `<`, `<=`, `>`, `>=`; a field on its own is true when it is
+ * present and non-zero. Values can be integers (decimal or hexadecimal),
+ * `true` or `false`, MAC addresses (e.g. `01:23:45:67:89:ab`), or, for
+ * `type` (which only supports equality), frame type names as used in typed
+ * `pdu` events (e.g. `dot11.data.QosData`). For example:
+ *
+ *  retry and type == dot11.data.QosData and bssid == 01:23:45:67:89:ab
+ *
+ * Expressions are compiled to a postfix program, so that evaluation is a
+ * single pass without any allocations.
+ *
+ */
+class Predicate {
+public:
+  /**
+   * Compile an expression, throwing `std::runtime_error` if it is invalid.
+   *
+   */
+  explicit Predicate(const std::string &expr);
+
+  bool matches(const FieldValues &values) const;
+
+private:
+  enum class Opcode { EQ, NE, LT, LE, GT, GE, TRUTHY, TYPE, AND, OR, NOT };
+
+  struct Instruction {
+    Opcode opcode;
+    Field field;
+    int64_t value; // Tag mask for `TYPE` instructions.
+  };
+
+  std::vector<Instruction> _program;
+  mutable std::vector<uint8_t> _stack; // Sized at compile time.
+
+  friend class PredicateCompiler;
+};
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace Layer2 {
+
+/**
+ * Lock-free single-producer single-consumer ring.
+ *
+ * Elements are preallocated and reused: the producer fills the slot returned
+ * by `back` then commits it with `push`, the consumer reads the slot returned
+ * by `front` then releases it with `pop`. Each index is only ever written by
+ * one side, so acquire/release ordering is sufficient.
+ *
+ */
+template <typename T>
+class Ring {
+public:
+  explicit Ring(size_t capacity) :
+  _slots(capacity),
+  _head(0),
+  _tail(0) {}
+
+  size_t capacity() const { return _slots.size(); }
+
+  T &at(size_t index) { return _slots[index]; }
+
+  /**
+   * Next slot to be written, or `NULL` if the ring is full (producer only).
+   *
+   */
+  T *back() {
+    size_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) == _slots.size()) {
+      return NULL;
+    }
+    return &_slots[tail % _slots.size()];
+  }
+
+  void push() { _tail.fetch_add(1, std::memory_order_release); }
+
+  /**
+   * Oldest committed slot, or `NULL` if the ring is empty (consumer only).
+   *
+   */
+  T *front() {
+    size_t head = _head.load(std::memory_order_relaxed);
+    if (head == _tail.load(std::memory_order_acquire)) {
+      return NULL;
+    }
+    return &_slots[head % _slots.size()];
+  }
+
+  void pop() { _head.fetch_add(1, std::memory_order_release); }
+
+private:
+  std::vector<T> _slots;
+  // Each index lives on its own cache line to avoid false sharing between the
+  // producer and consumer threads.
+  alignas(64) std::atomic<size_t> _head;
+  alignas(64) std::atomic<size_t> _tail;
+};
+
+}
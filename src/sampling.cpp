@@ -0,0 +1,105 @@
+#include "sampling.hpp"
+#include <algorithm>
+#include <cmath>
+#include <pcap/pcap.h>
+#include <stdexcept>
+
+namespace Layer2 {
+
+Sampler::Sampler() :
+_method(SamplingMethod::NONE),
+_rate(1),
+_period(1),
+_count(0),
+_threshold(UINT64_MAX),
+_random(std::random_device()()),
+_lastTransmitter(UINT64_MAX),
+_lastSampled(false) {}
+
+void Sampler::configure(SamplingMethod method, double rate) {
+  if (!(rate > 0 && rate <= 1)) {
+    throw std::runtime_error("invalid sampling rate");
+  }
+  _method = rate == 1 ? SamplingMethod::NONE : method; // Nothing to discard.
+  _count = 0;
+  _lastTransmitter = UINT64_MAX; // Never a valid address.
+  switch (_method) {
+  case SamplingMethod::NONE:
+    _rate = 1;
+    break;
+  case SamplingMethod::COUNT:
+    _period = std::max((uint64_t) std::llround(1 / rate), (uint64_t) 1);
+    _rate = 1.0 / _period;
+    break;
+  default:
+    _rate = rate;
+    _threshold = std::ldexp(rate, 64); // Fits, since the rate is below 1.
+  }
+}
+
+/**
+ * Read an address as a 48-bit integer. The frame must contain it.
+ *
+ */
+static uint64_t readAddr(const Frame &frame, size_t offset) {
+  uint64_t n = 0;
+  for (size_t i = 0; i < 6; i++) {
+    n = (n << 8) | frame.data[offset + i];
+  }
+  return n;
+}
+
+/**
+ * Finalizer of SplitMix64, to spread addresses' bits.
+ *
+ */
+static uint64_t mix(uint64_t n) {
+  n = (n ^ (n >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  n = (n ^ (n >> 27)) * 0x94d049bb133111ebULL;
+  return n ^ (n >> 31);
+}
+
+bool Sampler::sampleHash(const Frame &frame) {
+  size_t offset; // Of the first address.
+  bool dot11 = true;
+  switch (frame.linkType) {
+  case DLT_EN10MB:
+    offset = 0;
+    dot11 = false;
+    break;
+  case DLT_IEEE802_11:
+    offset = 4;
+    break;
+  case DLT_IEEE802_11_RADIO:
+    if (frame.caplen < 4) {
+      return _random() < _threshold;
+    }
+    offset = (frame.data[2] | (frame.data[3] << 8)) + 4;
+    break;
+  default:
+    return _random() < _threshold;
+  }
+  if (frame.caplen < offset + 6) {
+    return _random() < _threshold;
+  }
+  uint64_t addr1 = readAddr(frame, offset);
+
+  if (dot11) {
+    uint8_t control = frame.data[offset - 4];
+    uint8_t subtype = control >> 4;
+    if (((control >> 2) & 3) == 1 && (subtype == 12 || subtype == 13)) {
+      // CTS or ACK, addressed to the previous frame's transmitter if it is the
+      // one they answer.
+      return addr1 == _lastTransmitter ? _lastSampled : mix(addr1) < _threshold;
+    }
+  }
+  if (frame.caplen < offset + 12) {
+    return _random() < _threshold;
+  }
+  uint64_t addr2 = readAddr(frame, offset + 6);
+  _lastTransmitter = addr2;
+  _lastSampled = mix(mix(std::min(addr1, addr2)) ^ std::max(addr1, addr2)) < _threshold;
+  return _lastSampled;
+}
+
+}
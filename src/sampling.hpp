@@ -0,0 +1,92 @@
+#pragma once
+
+#include "./frame.hpp"
+#include <random>
+#include <stdint.h>
+
+/**
+ * Sampling of frames, before they are parsed.
+ *
+ */
+
+namespace Layer2 {
+
+enum class SamplingMethod {
+  NONE, // Keep all frames.
+  COUNT, // Keep one frame every `1 / rate`.
+  RANDOM, // Keep each frame with probability `rate`.
+  HASH // Keep frames whose addresses hash below `rate`.
+};
+
+/**
+ * Selection of a fraction of frames.
+ *
+ * Decisions only look at the frames' raw bytes, so that discarded frames cost
+ * (almost) nothing. Hash-based sampling keeps whole conversations: frames are
+ * hashed on their two addresses, in either order (ethernet source and
+ * destination, or 802.11 receiver and transmitter), so both directions of an
+ * exchange are always either kept or discarded together, consistently across
+ * captures.
+ *
+ * 802.11 CTS and ACK frames only carry a receiver address, that of the
+ * transmitter of the frame they answer (sent right before them). They are
+ * kept along with that frame, or hashed on their single address if they
+ * don't follow it (e.g. CTS-to-self). Frames whose addresses can't be read
+ * (truncated, or of another link type) are sampled randomly instead, so that
+ * they don't skew the sampling rate.
+ *
+ */
+class Sampler {
+public:
+  Sampler();
+
+  /**
+   * Throws `std::runtime_error` if the rate isn't in `(0, 1]`.
+   *
+   */
+  void configure(SamplingMethod method, double rate);
+
+  bool enabled() const { return _method != SamplingMethod::NONE; }
+
+  /**
+   * Expected fraction of frames kept (e.g. to scale counts back up). In count
+   * mode, this is exactly one over the sampling period.
+   *
+   */
+  double rate() const { return _rate; }
+
+  /**
+   * Whether a frame should be kept.
+   *
+   */
+  bool sample(const Frame &frame) {
+    switch (_method) {
+    case SamplingMethod::COUNT:
+      if (++_count < _period) {
+        return false;
+      }
+      _count = 0;
+      return true;
+    case SamplingMethod::RANDOM:
+      return _random() < _threshold;
+    case SamplingMethod::HASH:
+      return sampleHash(frame);
+    default:
+      return true;
+    }
+  }
+
+private:
+  SamplingMethod _method;
+  double _rate;
+  uint64_t _period; // Count mode.
+  uint64_t _count;
+  uint64_t _threshold; // Random and hash modes.
+  std::mt19937_64 _random;
+  uint64_t _lastTransmitter; // Hash mode, of the last frame with two addresses.
+  bool _lastSampled;
+
+  bool sampleHash(const Frame &frame);
+};
+
+}
@@ -0,0 +1,155 @@
+#include "sources.hpp"
+#include <chrono>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdexcept>
+#include <string.h>
+#include <unistd.h>
+
+namespace Layer2 {
+
+// Poller.
+
+Poller::Poller() : _interrupted(false) {
+  if (pipe(_pipe) < 0) {
+    throw std::runtime_error(std::string("unable to create pipe: ") + strerror(errno));
+  }
+  fcntl(_pipe[0], F_SETFL, O_NONBLOCK);
+  fcntl(_pipe[1], F_SETFL, O_NONBLOCK);
+}
+
+Poller::~Poller() {
+  close(_pipe[0]);
+  close(_pipe[1]);
+}
+
+bool Poller::wait(int fd, int timeout) {
+  if (_interrupted) {
+    return false;
+  }
+  struct pollfd pfds[2];
+  pfds[0].fd = fd;
+  pfds[0].events = POLLIN;
+  pfds[0].revents = 0;
+  pfds[1].fd = _pipe[0];
+  pfds[1].events = POLLIN;
+  pfds[1].revents = 0;
+  int ret = poll(pfds, 2, timeout);
+  if (ret < 0 && errno != EINTR) {
+    throw std::runtime_error(std::string("unable to poll: ") + strerror(errno));
+  }
+  return ret > 0 && !_interrupted;
+}
+
+void Poller::interrupt() {
+  _interrupted = true;
+  uint8_t byte = 0;
+  // The pipe is never drained, so this only needs to succeed once.
+  if (write(_pipe[1], &byte, 1) < 0) {
+    ; // Full pipe, already interrupted.
+  }
+}
+
+// PCAP.
+
+PcapSource::PcapSource(Tins::BaseSniffer *sniffer, bool live) :
+_sniffer(sniffer),
+_handle(sniffer->get_pcap_handle()),
+_live(live),
+_exhausted(false),
+_fd(-1),
+_linkType(pcap_datalink(_handle)),
+_handler(NULL),
+_numFrames(0),
+_pending(),
+_hasPending(false) {
+  if (live) {
+    int fd = pcap_get_selectable_fd(_handle);
+    char errbuf[PCAP_ERRBUF_SIZE];
+    // If the platform doesn't support it, we fall back to blocking reads.
+    if (fd >= 0 && pcap_setnonblock(_handle, 1, errbuf) == 0) {
+      _fd = fd;
+    }
+  }
+}
+
+uint32_t PcapSource::dispatch(FrameHandler &handler, int timeout) {
+  _handler = &handler;
+  _numFrames = 0;
+
+  if (_hasPending) {
+    switch (handler.onFrame(_pendingFrame)) {
+    case FrameHandler::Result::RETRY:
+      return 0;
+    case FrameHandler::Result::STOP:
+      _hasPending = false;
+      return 1;
+    default:
+      _hasPending = false;
+      _numFrames++;
+    }
+  }
+
+  std::chrono::time_point<std::chrono::steady_clock> deadline;
+  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+  while (!_poller.interrupted()) {
+    int ret = pcap_dispatch(_handle, -1, PcapSource::onPacket, (u_char *) this);
+    if (ret == -1) {
+      throw std::runtime_error(pcap_geterr(_handle));
+    }
+    if (ret != 0 || _numFrames || _fd < 0) {
+      // Either we got some frames, the handler interrupted us (-2), or this
+      // was a blocking read (which only returns empty-handed on timeout or end
+      // of file).
+      if (!ret && !_live) {
+        _exhausted = true; // Offline handles don't time out.
+      }
+      return _numFrames;
+    }
+    // Nothing buffered, wait for more frames (or the deadline).
+    if (timeout >= 0) {
+      int64_t remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now()
+      ).count();
+      if (remaining <= 0 || !_poller.wait(_fd, remaining)) {
+        return 0;
+      }
+    } else if (!_poller.wait(_fd, -1)) {
+      return 0;
+    }
+  }
+  return _numFrames;
+}
+
+void PcapSource::onPacket(
+  u_char *user,
+  const struct pcap_pkthdr *header,
+  const u_char *data
+) {
+  PcapSource *source = (PcapSource *) user;
+  Frame frame;
+  frame.data = data;
+  frame.caplen = header->caplen;
+  frame.len = header->len;
+  frame.ts = header->ts;
+  frame.linkType = source->_linkType;
+
+  switch (source->_handler->onFrame(frame)) {
+  case FrameHandler::Result::RETRY:
+    source->_pending.assign(data, data + header->caplen);
+    source->_pendingFrame = frame;
+    source->_pendingFrame.data = source->_pending.data();
+    source->_hasPending = true;
+    pcap_breakloop(source->_handle);
+    break;
+  case FrameHandler::Result::STOP:
+    source->_numFrames++;
+    pcap_breakloop(source->_handle);
+    break;
+  default:
+    source->_numFrames++;
+  }
+}
+
+}
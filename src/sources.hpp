@@ -0,0 +1,149 @@
+#pragma once
+
+#include "frame.hpp"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <tins/tins.h>
+
+namespace Layer2 {
+
+/**
+ * Helper to wait for a file descriptor to become readable.
+ *
+ * Waits can be interrupted from any other thread (via a self-pipe), after
+ * which all waits return immediately.
+ *
+ */
+class Poller {
+public:
+  Poller();
+  ~Poller();
+
+  /**
+   * Wait at most `timeout` milliseconds (forever if negative).
+   *
+   * Returns `false` if the timeout expired or the poller was interrupted.
+   *
+   */
+  bool wait(int fd, int timeout);
+
+  void interrupt();
+
+  bool interrupted() const { return _interrupted; }
+
+private:
+  int _pipe[2];
+  std::atomic<bool> _interrupted;
+};
+
+/**
+ * Consumer of frames, fed by a `Source`.
+ *
+ */
+class FrameHandler {
+public:
+  enum Result {
+    CONTINUE, // Frame consumed, keep going.
+    STOP, // Frame consumed, but no more frames should be dispatched.
+    RETRY // Frame not consumed, it should be dispatched again next time.
+  };
+
+  virtual ~FrameHandler() {}
+
+  virtual Result onFrame(const Frame &frame) = 0;
+};
+
+/**
+ * Source of raw frames.
+ *
+ */
+class Source {
+public:
+  virtual ~Source() {}
+
+  /**
+   * Feed all frames currently available to a handler.
+   *
+   * If no frames are available, this waits at most `timeout` milliseconds
+   * (forever if negative) for some to arrive. Dispatching stops early if the
+   * handler asks for it. Frames' data is only valid during the handler call.
+   *
+   * Returns the number of frames consumed by the handler, 0 if the timeout
+   * expired, the source is exhausted, or it was interrupted. Throws
+   * `std::runtime_error` on capture errors.
+   *
+   */
+  virtual uint32_t dispatch(FrameHandler &handler, int timeout) = 0;
+
+  /**
+   * Whether frames come from a live interface (rather than a file).
+   *
+   */
+  virtual bool live() const = 0;
+
+  /**
+   * Whether a previous `dispatch` reached the end of the source.
+   *
+   * Only files can be exhausted.
+   *
+   */
+  virtual bool exhausted() const { return false; }
+
+  /**
+   * Make any pending (and future) `dispatch` call return early.
+   *
+   * This is safe to call from any thread.
+   *
+   */
+  void interrupt() { _poller.interrupt(); }
+
+protected:
+  Poller _poller;
+};
+
+/**
+ * Source reading from a tins sniffer's PCAP handle.
+ *
+ * Each dispatch drains everything PCAP has buffered with a single
+ * `pcap_dispatch` call (rather than a round-trip per frame).
+ *
+ * Live handles are switched to non-blocking mode and waited on via their
+ * selectable file descriptor, so that reads honor the caller's deadline
+ * exactly (rather than PCAP's own timeout, which only applies once a packet
+ * has arrived) and can be interrupted.
+ *
+ */
+class PcapSource : public Source {
+public:
+  PcapSource(Tins::BaseSniffer *sniffer, bool live);
+
+  uint32_t dispatch(FrameHandler &handler, int timeout);
+
+  bool live() const { return _live; }
+
+  bool exhausted() const { return _exhausted; }
+
+private:
+  std::unique_ptr<Tins::BaseSniffer> _sniffer;
+  pcap_t *_handle;
+  bool _live;
+  bool _exhausted;
+  int _fd; // Selectable descriptor, negative if reads should block instead.
+  int _linkType;
+  // State of the ongoing dispatch.
+  FrameHandler *_handler;
+  uint32_t _numFrames;
+  // Copy of a frame the handler asked to retry (PCAP won't return it again).
+  std::vector<uint8_t> _pending;
+  Frame _pendingFrame;
+  bool _hasPending;
+
+  static void onPacket(
+    u_char *user,
+    const struct pcap_pkthdr *header,
+    const u_char *data
+  );
+};
+
+}
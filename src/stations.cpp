@@ -0,0 +1,144 @@
+#include "stations.hpp"
+
+namespace Layer2 {
+
+// Initial number of slots, must be a power of two.
+#define LAYER2_STATIONS_CAPACITY 256
+
+// Time after which unseen stations are dropped, in microseconds.
+#define LAYER2_STATIONS_TTL 300000000
+
+/**
+ * Whether an address is a group (multicast or broadcast) address.
+ *
+ */
+static bool isGroupAddr(int64_t addr) {
+  return (addr >> 40) & 1; // Least significant bit of the first byte.
+}
+
+/**
+ * Address of the station a frame was sent by or to, or -1 if there is none
+ * (group addressed frames).
+ *
+ */
+static int64_t getStation(const FieldValues &values, int64_t bssid) {
+  int64_t station = -1;
+  switch (values.get(Field::TO_DS) + 2 * values.get(Field::FROM_DS)) {
+  case 1:
+    if (values.has(Field::ADDR2)) {
+      station = values.get(Field::ADDR2);
+    }
+    break;
+  case 2:
+    station = values.get(Field::ADDR1);
+    break;
+  default:
+    if (values.has(Field::ADDR2) && values.get(Field::ADDR2) != bssid) {
+      station = values.get(Field::ADDR2);
+    } else if (values.get(Field::ADDR1) != bssid) {
+      station = values.get(Field::ADDR1);
+    }
+  }
+  return station == -1 || isGroupAddr(station) ? -1 : station;
+}
+
+static void encodeAddr(Writer &writer, int64_t addr) {
+  uint8_t bytes[6];
+  for (size_t i = 0; i < 6; i++) {
+    bytes[i] = addr >> (8 * (5 - i));
+  }
+  writer.writeFixed<6>(bytes);
+}
+
+/**
+ * Write an optional value, absent when negative.
+ *
+ */
+static void encodeOptional(Writer &writer, int32_t n) {
+  if (n < 0) {
+    writer.writeUnionIndex(0);
+  } else {
+    writer.writeUnionIndex(1);
+    writer.writeInt(n);
+  }
+}
+
+void encodeStation(Writer &writer, const Station &station) {
+  const StationCounters &counters = station.counters;
+  encodeAddr(writer, station.key.bssid);
+  if (station.key.station == -1) {
+    writer.writeUnionIndex(0);
+  } else {
+    writer.writeUnionIndex(1);
+    encodeAddr(writer, station.key.station);
+  }
+  writer.writeLong(counters.firstSeen / 1000);
+  writer.writeLong(counters.lastSeen / 1000);
+  writer.writeLong(counters.numFrames);
+  writer.writeLong(counters.numRetries);
+  encodeOptional(writer, counters.rate);
+  encodeOptional(writer, counters.freq);
+}
+
+StationTable::StationTable() :
+_stations(LAYER2_STATIONS_CAPACITY),
+_interval(1000000),
+_clock(0),
+_nextSnapshot(0) {}
+
+bool StationTable::add(const Frame &frame, const FieldValues &values) {
+  if (!values.has(Field::BSSID)) {
+    return false;
+  }
+  int64_t ts = (int64_t) frame.ts.tv_sec * 1000000 + frame.ts.tv_usec;
+  tick(ts);
+
+  StationKey key;
+  key.bssid = values.get(Field::BSSID);
+  key.station = getStation(values, key.bssid);
+  bool inserted;
+  StationCounters &counters = _stations.get(key, inserted);
+  if (inserted) {
+    counters.firstSeen = ts;
+    counters.rate = -1;
+    counters.freq = -1;
+  }
+  if (ts > counters.lastSeen) {
+    counters.lastSeen = ts;
+  }
+  counters.numFrames++;
+  if (values.get(Field::RETRY)) {
+    counters.numRetries++;
+  }
+  if (values.has(Field::RATE)) {
+    counters.rate = values.get(Field::RATE);
+  }
+  if (values.has(Field::FREQ)) {
+    counters.freq = values.get(Field::FREQ);
+  }
+  counters.updated = true;
+  return true;
+}
+
+void StationTable::tick(int64_t now) {
+  if (now > _clock) {
+    _clock = now;
+  }
+  if (_clock < _nextSnapshot) {
+    return;
+  }
+  snapshot();
+  _nextSnapshot = _clock + _interval;
+}
+
+void StationTable::snapshot() {
+  _stations.removeIf([this](const StationKey &key, StationCounters &counters) {
+    if (counters.updated) {
+      counters.updated = false;
+      _snapshots.push_back({key, counters});
+    }
+    return _clock - counters.lastSeen >= LAYER2_STATIONS_TTL;
+  });
+}
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "./frame.hpp"
+#include "./predicates.hpp"
+#include "./table.hpp"
+#include "./writer.hpp"
+#include <deque>
+#include <stdint.h>
+
+/**
+ * Aggregation of 802.11 traffic per station, natively.
+ *
+ */
+
+namespace Layer2 {
+
+// Upper bound on the size of an encoded station record.
+#define LAYER2_MAX_STATION_SIZE 80
+
+struct StationKey {
+  int64_t bssid; // Addresses as in `FieldValues`.
+  int64_t station; // -1 for group addressed frames.
+};
+
+struct StationCounters {
+  int64_t firstSeen; // Timestamps, in microseconds.
+  int64_t lastSeen;
+  uint64_t numFrames;
+  uint64_t numRetries;
+  int32_t rate; // -1 until known.
+  int32_t freq;
+  bool updated; // Since the last snapshot.
+};
+
+struct Station {
+  StationKey key;
+  StationCounters counters;
+};
+
+/**
+ * Write a station as a `Station` record (see `etc/idls/Station.avdl`).
+ *
+ */
+void encodeStation(Writer &writer, const Station &station);
+
+/**
+ * Table of stations, keyed by BSSID and station address.
+ *
+ * Frames are attributed following the DS bits: frames to the DS come from
+ * the station (`addr2`), frames from the DS go to it (`addr1`), and frames
+ * within the BSS (e.g. management frames) involve whichever of the two isn't
+ * the BSSID.
+ *
+ * Every `interval` of capture time, a snapshot of the stations updated since
+ * the previous one is queued, to be consumed from `snapshots`. Stations which
+ * haven't been seen in five minutes are then dropped from the table (they are
+ * added back with fresh counters if seen again).
+ *
+ */
+class StationTable {
+public:
+  StationTable();
+
+  /**
+   * Snapshot interval, in milliseconds.
+   *
+   */
+  void setInterval(uint32_t interval) { _interval = (int64_t) interval * 1000; }
+
+  /**
+   * Count a frame towards its station, returning `false` if it doesn't have a
+   * BSSID (in which case it is ignored).
+   *
+   */
+  bool add(const Frame &frame, const FieldValues &values);
+
+  /**
+   * Move time forward to `now` (in microseconds, it is ignored if earlier than
+   * the latest frame's timestamp), taking a snapshot if one is due.
+   *
+   */
+  void tick(int64_t now);
+
+  size_t size() const { return _stations.size(); }
+
+  std::deque<Station> &snapshots() { return _snapshots; }
+
+private:
+  Table<StationKey, StationCounters> _stations;
+  std::deque<Station> _snapshots;
+  int64_t _interval; // Microseconds.
+  int64_t _clock; // Latest timestamp seen.
+  int64_t _nextSnapshot;
+
+  void snapshot();
+};
+
+}
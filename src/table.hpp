@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+namespace Layer2 {
+
+/**
+ * Open addressing hash table, for aggregating frames natively.
+ *
+ * Collisions are resolved by linear probing, and removals by shifting the
+ * following entries back (so that no tombstones are needed). The table doubles
+ * in size whenever it is three quarters full, and never shrinks.
+ *
+ * Keys are hashed (FNV-1a) and compared bytewise, so they must be plain
+ * structs without padding, or zeroed before being filled in.
+ *
+ */
+template <typename K, typename V>
+class Table {
+public:
+  explicit Table(size_t capacity) : _slots(capacity), _size(0) {} // A power of two.
+
+  size_t size() const { return _size; }
+
+  /**
+   * Value for a key, value-initialized and flagged as `inserted` if the key
+   * wasn't present. The reference is only valid until the next insertion.
+   *
+   */
+  V &get(const K &key, bool &inserted) {
+    if (4 * (_size + 1) > 3 * _slots.size()) {
+      grow();
+    }
+    uint64_t hash = hashKey(key);
+    size_t mask = _slots.size() - 1;
+    size_t index = hash & mask;
+    while (
+      _slots[index].used &&
+      !(_slots[index].hash == hash && !memcmp(&_slots[index].key, &key, sizeof(K)))
+    ) {
+      index = (index + 1) & mask;
+    }
+    Slot &slot = _slots[index];
+    inserted = !slot.used;
+    if (inserted) {
+      slot.used = true;
+      slot.hash = hash;
+      slot.key = key;
+      slot.value = V();
+      _size++;
+    }
+    return slot.value;
+  }
+
+  /**
+   * Call `fn(key, value)` on each entry, removing those for which it returns
+   * `true`.
+   *
+   */
+  template <typename F>
+  void removeIf(F fn) {
+    size_t index = 0;
+    while (_size && index < _slots.size()) {
+      Slot &slot = _slots[index];
+      if (slot.used && fn(slot.key, slot.value)) {
+        remove(index); // Another entry might have been shifted here, revisit it.
+      } else {
+        index++;
+      }
+    }
+  }
+
+private:
+  struct Slot {
+    K key;
+    V value;
+    uint64_t hash;
+    bool used;
+
+    Slot() : used(false) {}
+  };
+
+  std::vector<Slot> _slots;
+  size_t _size;
+
+  static uint64_t hashKey(const K &key) {
+    const uint8_t *data = (const uint8_t *) &key;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < sizeof(K); i++) {
+      hash = (hash ^ data[i]) * 0x100000001b3ULL;
+    }
+    return hash;
+  }
+
+  void remove(size_t index) {
+    size_t mask = _slots.size() - 1;
+    size_t hole = index;
+    size_t next = index;
+    while (true) {
+      next = (next + 1) & mask;
+      if (!_slots[next].used) {
+        break;
+      }
+      // The entry can fill the hole unless its home slot lies (cyclically)
+      // after the hole, in which case moving it would make it unreachable.
+      size_t home = _slots[next].hash & mask;
+      if (((next - home) & mask) >= ((next - hole) & mask)) {
+        _slots[hole] = _slots[next];
+        hole = next;
+      }
+    }
+    _slots[hole].used = false;
+    _size--;
+  }
+
+  void grow() {
+    std::vector<Slot> slots(2 * _slots.size());
+    size_t mask = slots.size() - 1;
+    for (const Slot &slot : _slots) {
+      if (!slot.used) {
+        continue;
+      }
+      size_t index = slot.hash & mask;
+      while (slots[index].used) {
+        index = (index + 1) & mask;
+      }
+      slots[index] = slot;
+    }
+    _slots.swap(slots);
+  }
+};
+
+}
@@ -0,0 +1,313 @@
+#include "tpacket.hpp"
+#include <chrono>
+#include <stdexcept>
+
+#ifdef __linux__
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <linux/filter.h>
+#include <linux/if_packet.h>
+#include <net/ethernet.h>
+#include <net/if.h>
+#include <net/if_arp.h>
+#include <pcap/pcap.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#endif
+
+namespace Layer2 {
+
+#define LAYER2_TPACKET_BLOCK_SIZE (1 << 20)
+#define LAYER2_TPACKET_BLOCK_COUNT 16
+#define LAYER2_TPACKET_FRAME_SIZE (1 << 11)
+
+#ifdef __linux__
+
+/**
+ * Helper to raise an error from the last failed system call.
+ *
+ */
+static void fail(const char *prefix) {
+  throw std::runtime_error(std::string(prefix) + ": " + strerror(errno));
+}
+
+/**
+ * Infer the PCAP link type corresponding to an interface's hardware type.
+ *
+ */
+static int getLinkType(int fd, const std::string &dev) {
+  struct ifreq ifr;
+  memset(&ifr, 0, sizeof(ifr));
+  strncpy(ifr.ifr_name, dev.c_str(), IFNAMSIZ - 1);
+  if (ioctl(fd, SIOCGIFHWADDR, &ifr) < 0) {
+    fail("unable to get hardware type");
+  }
+  switch (ifr.ifr_hwaddr.sa_family) {
+  case ARPHRD_ETHER:
+  case ARPHRD_LOOPBACK:
+    return DLT_EN10MB;
+  case ARPHRD_IEEE80211:
+    return DLT_IEEE802_11;
+  case ARPHRD_IEEE80211_RADIOTAP:
+    return DLT_IEEE802_11_RADIO;
+  default:
+    throw std::runtime_error("unsupported hardware type");
+  }
+}
+
+/**
+ * Compile a BPF filter and attach it to the socket.
+ *
+ * The compiled program's return value also takes care of truncating frames to
+ * the snapshot length (the ring itself has no such setting).
+ *
+ */
+static void attachFilter(int fd, int linkType, const TpacketConfiguration &config) {
+  pcap_t *handle = pcap_open_dead(linkType, config.snapLen ? config.snapLen : 65535);
+  if (!handle) {
+    throw std::runtime_error("unable to compile filter");
+  }
+  struct bpf_program program;
+  if (pcap_compile(handle, &program, config.filter.c_str(), 1, PCAP_NETMASK_UNKNOWN) < 0) {
+    std::string msg(pcap_geterr(handle));
+    pcap_close(handle);
+    throw std::runtime_error(msg);
+  }
+  pcap_close(handle);
+
+  struct sock_fprog fprog;
+  fprog.len = program.bf_len;
+  fprog.filter = (struct sock_filter *) program.bf_insns;
+  int ret = setsockopt(fd, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof(fprog));
+  pcap_freecode(&program);
+  if (ret < 0) {
+    fail("unable to attach filter");
+  }
+}
+
+TpacketSniffer::TpacketSniffer(
+  const std::string &dev,
+  const TpacketConfiguration &config
+) :
+_fd(-1),
+_map(NULL),
+_blockSize(config.blockSize ? config.blockSize : LAYER2_TPACKET_BLOCK_SIZE),
+_blockCount(config.blockCount ? config.blockCount : LAYER2_TPACKET_BLOCK_COUNT),
+_blockIndex(0),
+_numFrames(0),
+_header(NULL) {
+  if (
+    _blockSize % getpagesize() ||
+    _blockSize % LAYER2_TPACKET_FRAME_SIZE
+  ) {
+    throw std::runtime_error(
+      "block size must be a multiple of both the page size and 2048 bytes"
+    );
+  }
+
+  unsigned int ifindex = if_nametoindex(dev.c_str());
+  if (!ifindex) {
+    fail(dev.c_str());
+  }
+
+  // No protocol yet, so that nothing is captured until the socket is bound to
+  // the interface (frames from all interfaces would otherwise land in the
+  // ring in the meantime).
+  _fd = socket(AF_PACKET, SOCK_RAW, 0);
+  if (_fd < 0) {
+    fail("unable to open socket");
+  }
+
+  try {
+    _frame.linkType = getLinkType(_fd, dev);
+
+    if (!config.filter.empty() || config.snapLen) {
+      attachFilter(_fd, _frame.linkType, config);
+    }
+
+    int version = TPACKET_V3;
+    if (setsockopt(_fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version)) < 0) {
+      fail("unable to set packet version");
+    }
+
+    struct tpacket_req3 req;
+    memset(&req, 0, sizeof(req));
+    req.tp_block_size = _blockSize;
+    req.tp_block_nr = _blockCount;
+    req.tp_frame_size = LAYER2_TPACKET_FRAME_SIZE;
+    req.tp_frame_nr = (_blockSize / LAYER2_TPACKET_FRAME_SIZE) * _blockCount;
+    req.tp_retire_blk_tov = config.blockTimeout;
+    if (setsockopt(_fd, SOL_PACKET, PACKET_RX_RING, &req, sizeof(req)) < 0) {
+      fail("unable to create ring");
+    }
+
+    size_t len = (size_t) _blockSize * _blockCount;
+    void *map = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (map == MAP_FAILED) {
+      fail("unable to map ring");
+    }
+    _map = (uint8_t *) map;
+
+    if (config.promisc) {
+      struct packet_mreq mreq;
+      memset(&mreq, 0, sizeof(mreq));
+      mreq.mr_ifindex = ifindex;
+      mreq.mr_type = PACKET_MR_PROMISC;
+      if (setsockopt(_fd, SOL_PACKET, PACKET_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+        fail("unable to enable promiscuous mode");
+      }
+    }
+
+    struct sockaddr_ll addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    addr.sll_ifindex = ifindex;
+    if (bind(_fd, (struct sockaddr *) &addr, sizeof(addr)) < 0) {
+      fail("unable to bind socket");
+    }
+
+    if (config.fanoutMode != FanoutMode::NONE) {
+      // Joining the group must happen after binding.
+      int type;
+      switch (config.fanoutMode) {
+      case FanoutMode::CPU:
+        type = PACKET_FANOUT_CPU;
+        break;
+      case FanoutMode::LB:
+        type = PACKET_FANOUT_LB;
+        break;
+      default:
+        // Defragment first so that all fragments of a flow hash the same way,
+        // preserving per-flow ordering.
+        type = PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG;
+      }
+      int arg = config.fanoutGroup | (type << 16);
+      if (setsockopt(_fd, SOL_PACKET, PACKET_FANOUT, &arg, sizeof(arg)) < 0) {
+        fail("unable to join fanout group");
+      }
+    }
+  } catch (std::runtime_error &err) {
+    if (_map) {
+      munmap(_map, (size_t) _blockSize * _blockCount);
+    }
+    close(_fd);
+    throw;
+  }
+}
+
+TpacketSniffer::~TpacketSniffer() {
+  munmap(_map, (size_t) _blockSize * _blockCount);
+  close(_fd);
+}
+
+uint32_t TpacketSniffer::dispatch(FrameHandler &handler, int timeout) {
+  std::chrono::time_point<std::chrono::steady_clock> deadline;
+  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout);
+  uint32_t numFrames = 0;
+  while (!_poller.interrupted()) {
+    if (!_numFrames && !acquire()) {
+      if (numFrames) {
+        return numFrames; // We have caught up with the kernel.
+      }
+      // Nothing read yet, wait for the next block.
+      if (timeout >= 0) {
+        int64_t remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - std::chrono::steady_clock::now()
+        ).count();
+        if (remaining <= 0 || !_poller.wait(_fd, remaining)) {
+          return 0;
+        }
+      } else if (!_poller.wait(_fd, -1)) {
+        return 0;
+      }
+      continue;
+    }
+
+    switch (handler.onFrame(_frame)) {
+    case FrameHandler::Result::RETRY:
+      return numFrames; // The frame stays current, it will be retried.
+    case FrameHandler::Result::STOP:
+      advance();
+      return numFrames + 1;
+    default:
+      advance();
+      numFrames++;
+    }
+  }
+  return numFrames;
+}
+
+bool TpacketSniffer::acquire() {
+  struct tpacket_block_desc *desc;
+  while (true) {
+    desc = (struct tpacket_block_desc *) (_map + (size_t) _blockIndex * _blockSize);
+    uint32_t status = __atomic_load_n(&desc->hdr.bh1.block_status, __ATOMIC_ACQUIRE);
+    if (!(status & TP_STATUS_USER)) {
+      return false;
+    }
+    if (desc->hdr.bh1.num_pkts) {
+      break;
+    }
+    release(); // Nothing to read in this block, skip it.
+  }
+  _numFrames = desc->hdr.bh1.num_pkts;
+  _header = (uint8_t *) desc + desc->hdr.bh1.offset_to_first_pkt;
+  load();
+  return true;
+}
+
+void TpacketSniffer::advance() {
+  if (--_numFrames) {
+    _header += ((struct tpacket3_hdr *) _header)->tp_next_offset;
+    load();
+  } else {
+    release();
+  }
+}
+
+void TpacketSniffer::load() {
+  struct tpacket3_hdr *hdr = (struct tpacket3_hdr *) _header;
+  _frame.data = _header + hdr->tp_mac;
+  _frame.caplen = hdr->tp_snaplen;
+  _frame.len = hdr->tp_len;
+  _frame.ts.tv_sec = hdr->tp_sec;
+  _frame.ts.tv_usec = hdr->tp_nsec / 1000;
+}
+
+void TpacketSniffer::release() {
+  struct tpacket_block_desc *desc;
+  desc = (struct tpacket_block_desc *) (_map + (size_t) _blockIndex * _blockSize);
+  __atomic_store_n(&desc->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+  _blockIndex = (_blockIndex + 1) % _blockCount;
+}
+
+#else
+
+TpacketSniffer::TpacketSniffer(
+  const std::string &dev,
+  const TpacketConfiguration &config
+) {
+  throw std::runtime_error("tpacket capture is only supported on linux");
+}
+
+TpacketSniffer::~TpacketSniffer() {}
+
+uint32_t TpacketSniffer::dispatch(FrameHandler &handler, int timeout) { return 0; }
+
+bool TpacketSniffer::acquire() { return false; }
+
+void TpacketSniffer::advance() {}
+
+void TpacketSniffer::load() {}
+
+void TpacketSniffer::release() {}
+
+#endif
+
+}
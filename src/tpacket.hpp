@@ -0,0 +1,81 @@
+#pragma once
+
+#include "sources.hpp"
+#include <string>
+
+namespace Layer2 {
+
+/**
+ * How frames are distributed between sockets of a fanout group.
+ *
+ */
+enum class FanoutMode { NONE, HASH, CPU, LB };
+
+/**
+ * Configuration for a `TpacketSniffer`.
+ *
+ * Zero values mean the corresponding default (or kernel default) is used.
+ *
+ */
+struct TpacketConfiguration {
+  uint32_t snapLen;
+  bool promisc;
+  uint32_t blockSize; // Bytes, a multiple of the page size and frame size.
+  uint32_t blockCount;
+  uint32_t blockTimeout; // Milliseconds before a partially filled block is retired.
+  std::string filter;
+  FanoutMode fanoutMode;
+  uint16_t fanoutGroup; // Only used if `fanoutMode` isn't `NONE`.
+
+  TpacketConfiguration() :
+  snapLen(0),
+  promisc(false),
+  blockSize(0),
+  blockCount(0),
+  blockTimeout(0),
+  filter(),
+  fanoutMode(FanoutMode::NONE),
+  fanoutGroup(0) {}
+};
+
+/**
+ * Live capture using Linux's memory-mapped `AF_PACKET` rings (TPACKET_V3).
+ *
+ * The kernel fills whole blocks of frames in memory shared with us, so frames
+ * can be read without any syscall or copy. A syscall (`poll`) only happens
+ * when we have caught up with the kernel and need to wait for the next block
+ * to be retired.
+ *
+ * Several sniffers can join the same fanout group (`PACKET_FANOUT`), the kernel
+ * then spreads frames between their sockets, for example so that each can be
+ * read from a different thread.
+ *
+ * Each dispatch walks all frames from the retired blocks available.
+ *
+ */
+class TpacketSniffer : public Source {
+public:
+  TpacketSniffer(const std::string &dev, const TpacketConfiguration &config);
+  ~TpacketSniffer();
+
+  uint32_t dispatch(FrameHandler &handler, int timeout);
+
+  bool live() const { return true; }
+
+private:
+  int _fd;
+  uint8_t *_map;
+  uint32_t _blockSize;
+  uint32_t _blockCount;
+  uint32_t _blockIndex; // Block currently being read.
+  uint32_t _numFrames; // Frames left in the current block (0 if none).
+  uint8_t *_header; // Header of the current frame.
+  Frame _frame;
+
+  bool acquire(); // Start reading the current block, if it is ready.
+  void advance(); // Move on to the next frame (and block if necessary).
+  void load(); // Populate `_frame` from the current header.
+  void release(); // Hand the current block back to the kernel.
+};
+
+}
@@ -1,20 +1,33 @@
+#include "allocations.hpp"
 #include "codecs.hpp"
+#include "columns.hpp"
+#include "flows.hpp"
+#include "ring.hpp"
+#include "sampling.hpp"
+#include "stations.hpp"
+#include "tpacket.hpp"
 #include "wrapper.hpp"
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <string.h>
+#include <thread>
 
 namespace Layer2 {
 
-#define LAYER2_BUFFER_SIZE 1024
-
-// Black hole array used to write any overflowing data. We must use this since
-// Avro's encoder will throw an error when it tries to write and the underlying
-// stream is full. Since this might happen at every loop, it is cheaper to fake
-// a successful write rather than catch (which might also have side-effects).
-static uint8_t BUFFER[LAYER2_BUFFER_SIZE] = {0};
+// Initial size of each wrapper's overflow scratch space.
+#define LAYER2_OVERFLOW_SIZE 1024
 
 /**
  * Helper class to handle encoding Avro records to a JavaScript buffer.
  *
+ * Writing a PDU can't be undone midway through, so once the underlying buffer
+ * is full we fake successful writes rather than fail (the PDU is then moved
+ * out of the batch once complete): any overflowing data is written to a
+ * separate scratch space instead. This space is owned by the calling wrapper
+ * (so that concurrent captures never share it) and grows as needed, so that
+ * overflowing bytes are never overwritten.
+ *
  */
 class BufferOutputStream : public avro::OutputStream {
 public:
@@ -22,7 +35,8 @@ public:
 
   static BufferOutputStream *fromBuffer(
     v8::Local<v8::Value> buf,
-    float loadFactor
+    float loadFactor,
+    std::vector<uint8_t> &overflow
   ) {
     if (!node::Buffer::HasInstance(buf)) {
       return NULL;
@@ -31,14 +45,20 @@ public:
     v8::Local<v8::Object> obj = buf->ToObject();
     uint8_t *data = (uint8_t *) node::Buffer::Data(obj);
     size_t len = node::Buffer::Length(obj);
-    return new BufferOutputStream(data, len, loadFactor);
+    return new BufferOutputStream(data, len, loadFactor, overflow);
   }
 
-  BufferOutputStream(uint8_t *data, size_t len, float loadFactor) :
+  BufferOutputStream(
+    uint8_t *data,
+    size_t len,
+    float loadFactor,
+    std::vector<uint8_t> &overflow
+  ) :
     _data(data),
     _len(len),
     _hwm(len *loadFactor),
-    _pos(0) {};
+    _pos(0),
+    _overflow(overflow) {};
 
   ~BufferOutputStream() {};
 
@@ -52,9 +72,13 @@ public:
       *len = _len - _pos;
       _pos = _len;
     } else {
-      *data = BUFFER;
-      *len = LAYER2_BUFFER_SIZE;
-      _pos = _len + 1;
+      size_t used = _pos - _len;
+      if (used == _overflow.size()) {
+        _overflow.resize(used ? 2 * used : LAYER2_OVERFLOW_SIZE);
+      }
+      *data = _overflow.data() + used;
+      *len = _overflow.size() - used;
+      _pos = _len + _overflow.size();
     }
     return true;
   }
@@ -65,11 +89,49 @@ public:
 
   virtual uint64_t byteCount() const { return _pos; }
 
+  uint8_t *data() const { return _data; }
+
+  size_t length() const { return _len; }
+
+  /**
+   * Copy already encoded bytes, returning `false` if they don't fit.
+   *
+   * This must only be called while no writer is holding any chunk (e.g. right
+   * after it was flushed).
+   *
+   */
+  bool write(const uint8_t *data, size_t len) {
+    if (_pos + len > _len) {
+      return false;
+    }
+    memcpy(_data + _pos, data, len);
+    _pos += len;
+    return true;
+  }
+
+  /**
+   * Move all bytes written after position `pos` to `dst`, and rewind there.
+   *
+   * Same precondition as `write`.
+   *
+   */
+  void rewind(size_t pos, std::vector<uint8_t> &dst) {
+    dst.assign(_data + pos, _data + std::min(_pos, _len));
+    if (_pos > _len) {
+      dst.insert(dst.end(), _overflow.begin(), _overflow.begin() + (_pos - _len));
+    }
+    _pos = pos;
+  }
+
+  /**
+   * Current state, only exact when no writer is holding any chunk.
+   *
+   */
   State getState() const {
-    if (_pos < _len) {
+    if (_pos < _hwm) {
       return State::ALMOST_EMPTY;
     }
-    if (_pos == _len) {
+    if (_pos <= _len) {
       return State::ALMOST_FULL;
     }
     return State::FULL;
@@ -79,9 +141,316 @@ private:
   uint8_t *_data;
   size_t _len;
   size_t _hwm; // High watermark.
-  size_t _pos;
+  size_t _pos; // Past `_len` when overflowing.
+  std::vector<uint8_t> &_overflow;
+};
+
+/**
+ * Frame handler which can tell when its batch is complete.
+ *
+ */
+class BatchHandler : public FrameHandler {
+public:
+  virtual ~BatchHandler() {}
+
+  virtual bool full() const = 0;
+};
+
+/**
+ * Frame handler forwarding only sampled frames to another.
+ *
+ */
+class SamplingHandler : public BatchHandler {
+public:
+  SamplingHandler(BatchHandler &handler, Sampler &sampler, BatchStats &stats) :
+  _handler(handler),
+  _sampler(sampler),
+  _stats(stats) {}
+
+  Result onFrame(const Frame &frame) {
+    if (!_sampler.sample(frame)) {
+      return Result::CONTINUE;
+    }
+    _stats.numSampled++;
+    return _handler.onFrame(frame);
+  }
+
+  bool full() const { return _handler.full(); }
+
+private:
+  BatchHandler &_handler;
+  Sampler &_sampler;
+  BatchStats &_stats;
+};
+
+/**
+ * Frame handler encoding PDUs into a stream until it is full.
+ *
+ * Each PDU is written (and flushed) on its own, so that the stream's position
+ * always matches the end of the last PDU written. When a PDU overflows, its
+ * encoded bytes are moved to `spill` (to be copied into the next batch, rather
+ * than encoded a second time). Each PDU kept in the batch is added to `index`.
+ *
+ */
+class BatchWriter : public BatchHandler {
+public:
+  BatchWriter(
+    Converter &converter,
+    bool raw,
+    BufferOutputStream &stream,
+    BatchStats &stats,
+    BatchIndex &index,
+    std::vector<uint8_t> &spill,
+    uint8_t &spillTag
+  ) :
+  _converter(converter),
+  _raw(raw),
+  _stream(stream),
+  _stats(stats),
+  _index(index),
+  _spill(spill),
+  _spillTag(spillTag),
+  _full(false) {}
+
+  Result onFrame(const Frame &frame) {
+    size_t start = _stream.byteCount();
+    {
+      Writer writer(_stream); // Flushed when it goes out of scope.
+      if (_raw) {
+        if (!_converter.accept(frame)) {
+          return Result::CONTINUE;
+        }
+        encodeRaw(writer, frame);
+      } else if (!_converter.encode(writer, frame)) {
+        return Result::CONTINUE; // Skip it, same as tins' sniffers.
+      }
+    }
+
+    switch (_stream.getState()) {
+    case BufferOutputStream::State::FULL:
+      _full = true;
+      _stream.rewind(start, _spill);
+      _spillTag = tag();
+      return Result::STOP;
+    case BufferOutputStream::State::ALMOST_FULL:
+      _full = true;
+      _stats.numPdus++;
+      _index.push(start, tag());
+      return Result::STOP;
+    default:
+      _stats.numPdus++;
+      _index.push(start, tag());
+      return Result::CONTINUE;
+    }
+  }
+
+  bool full() const { return _full; }
+
+private:
+  Converter &_converter;
+  bool _raw; // Write frames as is, rather than as PDUs.
+  BufferOutputStream &_stream;
+  BatchStats &_stats;
+  BatchIndex &_index;
+  std::vector<uint8_t> &_spill;
+  uint8_t &_spillTag;
+  bool _full;
+
+  uint8_t tag() const {
+    // Raw frames aren't parsed, they are all tagged as unsupported.
+    uint8_t tag = _raw ? frameTag(Pdu::frame_t::Unsupported_index) : _converter.tag();
+    return _converter.duplicate() ? tag | LAYER2_DUPLICATE_TAG : tag;
+  }
+};
+
+/**
+ * Frame handler adding rows to columns until they exceed a batch's size.
+ *
+ * The row which overflows is kept pending, to be laid out first in the next
+ * batch. Data is truncated so that a single row always fits.
+ *
+ */
+class ColumnWriter : public BatchHandler {
+public:
+  ColumnWriter(Converter &converter, Columns &columns, size_t len) :
+  _converter(converter),
+  _columns(columns),
+  _len(len),
+  _maxData(std::min(columns.maxData(len), (size_t) converter.payloadSnap())) {}
+
+  Result onFrame(const Frame &frame) {
+    const FieldValues *values = _converter.extract(frame);
+    if (!values) {
+      return Result::CONTINUE;
+    }
+    _columns.add(frame, *values, _maxData);
+    return full() ? Result::STOP : Result::CONTINUE;
+  }
+
+  bool full() const { return _columns.byteSize(_columns.size()) > _len; }
+
+private:
+  Converter &_converter;
+  Columns &_columns;
+  size_t _len;
+  size_t _maxData;
+};
+
+/**
+ * Frame handler aggregating frames into flows.
+ *
+ * It fills up once enough flows have expired to fill a batch.
+ *
+ */
+class FlowWriter : public BatchHandler {
+public:
+  FlowWriter(Converter &converter, FlowTable &flows, size_t len) :
+  _converter(converter),
+  _flows(flows),
+  _len(len) {}
+
+  Result onFrame(const Frame &frame) {
+    if (_converter.accept(frame)) {
+      _flows.add(frame);
+    }
+    return full() ? Result::STOP : Result::CONTINUE;
+  }
+
+  bool full() const { return _flows.expired().size() * LAYER2_MAX_FLOW_SIZE >= _len; }
+
+private:
+  Converter &_converter;
+  FlowTable &_flows;
+  size_t _len;
+};
+
+/**
+ * Frame handler aggregating 802.11 frames into stations.
+ *
+ * It fills up once enough snapshots are pending to fill a batch.
+ *
+ */
+class StationWriter : public BatchHandler {
+public:
+  StationWriter(Converter &converter, StationTable &stations, size_t len) :
+  _converter(converter),
+  _stations(stations),
+  _len(len) {}
+
+  Result onFrame(const Frame &frame) {
+    const FieldValues *values = _converter.extract(frame);
+    if (values) {
+      _stations.add(frame, *values);
+    }
+    return full() ? Result::STOP : Result::CONTINUE;
+  }
+
+  bool full() const {
+    return _stations.snapshots().size() * LAYER2_MAX_STATION_SIZE >= _len;
+  }
+
+private:
+  Converter &_converter;
+  StationTable &_stations;
+  size_t _len;
 };
 
+/**
+ * Write queued records (e.g. expired flows) into a batch for as long as they
+ * are sure to fit, indexing them with `tag`.
+ *
+ */
+template <typename T>
+static void writeRecords(
+  std::deque<T> &records,
+  void (*encodeRecord)(Writer &, const T &),
+  size_t maxSize,
+  uint8_t tag,
+  BufferOutputStream &stream,
+  BatchStats &stats,
+  BatchIndex &index
+) {
+  while (!records.empty() && stream.byteCount() + maxSize <= stream.length()) {
+    size_t start = stream.byteCount();
+    {
+      Writer writer(stream);
+      encodeRecord(writer, records.front());
+    }
+    records.pop_front();
+    stats.numPdus++;
+    index.push(start, tag);
+  }
+}
+
+/**
+ * Convert batch statistics to their JavaScript representation.
+ *
+ */
+static v8::Local<v8::Object> toObject(const BatchStats &stats) {
+  v8::Local<v8::Object> obj = Nan::New<v8::Object>();
+  Nan::Set(
+    obj,
+    Nan::New("frames").ToLocalChecked(),
+    Nan::New<v8::Number>(stats.numFrames)
+  );
+  Nan::Set(
+    obj,
+    Nan::New("sampled").ToLocalChecked(),
+    Nan::New<v8::Number>(stats.numSampled)
+  );
+  Nan::Set(
+    obj,
+    Nan::New("samplingRate").ToLocalChecked(),
+    Nan::New<v8::Number>(stats.samplingRate)
+  );
+  Nan::Set(
+    obj,
+    Nan::New("dispatches").ToLocalChecked(),
+    Nan::New<v8::Number>(stats.numDispatches)
+  );
+  Nan::Set(
+    obj,
+    Nan::New("bufferGrowths").ToLocalChecked(),
+    Nan::New<v8::Number>(stats.numBufferGrowths)
+  );
+  Nan::Set(
+    obj,
+    Nan::New("allocations").ToLocalChecked(),
+    Nan::New<v8::Number>(stats.numAllocations)
+  );
+  Nan::Set(
+    obj,
+    Nan::New("duplicates").ToLocalChecked(),
+    Nan::New<v8::Number>(stats.numDuplicates)
+  );
+  Nan::Set(
+    obj,
+    Nan::New("bytes").ToLocalChecked(),
+    Nan::New<v8::Number>(stats.numBytes)
+  );
+  v8::Local<v8::Array> matches = Nan::New<v8::Array>(stats.numMatches.size());
+  for (uint32_t i = 0; i < stats.numMatches.size(); i++) {
+    Nan::Set(matches, i, Nan::New<v8::Number>(stats.numMatches[i]));
+  }
+  Nan::Set(obj, Nan::New("matches").ToLocalChecked(), matches);
+  return obj;
+}
+
+/**
+ * Copy values into a new JavaScript typed array (e.g. `v8::Uint32Array` for
+ * `uint32_t`).
+ *
+ */
+template <typename A, typename T>
+static v8::Local<A> toTypedArray(const std::vector<T> &values) {
+  size_t len = values.size() * sizeof(T);
+  v8::Local<v8::ArrayBuffer> buf = v8::ArrayBuffer::New(v8::Isolate::GetCurrent(), len);
+  if (len) {
+    memcpy(buf->GetContents().Data(), values.data(), len);
+  }
+  return A::New(buf, 0, values.size());
+}
+
 /**
  * Helper class to handle asynchronous PDU capture.
  *
@@ -91,74 +460,46 @@ public:
   Worker(Wrapper *wrapper, v8::Local<v8::Value> buf, Nan::Callback *callback) :
   AsyncWorker(callback),
   _wrapper(wrapper),
-  _stream(BufferOutputStream::fromBuffer(buf, 0.9)),
-  _numPdus(0) {
-    _wrapper->_encoder->init(*_stream);
-  }
+  _stream(BufferOutputStream::fromBuffer(buf, 0.9, wrapper->_overflow)),
+  _stats() {}
 
   ~Worker() {}
 
   void Execute() {
-    std::chrono::time_point<std::chrono::high_resolution_clock> start, current;
-    start = std::chrono::high_resolution_clock::now();
-
-    // First, check whether we have a backlogged PDU.
-    if (_wrapper->_packet.pdu()) {
-      avro::encode(*_wrapper->_encoder, _wrapper->_packet);
-      delete _wrapper->_packet.release_pdu();
-      switch (_stream->getState()) {
-      case BufferOutputStream::State::FULL:
-        SetErrorMessage("buffer too small");
-      case BufferOutputStream::State::ALMOST_FULL:
-        return;
-      default:
-        ; // Else we have room for more.
-      }
-    }
-
-    while (true) {
-      Tins::Packet packet(_wrapper->_sniffer->next_packet());
-      if (!packet) {
-        return;
-      }
-      _numPdus++;
-      avro::encode(*_wrapper->_encoder, packet);
-      switch (_stream->getState()) {
-      case BufferOutputStream::State::FULL:
-        // There wasn't enough room, we have to save the PDU until the next
-        // call (otherwise it will never be transmitted).
-        _wrapper->_packet = packet;
-        --_numPdus;
-      case BufferOutputStream::State::ALMOST_FULL:
-        return;
-      default:
-        // Otherwise, continue looping if the timeout hasn't been reached.
-        current = std::chrono::high_resolution_clock::now();
-        if (
-          _wrapper->_timeout &&
-          std::chrono::duration_cast<std::chrono::milliseconds>(current - start).count() > _wrapper->_timeout
-        ) {
-          return;
-        }
-      }
+    const char *err = _wrapper->fill(*_stream, _stats, _index, _oversized);
+    if (err) {
+      SetErrorMessage(err);
     }
   }
 
   void HandleOKCallback() {
     Nan::HandleScope scope;
-    // We have to call this to prevent the encoder from resetting the stream
-    // after it has been deleted.
-    _wrapper->_encoder->init(*_stream);
-    v8::Local<v8::Value> argv[] = {
-      Nan::Null(),
-      Nan::New<v8::Number>(_numPdus)
-    };
-    callback->Call(2, argv);
+    _wrapper->_fetching = false; // Before the callback, which may fetch again.
+    if (_oversized.empty()) {
+      v8::Local<v8::Value> argv[] = {
+        Nan::Null(),
+        Nan::New<v8::Number>(_stats.numPdus),
+        toObject(_stats),
+        toTypedArray<v8::Uint32Array>(_index.offsets),
+        toTypedArray<v8::Uint8Array>(_index.tags)
+      };
+      callback->Call(5, argv);
+    } else {
+      v8::Local<v8::Value> argv[] = {
+        Nan::Null(),
+        Nan::New<v8::Number>(_stats.numPdus),
+        toObject(_stats),
+        toTypedArray<v8::Uint32Array>(_index.offsets),
+        toTypedArray<v8::Uint8Array>(_index.tags),
+        Nan::CopyBuffer((char *) _oversized.data(), _oversized.size()).ToLocalChecked()
+      };
+      callback->Call(6, argv);
+    }
   }
 
   void HandleErrorCallback() {
     Nan::HandleScope scope;
-    _wrapper->_encoder->init(*_stream);
+    _wrapper->_fetching = false;
     v8::Local<v8::Value> argv[] = {
       v8::Exception::Error(Nan::New<v8::String>(ErrorMessage()).ToLocalChecked())
     };
@@ -168,9 +509,354 @@ public:
 private:
   Wrapper *_wrapper;
   std::unique_ptr<BufferOutputStream> _stream;
-  uint32_t _numPdus;
+  BatchStats _stats;
+  BatchIndex _index;
+  std::vector<uint8_t> _oversized;
+};
+
+/**
+ * Helper class to capture PDUs from a dedicated thread.
+ *
+ * The thread encodes batches back to back into a ring of buffers owned by
+ * JavaScript, and only wakes up the main loop (via an async handle) when
+ * batches are ready. This avoids a threadpool round-trip per batch and doesn't
+ * tie up one of libuv's few pool threads while blocking on the capture.
+ *
+ */
+class Capture {
+public:
+  struct Batch {
+    uint32_t index; // Position of the corresponding buffer in the ring.
+    uint8_t *data;
+    size_t len;
+    BatchStats stats;
+    BatchIndex pdus; // Offsets and tags of the PDUs in the buffer.
+    std::vector<uint8_t> oversized; // Set if the batch's PDU didn't fit its buffer.
+    const char *error;
+  };
+
+  Capture(
+    Wrapper *wrapper,
+    v8::Local<v8::Object> obj,
+    v8::Local<v8::Array> bufs,
+    Nan::Callback *callback
+  ) :
+  _wrapper(wrapper),
+  _obj(obj),
+  _bufs(bufs),
+  _callback(callback),
+  _batches(bufs->Length()),
+  _stopped(false) {
+    for (uint32_t i = 0; i < bufs->Length(); i++) {
+      v8::Local<v8::Object> buf = Nan::Get(bufs, i).ToLocalChecked()->ToObject();
+      Batch &batch = _batches.at(i);
+      batch.index = i;
+      batch.data = (uint8_t *) node::Buffer::Data(buf);
+      batch.len = node::Buffer::Length(buf);
+    }
+    uv_sem_init(&_free, bufs->Length());
+    uv_async_init(uv_default_loop(), &_async, Capture::onAsync);
+    _async.data = this;
+    _thread = std::thread(&Capture::run, this);
+  }
+
+  /**
+   * Stop the thread and release all resources.
+   *
+   * The instance is deleted asynchronously (once the async handle is closed),
+   * so it is safe to call this from inside a batch callback.
+   *
+   */
+  void stop() {
+    if (_stopped.exchange(true)) {
+      return;
+    }
+    // Unblock the thread whether it is waiting on a frame or a free buffer.
+    _wrapper->_source->interrupt();
+    uv_sem_post(&_free);
+    _thread.join();
+    _wrapper->_capture = NULL;
+    uv_close((uv_handle_t *) &_async, Capture::onClose);
+  }
+
+private:
+  Wrapper *_wrapper;
+  Nan::Persistent<v8::Object> _obj; // Keep the wrapper alive while capturing.
+  Nan::Persistent<v8::Array> _bufs;
+  std::unique_ptr<Nan::Callback> _callback;
+  Ring<Batch> _batches;
+  uv_sem_t _free; // Number of buffers available to the capture thread.
+  uv_async_t _async;
+  std::thread _thread;
+  std::atomic<bool> _stopped;
+
+  ~Capture() {
+    uv_sem_destroy(&_free);
+    _obj.Reset();
+    _bufs.Reset();
+  }
+
+  /**
+   * Capture thread loop.
+   *
+   */
+  void run() {
+    while (true) {
+      uv_sem_wait(&_free);
+      if (_stopped) {
+        return;
+      }
+      Batch &batch = *_batches.back();
+      BufferOutputStream stream(batch.data, batch.len, 0.9, _wrapper->_overflow);
+      batch.stats = BatchStats();
+      batch.pdus.clear();
+      batch.oversized.clear();
+      batch.error = _wrapper->fill(stream, batch.stats, batch.pdus, batch.oversized);
+      _batches.push();
+      uv_async_send(&_async);
+      if (batch.error) {
+        return;
+      }
+    }
+  }
+
+  /**
+   * Forward all ready batches to JavaScript (on the main thread).
+   *
+   */
+  void drain() {
+    Nan::HandleScope scope;
+    Batch *batch;
+    while (!_stopped && (batch = _batches.front())) {
+      if (batch->error) {
+        v8::Local<v8::Value> argv[] = {
+          v8::Exception::Error(Nan::New<v8::String>(batch->error).ToLocalChecked())
+        };
+        _callback->Call(1, argv);
+      } else if (batch->oversized.empty()) {
+        v8::Local<v8::Value> argv[] = {
+          Nan::Null(),
+          Nan::New<v8::Number>(batch->index),
+          Nan::New<v8::Number>(batch->stats.numPdus),
+          toObject(batch->stats),
+          toTypedArray<v8::Uint32Array>(batch->pdus.offsets),
+          toTypedArray<v8::Uint8Array>(batch->pdus.tags)
+        };
+        _callback->Call(6, argv);
+      } else {
+        v8::Local<v8::Value> argv[] = {
+          Nan::Null(),
+          Nan::New<v8::Number>(batch->index),
+          Nan::New<v8::Number>(batch->stats.numPdus),
+          toObject(batch->stats),
+          toTypedArray<v8::Uint32Array>(batch->pdus.offsets),
+          toTypedArray<v8::Uint8Array>(batch->pdus.tags),
+          Nan::CopyBuffer(
+            (char *) batch->oversized.data(),
+            batch->oversized.size()
+          ).ToLocalChecked()
+        };
+        _callback->Call(7, argv);
+      }
+      _batches.pop();
+      uv_sem_post(&_free);
+    }
+  }
+
+  static void onAsync(uv_async_t *handle) {
+    static_cast<Capture *>(handle->data)->drain();
+  }
+
+  static void onClose(uv_handle_t *handle) {
+    delete static_cast<Capture *>(handle->data);
+  }
 };
 
+const char *Wrapper::fill(
+  BufferOutputStream &stream,
+  BatchStats &stats,
+  BatchIndex &index,
+  std::vector<uint8_t> &oversized
+) {
+  _converter.clearMatches();
+  stats.numMatches = _converter.numMatches(); // In case we return early.
+  stats.samplingRate = _sampler.rate();
+  if (_mode == Mode::COLUMNS || _mode == Mode::ARROW) {
+    return fillColumns(stream, stats);
+  }
+  if (_mode == Mode::FLOWS || _mode == Mode::STATIONS) {
+    return fillAggregates(stream, stats, index);
+  }
+  if (!_spill.empty()) {
+    // Last batch's overflowing PDU, already encoded (and counted as matching
+    // in the previous batch).
+    stats.numPdus = 1;
+    index.push(0, _spillTag);
+    bool fits = stream.write(_spill.data(), _spill.size());
+    if (!fits) {
+      oversized.swap(_spill); // It would never fit, send it on its own.
+    }
+    _spill.clear();
+    if (!fits || stream.getState() != BufferOutputStream::State::ALMOST_EMPTY) {
+      stats.numBytes = fits ? stream.byteCount() : oversized.size();
+      return NULL;
+    }
+  }
+
+  BatchWriter writer(
+    _converter,
+    _mode == Mode::RAW,
+    stream,
+    stats,
+    index,
+    _spill,
+    _spillTag
+  );
+  uint32_t numBufferGrowths = _converter.numBufferGrowths();
+  const char *err = dispatch(writer, stats);
+  if (err) {
+    return err;
+  }
+  stats.numBufferGrowths = _converter.numBufferGrowths() - numBufferGrowths;
+  stats.numMatches = _converter.numMatches();
+
+  if (!stats.numPdus && !_spill.empty()) {
+    // The very first PDU overflowed, waiting for the next batch won't help.
+    stats.numPdus = 1;
+    index.push(0, _spillTag);
+    oversized.swap(_spill);
+    _spill.clear();
+  }
+  stats.numBytes = oversized.empty() ? stream.byteCount() : oversized.size();
+  return NULL;
+}
+
+const char *Wrapper::fillColumns(BufferOutputStream &stream, BatchStats &stats) {
+  uint8_t *data = stream.data();
+  size_t pad = (8 - ((uintptr_t) data & 7)) & 7; // Typed arrays need alignment.
+  if (stream.length() < pad + _columns.minSize()) {
+    return "batch too small";
+  }
+  size_t len = stream.length() - pad;
+
+  ColumnWriter writer(_converter, _columns, len);
+  if (!writer.full()) { // Otherwise rows left from the last batch fill this one.
+    const char *err = dispatch(writer, stats);
+    if (err) {
+      return err;
+    }
+  }
+  stats.numMatches = _converter.numMatches();
+  size_t numBytes;
+  stats.numPdus = _columns.flush(data + pad, len, numBytes);
+  stats.numBytes = pad + numBytes;
+  return NULL;
+}
+
+const char *Wrapper::fillAggregates(
+  BufferOutputStream &stream,
+  BatchStats &stats,
+  BatchIndex &index
+) {
+  bool flows = _mode == Mode::FLOWS;
+  if (stream.length() < (flows ? LAYER2_MAX_FLOW_SIZE : LAYER2_MAX_STATION_SIZE)) {
+    return "batch too small";
+  }
+
+  FlowWriter flowWriter(_converter, _flows, stream.length());
+  StationWriter stationWriter(_converter, _stations, stream.length());
+  BatchHandler &writer = flows ? (BatchHandler &) flowWriter : stationWriter;
+  bool dispatched = !writer.full(); // Otherwise left over records fill it.
+  if (dispatched) {
+    const char *err = dispatch(writer, stats);
+    if (err) {
+      return err;
+    }
+  }
+  stats.numMatches = _converter.numMatches();
+  if (
+    dispatched && !stats.numFrames &&
+    (_source->live() || _source->exhausted())
+  ) {
+    // The link was idle (or the file is exhausted), frames' timestamps alone
+    // won't move time forward. Files which merely returned a short read will
+    // catch up on the next batch.
+    int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+    if (flows) {
+      _flows.sweep(now);
+    } else {
+      _stations.tick(now);
+    }
+  }
+
+  if (flows) {
+    writeRecords(
+      _flows.expired(),
+      encodeFlow,
+      LAYER2_MAX_FLOW_SIZE,
+      frameTag(Pdu::frame_t::Ethernet2_index),
+      stream,
+      stats,
+      index
+    );
+  } else {
+    writeRecords(
+      _stations.snapshots(),
+      encodeStation,
+      LAYER2_MAX_STATION_SIZE,
+      frameTag(Pdu::frame_t::Radiotap_index),
+      stream,
+      stats,
+      index
+    );
+  }
+  stats.numBytes = stream.byteCount();
+  return NULL;
+}
+
+const char *Wrapper::dispatch(BatchHandler &handler, BatchStats &stats) {
+  std::chrono::time_point<std::chrono::steady_clock> deadline;
+  deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(_timeout);
+  int timeout = _timeout ? _timeout : -1;
+  SamplingHandler sampled(handler, _sampler, stats);
+  BatchHandler &target = _sampler.enabled() ? sampled : handler;
+  uint32_t numDuplicates = _converter.numDuplicates();
+  uint64_t allocations = numAllocations();
+
+  try {
+    while (true) {
+      uint32_t numFrames = _source->dispatch(target, timeout);
+      if (numFrames) {
+        stats.numFrames += numFrames;
+        stats.numDispatches++;
+      }
+      if (handler.full() || !numFrames) {
+        break; // Full batch, timeout, interruption, or end of file.
+      }
+      if (_timeout) {
+        int64_t remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+          deadline - std::chrono::steady_clock::now()
+        ).count();
+        if (remaining <= 0) {
+          break;
+        }
+        timeout = remaining;
+      }
+    }
+  } catch (std::runtime_error &err) {
+    _error = err.what();
+    return _error.c_str();
+  }
+  if (!_sampler.enabled()) {
+    stats.numSampled = stats.numFrames;
+  }
+  stats.numDuplicates += _converter.numDuplicates() - numDuplicates;
+  stats.numAllocations += numAllocations() - allocations;
+  return NULL;
+}
+
 // v8 exposed functions.
 
 /**
@@ -190,7 +876,10 @@ NAN_METHOD(Wrapper::Empty) {}
  */
 NAN_METHOD(Wrapper::Destroy) {
   Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
-  wrapper->_sniffer.reset();
+  if (wrapper->_capture) {
+    wrapper->_capture->stop();
+  }
+  wrapper->_source.reset();
 }
 
 NAN_METHOD(Wrapper::FromInterface) {
@@ -236,15 +925,90 @@ NAN_METHOD(Wrapper::FromInterface) {
     config.set_filter(std::string(*filter));
   }
 
-  Tins::Sniffer *sniffer;
+  Source *source;
+  try {
+    source = new PcapSource(new Tins::Sniffer(*dev, config), true);
+  } catch (std::runtime_error &err) {
+    Nan::ThrowError(err.what());
+    return;
+  }
+
+  Wrapper *wrapper = new Wrapper(source, timeout);
+  wrapper->Wrap(info.This());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::FromTpacket) {
+  if (
+    info.Length() != 10 ||
+    !info[0]->IsString() ||
+    !(info[1]->IsUndefined() || info[1]->IsUint32()) ||   // snaplen
+    !(info[2]->IsUndefined() || info[2]->IsBoolean()) ||  // promisc
+    !(info[3]->IsUndefined() || info[3]->IsUint32()) ||   // timeout
+    !(info[4]->IsUndefined() || info[4]->IsUint32()) ||   // blockSize
+    !(info[5]->IsUndefined() || info[5]->IsUint32()) ||   // blockCount
+    !(info[6]->IsUndefined() || info[6]->IsUint32()) ||   // blockTimeout
+    !(info[7]->IsUndefined() || info[7]->IsString()) ||   // filter
+    !(info[8]->IsUndefined() || info[8]->IsUint32()) ||   // fanoutGroup
+    !(info[9]->IsUndefined() || info[9]->IsString())      // fanoutMode
+  ) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Nan::Utf8String dev(info[0]);
+
+  TpacketConfiguration config;
+  uint32_t timeout = 0;
+  if (!info[1]->IsUndefined()) {
+    config.snapLen = info[1]->Uint32Value();
+  }
+  if (!info[2]->IsUndefined()) {
+    config.promisc = info[2]->BooleanValue();
+  }
+  if (!info[3]->IsUndefined()) {
+    timeout = info[3]->Uint32Value();
+  }
+  if (!info[4]->IsUndefined()) {
+    config.blockSize = info[4]->Uint32Value();
+  }
+  if (!info[5]->IsUndefined()) {
+    config.blockCount = info[5]->Uint32Value();
+  }
+  if (!info[6]->IsUndefined()) {
+    config.blockTimeout = info[6]->Uint32Value();
+  }
+  if (!info[7]->IsUndefined()) {
+    Nan::Utf8String filter(info[7]);
+    config.filter = std::string(*filter);
+  }
+  if (!info[9]->IsUndefined()) {
+    Nan::Utf8String mode(info[9]);
+    std::string name(*mode);
+    if (name == "hash") {
+      config.fanoutMode = FanoutMode::HASH;
+    } else if (name == "cpu") {
+      config.fanoutMode = FanoutMode::CPU;
+    } else if (name == "lb") {
+      config.fanoutMode = FanoutMode::LB;
+    } else {
+      Nan::ThrowError("invalid fanout mode");
+      return;
+    }
+    if (!info[8]->IsUndefined()) {
+      config.fanoutGroup = info[8]->Uint32Value() & 0xffff;
+    }
+  }
+
+  Source *source;
   try {
-    sniffer = new Tins::Sniffer(*dev, config);
+    source = new TpacketSniffer(*dev, config);
   } catch (std::runtime_error &err) {
     Nan::ThrowError(err.what());
     return;
   }
 
-  Wrapper *wrapper = new Wrapper(sniffer, timeout);
+  Wrapper *wrapper = new Wrapper(source, timeout);
   wrapper->Wrap(info.This());
   info.GetReturnValue().Set(info.This());
 }
@@ -268,19 +1032,235 @@ NAN_METHOD(Wrapper::FromFile) {
     config.set_filter(std::string(*filter));
   }
 
-  Tins::FileSniffer *sniffer;
+  Source *source;
   try {
-    sniffer = new Tins::FileSniffer(*path, config);
+    source = new PcapSource(new Tins::FileSniffer(*path, config), false);
   } catch (std::runtime_error &err) {
     Nan::ThrowError(err.what());
     return;
   }
 
-  Wrapper *wrapper = new Wrapper(sniffer, 0);
+  Wrapper *wrapper = new Wrapper(source, 0);
   wrapper->Wrap(info.This());
   info.GetReturnValue().Set(info.This());
 }
 
+NAN_METHOD(Wrapper::SetParser) {
+  if (info.Length() != 1 || !info[0]->IsString()) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  Nan::Utf8String parser(info[0]);
+  std::string name(*parser);
+  if (name == "tins") {
+    wrapper->_converter.setParser(Parser::TINS);
+  } else if (name == "native") {
+    wrapper->_converter.setParser(Parser::NATIVE);
+  } else {
+    Nan::ThrowError("invalid parser");
+    return;
+  }
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::SetMode) {
+  if (info.Length() != 1 || !info[0]->IsString()) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  Nan::Utf8String mode(info[0]);
+  std::string name(*mode);
+  if (name == "pdu") {
+    wrapper->_mode = Mode::PDU;
+  } else if (name == "raw") {
+    wrapper->_mode = Mode::RAW;
+  } else if (name == "columns") {
+    wrapper->_mode = Mode::COLUMNS;
+    wrapper->_columns.setFormat(Columns::Format::NATIVE);
+  } else if (name == "arrow") {
+    wrapper->_mode = Mode::ARROW;
+    wrapper->_columns.setFormat(Columns::Format::ARROW);
+  } else if (name == "flows") {
+    wrapper->_mode = Mode::FLOWS;
+  } else if (name == "stations") {
+    wrapper->_mode = Mode::STATIONS;
+  } else {
+    Nan::ThrowError("invalid mode");
+    return;
+  }
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::SetPayloadSnap) {
+  if (info.Length() != 1 || !info[0]->IsUint32()) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  wrapper->_converter.setPayloadSnap(info[0]->Uint32Value());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::SetFlowTimeouts) {
+  if (
+    info.Length() != 2 ||
+    !(info[0]->IsUndefined() || info[0]->IsUint32()) ||  // idleTimeout
+    !(info[1]->IsUndefined() || info[1]->IsUint32())     // activeTimeout
+  ) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  if (!info[0]->IsUndefined()) {
+    if (!info[0]->Uint32Value()) {
+      Nan::ThrowError("invalid idle timeout");
+      return;
+    }
+    wrapper->_flows.setIdleTimeout(info[0]->Uint32Value());
+  }
+  if (!info[1]->IsUndefined()) {
+    wrapper->_flows.setActiveTimeout(info[1]->Uint32Value());
+  }
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::SetStationInterval) {
+  if (info.Length() != 1 || !info[0]->IsUint32() || !info[0]->Uint32Value()) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  wrapper->_stations.setInterval(info[0]->Uint32Value());
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::SetSampling) {
+  if (info.Length() != 2 || !info[0]->IsString() || !info[1]->IsNumber()) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  Nan::Utf8String method(info[0]);
+  std::string name(*method);
+  SamplingMethod samplingMethod;
+  if (name == "none") {
+    samplingMethod = SamplingMethod::NONE;
+  } else if (name == "count") {
+    samplingMethod = SamplingMethod::COUNT;
+  } else if (name == "random") {
+    samplingMethod = SamplingMethod::RANDOM;
+  } else if (name == "hash") {
+    samplingMethod = SamplingMethod::HASH;
+  } else {
+    Nan::ThrowError("invalid sampling method");
+    return;
+  }
+  try {
+    wrapper->_sampler.configure(samplingMethod, info[1]->NumberValue());
+  } catch (std::runtime_error &err) {
+    Nan::ThrowError(err.what());
+    return;
+  }
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::SetDedup) {
+  if (info.Length() != 1 || !info[0]->IsString()) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  Nan::Utf8String mode(info[0]);
+  std::string name(*mode);
+  if (name == "none") {
+    wrapper->_converter.setDedup(DedupMode::NONE);
+  } else if (name == "drop") {
+    wrapper->_converter.setDedup(DedupMode::DROP);
+  } else if (name == "tag") {
+    wrapper->_converter.setDedup(DedupMode::TAG);
+  } else {
+    Nan::ThrowError("invalid dedup mode");
+    return;
+  }
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::SetPredicates) {
+  if (info.Length() != 1 || !info[0]->IsArray()) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  v8::Local<v8::Array> exprs = info[0].As<v8::Array>();
+  std::vector<Predicate> predicates;
+  for (uint32_t i = 0; i < exprs->Length(); i++) {
+    v8::Local<v8::Value> expr = Nan::Get(exprs, i).ToLocalChecked();
+    if (!expr->IsString()) {
+      Nan::ThrowError("invalid arguments");
+      return;
+    }
+    Nan::Utf8String str(expr);
+    try {
+      predicates.push_back(Predicate(std::string(*str)));
+    } catch (std::runtime_error &err) {
+      Nan::ThrowError(err.what());
+      return;
+    }
+  }
+  wrapper->_converter.setPredicates(predicates);
+  info.GetReturnValue().Set(info.This());
+}
+
+NAN_METHOD(Wrapper::GetArrowSchema) {
+  std::vector<uint8_t> schema;
+  Columns::arrowSchema(schema);
+  info.GetReturnValue().Set(
+    Nan::CopyBuffer((char *) schema.data(), schema.size()).ToLocalChecked()
+  );
+}
+
 NAN_METHOD(Wrapper::GetPdus) {
   if (
     info.Length() != 2 ||
@@ -292,6 +1272,16 @@ NAN_METHOD(Wrapper::GetPdus) {
   }
 
   Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (!wrapper->_source) {
+    Nan::ThrowError("destroyed");
+    return;
+  }
+  if (wrapper->capturing()) {
+    // Batches can only be filled from one thread at a time.
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  wrapper->_fetching = true;
   Nan::Callback *callback = new Nan::Callback(info[1].As<v8::Function>());
   Worker *worker = new Worker(wrapper, info[0], callback);
   worker->SaveToPersistent("buffer", info[0]);
@@ -299,6 +1289,50 @@ NAN_METHOD(Wrapper::GetPdus) {
   Nan::AsyncQueueWorker(worker);
 }
 
+NAN_METHOD(Wrapper::Start) {
+  if (
+    info.Length() != 2 ||
+    !info[0]->IsArray() ||
+    !info[1]->IsFunction()
+  ) {
+    Nan::ThrowError("invalid arguments");
+    return;
+  }
+
+  v8::Local<v8::Array> bufs = info[0].As<v8::Array>();
+  if (!bufs->Length()) {
+    Nan::ThrowError("empty ring");
+    return;
+  }
+  for (uint32_t i = 0; i < bufs->Length(); i++) {
+    if (!node::Buffer::HasInstance(Nan::Get(bufs, i).ToLocalChecked())) {
+      Nan::ThrowError("invalid arguments");
+      return;
+    }
+  }
+
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (!wrapper->_source) {
+    Nan::ThrowError("destroyed");
+    return;
+  }
+  if (wrapper->capturing()) {
+    Nan::ThrowError("already capturing");
+    return;
+  }
+  Nan::Callback *callback = new Nan::Callback(info[1].As<v8::Function>());
+  wrapper->_capture = new Capture(wrapper, info.This(), bufs, callback);
+}
+
+NAN_METHOD(Wrapper::Stop) {
+  Wrapper *wrapper = ObjectWrap::Unwrap<Wrapper>(info.This());
+  if (wrapper->_capture) {
+    wrapper->_capture->stop();
+  } else if (wrapper->_source) {
+    wrapper->_source->interrupt();
+  }
+}
+
 /**
  * Initializer, returns the `Wrapper` JavaScript function template.
  *
@@ -309,7 +1343,19 @@ v8::Local<v8::FunctionTemplate> Wrapper::Init() {
   tpl->InstanceTemplate()->SetInternalFieldCount(1);
   Nan::SetPrototypeMethod(tpl, "destroy", Wrapper::Destroy);
   Nan::SetPrototypeMethod(tpl, "getPdus", Wrapper::GetPdus);
+  Nan::SetPrototypeMethod(tpl, "start", Wrapper::Start);
+  Nan::SetPrototypeMethod(tpl, "stop", Wrapper::Stop);
+  Nan::SetPrototypeMethod(tpl, "setParser", Wrapper::SetParser);
+  Nan::SetPrototypeMethod(tpl, "setMode", Wrapper::SetMode);
+  Nan::SetPrototypeMethod(tpl, "setPredicates", Wrapper::SetPredicates);
+  Nan::SetPrototypeMethod(tpl, "setPayloadSnap", Wrapper::SetPayloadSnap);
+  Nan::SetPrototypeMethod(tpl, "setSampling", Wrapper::SetSampling);
+  Nan::SetPrototypeMethod(tpl, "setDedup", Wrapper::SetDedup);
+  Nan::SetPrototypeMethod(tpl, "setFlowTimeouts", Wrapper::SetFlowTimeouts);
+  Nan::SetPrototypeMethod(tpl, "setStationInterval", Wrapper::SetStationInterval);
+  Nan::SetPrototypeMethod(tpl, "getArrowSchema", Wrapper::GetArrowSchema);
   Nan::SetPrototypeMethod(tpl, "fromInterface", Wrapper::FromInterface);
+  Nan::SetPrototypeMethod(tpl, "fromTpacket", Wrapper::FromTpacket);
   Nan::SetPrototypeMethod(tpl, "fromFile", Wrapper::FromFile);
   return tpl;
 }
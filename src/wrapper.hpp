@@ -1,13 +1,70 @@
 #pragma once
 
+#include "codecs.hpp"
+#include "columns.hpp"
+#include "flows.hpp"
+#include "sampling.hpp"
+#include "sources.hpp"
+#include "stations.hpp"
 #include <nan.h>
 #include <tins/tins.h>
-#include <avro/Encoder.hh>
+#include <vector>
 
 namespace Layer2 {
 
+class BatchHandler;
+class BufferOutputStream;
+class Capture;
+
+/**
+ * Information about a single batch of PDUs.
+ *
+ */
+struct BatchStats {
+  uint32_t numPdus; // PDUs encoded in the batch.
+  uint32_t numFrames; // Frames read from the source (malformed ones included).
+  uint32_t numSampled; // Frames kept by the sampler (all of them if disabled).
+  double samplingRate; // Expected fraction of frames kept by the sampler.
+  uint32_t numDispatches; // Calls to the source which returned frames.
+  uint32_t numBufferGrowths; // Times the converter's storage grew.
+  uint32_t numAllocations; // Heap allocations while reading frames.
+  uint32_t numDuplicates; // Retransmitted frames detected (see `SetDedup`).
+  uint32_t numBytes; // Bytes of PDUs in the batch (wherever they are written).
+  std::vector<uint32_t> numMatches; // Frames matched by each predicate.
+
+  BatchStats() :
+  numPdus(0),
+  numFrames(0),
+  numSampled(0),
+  samplingRate(1),
+  numDispatches(0),
+  numBufferGrowths(0),
+  numAllocations(0),
+  numDuplicates(0),
+  numBytes(0) {}
+};
+
 /**
- * Class wrapping tin's Sniffer.
+ * Start offset and frame type tag (see `frameTag`) of each PDU in a batch.
+ *
+ */
+struct BatchIndex {
+  std::vector<uint32_t> offsets;
+  std::vector<uint8_t> tags;
+
+  void push(uint32_t offset, uint8_t tag) {
+    offsets.push_back(offset);
+    tags.push_back(tag);
+  }
+
+  void clear() { // Capacity is kept, to avoid reallocating.
+    offsets.clear();
+    tags.clear();
+  }
+};
+
+/**
+ * Class wrapping a source of frames (tin's sniffers or our TPACKET_V3 one).
  *
  * It won't be exposed directly from the JavaScript API but rather called from
  * an `EventEmitter` to keep the API simpler (otherwise users would have to
@@ -28,21 +85,98 @@ public:
 
 private:
   friend class Worker;
+  friend class Capture;
+
+  /**
+   * What batches contain (see `SetMode`).
+   *
+   */
+  enum class Mode { PDU, RAW, COLUMNS, ARROW, FLOWS, STATIONS };
 
-  std::unique_ptr<Tins::BaseSniffer> _sniffer;
-  avro::EncoderPtr _encoder;
-  Tins::Packet _packet; // Used to store last PDU in case of overflow.
+  std::unique_ptr<Source> _source;
+  Converter _converter;
+  Sampler _sampler;
+  Mode _mode;
   uint32_t _timeout;
+  Capture *_capture; // Only set when capturing from a dedicated thread.
+  bool _fetching; // Set while a worker is filling a batch.
+  std::string _error; // Storage for the last capture error's message.
+  std::vector<uint8_t> _overflow; // Scratch space for bytes past a batch.
+  std::vector<uint8_t> _spill; // Encoded PDU carried over to the next batch.
+  uint8_t _spillTag; // Frame type tag of the PDU in `_spill`.
+  Columns _columns; // Rows carried over to the next batch, in columnar modes.
+  FlowTable _flows; // Only used in flows mode.
+  StationTable _stations; // Only used in stations mode.
 
-  Wrapper(Tins::BaseSniffer *sniffer, uint32_t timeout) :
-  _sniffer(sniffer),
-  _packet(),
-  _timeout(timeout) {
-    _encoder = avro::binaryEncoder();
-  }
+  Wrapper(Source *source, uint32_t timeout) :
+  _source(source),
+  _mode(Mode::PDU),
+  _timeout(timeout),
+  _capture(NULL),
+  _fetching(false),
+  _spillTag(0) {}
 
   ~Wrapper() {}
 
+  /**
+   * Whether batches are being filled, either by a worker or by a dedicated
+   * thread. The wrapper's configuration must not change meanwhile.
+   *
+   */
+  bool capturing() const { return _capture || _fetching; }
+
+  /**
+   * Encode PDUs into a stream until it is full or the timeout expires.
+   *
+   * This is shared by both capture modes (asynchronous workers and dedicated
+   * thread) and must only be called from one thread at a time. Information
+   * about the batch is stored in `stats`, an error message is returned if the
+   * batch failed (`NULL` otherwise).
+   *
+   * Each PDU in the stream is added to `index`. A PDU too large to ever fit
+   * in the stream is stored in `oversized` instead, as the batch's only PDU
+   * (at offset 0).
+   *
+   * In columnar modes, the stream's buffer holds a single columnar batch
+   * instead (see `Columns`, starting at the buffer's first 8-byte aligned
+   * address), `stats.numPdus` is its number of rows, and `index` is left
+   * empty.
+   *
+   * In flows (resp. stations) mode, frames are aggregated into `_flows` (resp.
+   * `_stations`) instead and the batch holds Avro-encoded `Flow` records for
+   * the flows which expired (resp. `Station` records of the latest snapshots),
+   * indexed as PDUs are.
+   *
+   */
+  const char *fill(
+    BufferOutputStream &stream,
+    BatchStats &stats,
+    BatchIndex &index,
+    std::vector<uint8_t> &oversized
+  );
+
+  /**
+   * Feed frames to a handler until it is full or the timeout expires.
+   *
+   */
+  const char *dispatch(BatchHandler &handler, BatchStats &stats);
+
+  /**
+   * Columnar modes' counterpart to `fill`.
+   *
+   */
+  const char *fillColumns(BufferOutputStream &stream, BatchStats &stats);
+
+  /**
+   * Aggregating modes' counterpart to `fill`.
+   *
+   */
+  const char *fillAggregates(
+    BufferOutputStream &stream,
+    BatchStats &stats,
+    BatchIndex &index
+  );
+
   /**
    * Required function constructor.
    *
@@ -58,19 +192,151 @@ private:
   /**
    * Prototype method which will take in a buffer and a callback.
    *
-   * The buffer will be populated with Avro-encoded PDUs. The callback will
-   * take in two arguments, an eventual error and the total number of PDUs
-   * successfully written to the input buffer.
+   * The buffer will be populated with a batch of Avro-encoded PDUs (or of
+   * other records, depending on the mode, see `SetMode`). The callback will
+   * take in five arguments:
+   *
+   * + An eventual error.
+   * + The number of PDUs successfully written to the buffer.
+   * + The batch's statistics (see `BatchStats`): the number of `frames` read,
+   *   how many were `sampled` and the `samplingRate`, the `dispatches` it
+   *   took, the `bufferGrowths` conversions caused, the heap `allocations`
+   *   made while reading frames (see `numAllocations`), the number of
+   *   `duplicates` detected, the number of `bytes` written, and an array of
+   *   how many frames each predicate `matches`.
+   * + A `Uint32Array` of each PDU's starting offset (so that they can be
+   *   decoded out of order).
+   * + A `Uint8Array` of their frame type tags (see `frameTag`).
+   *
+   * If the batch's PDU is too large to fit in the buffer, it is passed in a
+   * newly allocated buffer as sixth argument instead.
+   *
+   * It throws if a batch is already pending, if a dedicated thread is
+   * capturing, or if the wrapper was destroyed.
    *
    */
   static NAN_METHOD(GetPdus);
 
+  /**
+   * Prototype method to start capturing from a dedicated thread.
+   *
+   * It takes in an array of buffers, used as a ring of batches, and a callback
+   * which will be called with an eventual error, the index of the buffer just
+   * populated, then the same arguments as `GetPdus`' callback (the number of
+   * PDUs, statistics, offsets, tags, and eventual oversized PDU's buffer). The
+   * buffer will be reused as soon as the callback returns.
+   *
+   * It throws if a capture (from either mode) is already running or if the
+   * wrapper was destroyed.
+   *
+   */
+  static NAN_METHOD(Start);
+
+  /**
+   * Stop capturing.
+   *
+   * Any pending read returns immediately. If a dedicated capture thread is
+   * running, this also blocks until it has exited; no more callbacks will be
+   * called afterwards.
+   *
+   */
+  static NAN_METHOD(Stop);
+
+  /**
+   * Prototype method to choose how frames are parsed (`'tins'`, the default,
+   * or `'native'`, see `Parser` for how they differ). It must not be called
+   * while a capture is running.
+   *
+   */
+  static NAN_METHOD(SetParser);
+
+  /**
+   * Prototype method to choose what batches contain: `'pdu'` (the default)
+   * for Avro-encoded PDUs, `'raw'` for frames as captured (see `encodeRaw`),
+   * `'columns'` for a columnar layout of the frames' main fields (see
+   * `Columns`), `'arrow'` for the same fields as Arrow IPC record batch
+   * messages, `'flows'` for records of Ethernet II flows (see `FlowTable`), or
+   * `'stations'` for snapshots of 802.11 stations (see `StationTable`). It
+   * must not be called while a capture is running.
+   *
+   */
+  static NAN_METHOD(SetMode);
+
+  /**
+   * Prototype method to only keep frames matching at least one of an array of
+   * predicates (see `Predicate` for their syntax). Each batch's statistics
+   * then include the number of frames each predicate `matches`. It must not
+   * be called while a capture is running.
+   *
+   */
+  static NAN_METHOD(SetPredicates);
+
+  /**
+   * Prototype method to cap how many bytes of ethernet frames' payloads are
+   * written (in both PDUs and columns). It must not be called while a capture
+   * is running.
+   *
+   */
+  static NAN_METHOD(SetPayloadSnap);
+
+  /**
+   * Prototype method to only keep a sample of frames, before they are parsed
+   * (and before predicates are evaluated). It takes in a method (`'none'`,
+   * `'count'`, `'random'`, or `'hash'`, see `Sampler`) and the fraction of
+   * frames to keep. Each batch's statistics then include the number of frames
+   * `sampled` and the effective `samplingRate`. It must not be called while a
+   * capture is running.
+   *
+   */
+  static NAN_METHOD(SetSampling);
+
+  /**
+   * Prototype method to choose what happens to retransmitted 802.11 frames
+   * (see `Deduplicator`): `'none'` (the default) to not look for them,
+   * `'drop'` to discard them, or `'tag'` to keep them with
+   * `LAYER2_DUPLICATE_TAG` set in their tag (only in `'pdu'` and `'raw'`
+   * modes, they are kept as is in others). Either way, each batch's
+   * statistics include the number of `duplicates` detected. It must not be
+   * called while a capture is running.
+   *
+   */
+  static NAN_METHOD(SetDedup);
+
+  /**
+   * Prototype method to set the idle and active timeouts (in milliseconds) of
+   * flows, in `'flows'` mode (either can be undefined to keep its current
+   * value). It must not be called while a capture is running.
+   *
+   */
+  static NAN_METHOD(SetFlowTimeouts);
+
+  /**
+   * Prototype method to set how often (in milliseconds) stations are
+   * snapshotted, in `'stations'` mode. It must not be called while a capture
+   * is running.
+   *
+   */
+  static NAN_METHOD(SetStationInterval);
+
+  /**
+   * Prototype method returning a buffer with the Arrow IPC schema message
+   * matching batches in `'arrow'` mode (to start a stream with).
+   *
+   */
+  static NAN_METHOD(GetArrowSchema);
+
   /**
    * Factory method to create a `Tins::Sniffer` (live capture).
    *
    */
   static NAN_METHOD(FromInterface);
 
+  /**
+   * Factory method to create a `TpacketSniffer` (live capture, Linux only).
+   *
+   */
+  static NAN_METHOD(FromTpacket);
+
   /**
    * Factor method to create a `Tins::FileSniffer`.
    *
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <avro/Stream.hh>
+#include <stdexcept>
+#include <stdint.h>
+#include <string.h>
+#include <string>
+
+namespace Layer2 {
+
+// Longest possible varint (a 64-bit value takes at most 10 7-bit groups).
+#define LAYER2_MAX_VARINT_SIZE 10
+
+/**
+ * Avro binary writer, encoding values straight into an output stream's chunks.
+ *
+ * This produces the same bytes as avro's binary encoder but all writes are
+ * inlined (avro's go through a virtual call per value, then through its
+ * stream writer). The stream itself is only called when the current chunk is
+ * exhausted.
+ *
+ * Arrays and unions are written by hand: `writeArrayStart` (with the actual
+ * number of items, which must be known upfront) then each item, and
+ * `writeUnionIndex` followed by the branch's value.
+ *
+ */
+class Writer {
+public:
+  Writer(avro::OutputStream &stream) : _stream(stream), _next(NULL), _end(NULL) {}
+
+  ~Writer() { flush(); }
+
+  void writeBoolean(bool b) {
+    if (_next == _end) {
+      refill();
+    }
+    *_next++ = b ? 1 : 0;
+  }
+
+  void writeInt(int32_t n) { writeLong(n); } // Zig-zag encoding matches.
+
+  void writeLong(int64_t n) {
+    uint64_t z = ((uint64_t) n << 1) ^ (uint64_t) (n >> 63);
+    if (_end - _next >= LAYER2_MAX_VARINT_SIZE) {
+      _next = writeVarint(_next, z);
+    } else {
+      uint8_t buf[LAYER2_MAX_VARINT_SIZE];
+      writeRaw(buf, writeVarint(buf, z) - buf);
+    }
+  }
+
+  void writeEnum(size_t index) { writeLong(index); }
+
+  void writeUnionIndex(size_t index) { writeLong(index); }
+
+  void writeArrayStart(size_t count) {
+    if (count) {
+      writeLong(count);
+    }
+  }
+
+  void writeArrayEnd() { writeLong(0); }
+
+  void writeFloat(float f) {
+    uint8_t buf[sizeof(f)]; // Little-endian, as avro assumes.
+    memcpy(buf, &f, sizeof(f));
+    writeRaw(buf, sizeof(f));
+  }
+
+  void writeDouble(double d) {
+    uint8_t buf[sizeof(d)];
+    memcpy(buf, &d, sizeof(d));
+    writeRaw(buf, sizeof(d));
+  }
+
+  void writeFixed(const uint8_t *data, size_t len) { writeRaw(data, len); }
+
+  /**
+   * Write a fixed whose size is known at compile time (a single copy in the
+   * common case where it fits in the current chunk).
+   *
+   */
+  template <size_t N>
+  void writeFixed(const uint8_t *data) {
+    if ((size_t) (_end - _next) >= N) {
+      memcpy(_next, data, N);
+      _next += N;
+    } else {
+      writeRaw(data, N);
+    }
+  }
+
+  void writeBytes(const uint8_t *data, size_t len) {
+    writeLong(len);
+    writeRaw(data, len);
+  }
+
+  void writeString(const std::string &s) {
+    writeBytes((const uint8_t *) s.data(), s.size());
+  }
+
+  /**
+   * Hand back the unused part of the current chunk to the stream, so that its
+   * byte count matches what was written so far.
+   *
+   */
+  void flush() {
+    if (_next != _end) {
+      _stream.backup(_end - _next);
+    }
+    _next = _end = NULL;
+  }
+
+private:
+  avro::OutputStream &_stream;
+  uint8_t *_next;
+  uint8_t *_end;
+
+  static uint8_t *writeVarint(uint8_t *dst, uint64_t z) {
+    while (z & ~0x7fULL) {
+      *dst++ = (uint8_t) ((z & 0x7f) | 0x80);
+      z >>= 7;
+    }
+    *dst++ = (uint8_t) z;
+    return dst;
+  }
+
+  void writeRaw(const uint8_t *data, size_t len) {
+    while (len) {
+      if (_next == _end) {
+        refill();
+      }
+      size_t n = _end - _next;
+      if (n > len) {
+        n = len;
+      }
+      memcpy(_next, data, n);
+      _next += n;
+      data += n;
+      len -= n;
+    }
+  }
+
+  void refill() {
+    size_t len = 0;
+    while (!len) {
+      if (!_stream.next(&_next, &len)) {
+        throw std::runtime_error("output stream exhausted");
+      }
+    }
+    _end = _next + len;
+  }
+};
+
+}
@@ -4,7 +4,13 @@
 
 var sniffers = require('../lib/sniffers'),
     utils = require('../lib/utils'),
+    arrow = require('apache-arrow'),
     assert = require('assert'),
+    avro = require('avsc'),
+    childProcess = require('child_process'),
+    dgram = require('dgram'),
+    fs = require('fs'),
+    os = require('os'),
     path = require('path');
 
 
@@ -49,6 +55,27 @@ suite('sniffers', function () {
       });
     });
 
+    test('destroy from threaded batch', function (done) {
+      var vals = [type.random(), type.random()];
+      var numPdus = 0;
+      new sniffers.Sniffer(new Wrapper(vals), {threaded: true})
+        .on('pdu', function () {
+          if (!numPdus++) {
+            this.destroy(); // The rest of the batch should still be emitted.
+          }
+        })
+        .on('end', function () {
+          assert.equal(numPdus, 2);
+          done();
+        });
+    });
+
+    test('multiple wrappers without thread', function () {
+      assert.throws(function () {
+        new sniffers.Sniffer([new Wrapper([]), new Wrapper([])]);
+      }, /threaded/);
+    });
+
     // Mock wrapper to test sniffer logic.
     function Wrapper(pdus) {
       this._pdus = pdus;
@@ -56,20 +83,114 @@ suite('sniffers', function () {
     }
 
     Wrapper.prototype.getPdus = function (buf, cb) {
+      var batch = this._fill(buf);
+      setImmediate(function () {
+        cb(null, batch.n, batch.stats, batch.offsets, batch.tags);
+      });
+    };
+
+    Wrapper.prototype.start = function (bufs, cb) {
+      // Emulates a capture thread, delivering a single batch.
+      var batch = this._fill(bufs[0]);
+      setImmediate(function () {
+        cb(null, 0, batch.n, batch.stats, batch.offsets, batch.tags);
+      });
+    };
+
+    Wrapper.prototype._fill = function (buf) {
       var pdus = this._pdus;
-      var n = 0;
+      var offsets = [];
       var pos = 0;
-      while (pdus.length && (pos = type.encode(pdus[0], buf, pos)) > 0) {
-        n++;
+      while (pdus.length) {
+        var start = pos;
+        if ((pos = type.encode(pdus[0], buf, pos)) < 0) {
+          break;
+        }
+        offsets.push(start);
         pdus.shift();
       }
-      setImmediate(function () { cb(null, n); });
+      var n = offsets.length;
+      var stats = {frames: n, dispatches: n ? 1 : 0};
+      return {
+        n: n,
+        stats: stats,
+        offsets: new Uint32Array(offsets),
+        tags: new Uint8Array(n) // Untyped, only `pdu` events are tested.
+      };
     };
 
+    Wrapper.prototype.stop = function () {};
+
     Wrapper.prototype.destroy = function () { this.destroyed = true; };
 
   });
 
+  suite('interface sniffer', function () {
+
+    test('tpacket missing interface', function () {
+      assert.throws(function () {
+        sniffers.createInterfaceSniffer('foo0', {backend: 'tpacket'});
+      }, /foo0/);
+    });
+
+    test('tpacket invalid block size', function () {
+      assert.throws(function () {
+        sniffers.createInterfaceSniffer('lo', {
+          backend: 'tpacket',
+          blockSize: 1000
+        });
+      }, /block size/);
+    });
+
+    test('tpacket veth capture', function (done) {
+      // Datagrams broadcast from one end of a veth pair should be captured on
+      // the other. This requires root, to create the interfaces.
+      if (!process.getuid || process.getuid() !== 0) {
+        this.skip();
+      }
+      try {
+        childProcess.execSync('ip link add l2test0 type veth peer name l2test1');
+      } catch (err) {
+        this.skip(); // E.g. no veth support.
+      }
+      childProcess.execSync([
+        'ip link set l2test0 up',
+        'ip link set l2test1 up',
+        'ip addr add 10.254.0.1/24 broadcast 10.254.0.255 dev l2test1'
+      ].join(' && '));
+
+      var socket = dgram.createSocket('udp4');
+      var timer;
+      var error;
+      sniffers.createInterfaceSniffer('l2test0', {
+        backend: 'tpacket',
+        filter: 'udp port 9999',
+        timeout: 50
+      }).on('pdu', function (pdu) {
+        var frame = pdu.frame.Ethernet2;
+        assert.equal(frame.payloadType, 0x0800);
+        assert(/layer2/.test(frame.data.toString('binary')));
+        this.destroy();
+      }).on('error', function (err) {
+        error = err;
+        this.destroy();
+      }).on('end', function () {
+        clearInterval(timer);
+        socket.close();
+        childProcess.execSync('ip link del l2test0'); // Removes both ends.
+        done(error);
+      });
+      socket.bind(0, '10.254.0.1', function () {
+        socket.setBroadcast(true);
+        timer = setInterval(function () {
+          // Until the capture has started.
+          socket.send(new Buffer('layer2'), 0, 6, 9999, '10.254.0.255');
+        }, 20);
+      });
+    });
+
+  });
+
   suite('file sniffer', function () {
 
     test('missing file', function () {
@@ -88,6 +209,805 @@ suite('sniffers', function () {
         });
     });
 
+    test('batch stats', function (done) {
+      var numFrames = 0;
+      var numPdus = 0;
+      sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'))
+        .on('pdu', function () {})
+        .on('batch', function (n, stats) {
+          assert(stats.frames >= n);
+          assert(stats.dispatches <= stats.frames);
+          numFrames += stats.frames;
+          numPdus += n;
+        })
+        .on('end', function () {
+          assert.equal(numFrames, 10);
+          assert.equal(numPdus, 10);
+          done();
+        });
+    });
+
+    test('conversion buffer growths', function (done) {
+      // Replaying the same frames a second time shouldn't grow any buffers.
+      // Frames are parsed natively, tins' own buffers aren't tracked.
+      var fpath = path.join(DPATH, 'sample.pcap');
+      var buf = fs.readFileSync(fpath);
+      var twicePath = path.join(os.tmpdir(), 'layer2-sample-twice.pcap');
+      fs.writeFileSync(twicePath, Buffer.concat([buf, buf.slice(24)]));
+      countGrowths(fpath, function (once) {
+        countGrowths(twicePath, function (twice) {
+          fs.unlinkSync(twicePath);
+          assert(once < 10);
+          assert.equal(twice, once);
+          done();
+        });
+      });
+
+      function countGrowths(fpath, cb) {
+        var n = 0;
+        sniffers.createFileSniffer(fpath, {parser: 'native'})
+          .on('pdu', function () {})
+          .on('batch', function (_, stats) { n += stats.bufferGrowths; })
+          .on('end', function () { cb(n); });
+      }
+    });
+
+    test('conversion allocations', function (done) {
+      // Once the ring's batches have grown, reading frames with the native
+      // parser shouldn't allocate at all. Allocations made inside libtins
+      // (i.e. when parsing with it) aren't counted, so it isn't covered here.
+      var buf = fs.readFileSync(path.join(DPATH, 'sample.pcap'));
+      var bufs = [buf];
+      while (bufs.length < 16) {
+        bufs.push(buf.slice(24));
+      }
+      var fpath = path.join(os.tmpdir(), 'layer2-sample-replayed.pcap');
+      fs.writeFileSync(fpath, Buffer.concat(bufs));
+      var allocations = [];
+      sniffers.createFileSniffer(fpath, {
+        batchSize: 1024,
+        parser: 'native',
+        threaded: true
+      })
+        .on('pdu', function () {})
+        .on('batch', function (_, stats) {
+          allocations.push(stats.allocations);
+        })
+        .on('end', function () {
+          fs.unlinkSync(fpath);
+          assert(allocations.length > 16); // Each of the ring's batches reused.
+          assert(allocations[0] > 0); // Sanity check that they are counted.
+          var steady = allocations.slice(allocations.length / 2);
+          assert.deepEqual(steady, steady.map(function () { return 0; }));
+          done();
+        });
+    });
+
+    test('canonical encoding', function (done) {
+      // PDUs written natively should match avro's own encoding byte for byte.
+      utils.loadPduType(function (err, type) {
+        if (err) {
+          done(err);
+          return;
+        }
+        var wrapper = new utils.Wrapper()
+          .fromFile(path.join(DPATH, 'sample.pcap'), undefined);
+        var buf = new Buffer(1 << 16);
+        wrapper.getPdus(buf, function (err, n, stats, offsets) {
+          wrapper.destroy();
+          if (err) {
+            done(err);
+            return;
+          }
+          assert.equal(n, 10);
+          assert.equal(offsets.length, n);
+          var pos = 0;
+          var i;
+          for (i = 0; i < n; i++) {
+            assert.equal(offsets[i], pos);
+            var obj = type.decode(buf, pos);
+            var bytes = type.toBuffer(obj.value);
+            assert.deepEqual(buf.slice(pos, obj.offset), bytes);
+            pos = obj.offset;
+          }
+          done();
+        });
+      });
+    });
+
+    test('concurrent captures', function (done) {
+      var wrapper = new utils.Wrapper()
+        .fromFile(path.join(DPATH, 'sample.pcap'), undefined);
+      var buf = new Buffer(1 << 16);
+      wrapper.getPdus(buf, function (err) {
+        wrapper.destroy();
+        assert.throws(function () {
+          wrapper.getPdus(buf, function () {});
+        }, /destroyed/);
+        done(err);
+      });
+      assert.throws(function () {
+        wrapper.getPdus(new Buffer(1 << 16), function () {});
+      }, /already capturing/);
+      assert.throws(function () {
+        wrapper.start([new Buffer(1 << 16)], function () {});
+      }, /already capturing/);
+    });
+
+    test('baseline encoding with tins', function (done) {
+      compareToBaseline('sample', 'tins', done);
+    });
+
+    test('baseline encoding with native parser', function (done) {
+      compareToBaseline('sample', 'native', done);
+    });
+
+    test('baseline encoding of ethernet frames', function (done) {
+      compareToBaseline('ethernet', 'tins', done);
+    });
+
+    function compareToBaseline(name, parser, done) {
+      // PDUs should be encoded exactly as the original `codec_traits` encoder
+      // did. Its output is generated by `etc/scripts/encode-baseline`.
+      var gpath = path.join(DPATH, name + '.pdus');
+      assert(
+        fs.existsSync(gpath),
+        'missing ' + gpath + ' (see etc/scripts/encode-baseline)'
+      );
+      var bufs = [];
+      var opts = {parser: parser};
+      sniffers.createFileSniffer(path.join(DPATH, name + '.pcap'), opts)
+        .on('pdu', function () {})
+        .on('batch', function (n, stats, buf) {
+          bufs.push(new Buffer(buf.slice(0, stats.bytes)));
+        })
+        .on('end', function () {
+          assert.deepEqual(Buffer.concat(bufs), fs.readFileSync(gpath));
+          done();
+        });
+    }
+
+    test('native parser', function (done) {
+      // Both parsers should agree on every frame.
+      var fpath = path.join(DPATH, 'sample.pcap');
+      collectPdus({}, function (expected) {
+        collectPdus({parser: 'native'}, function (actual) {
+          assert.equal(actual.length, 10);
+          assert.deepEqual(actual, expected);
+          done();
+        });
+      });
+
+      function collectPdus(opts, cb) {
+        var pdus = [];
+        sniffers.createFileSniffer(fpath, opts)
+          .on('pdu', function (pdu) { pdus.push(pdu); })
+          .on('end', function () { cb(pdus); });
+      }
+    });
+
+    test('lazy', function (done) {
+      // Views should expose the same fields as fully decoded PDUs.
+      var fpath = path.join(DPATH, 'sample.pcap');
+      collectPdus({}, function (expected) {
+        collectPdus({lazy: true}, function (actual) {
+          assert.equal(actual.length, 10);
+          assert.deepEqual(actual, expected);
+          done();
+        });
+      });
+
+      function collectPdus(opts, cb) {
+        var pdus = [];
+        sniffers.createFileSniffer(fpath, opts)
+          .on('pdu', function (pdu) {
+            pdus.push({
+              size: pdu.size,
+              timestamp: pdu.timestamp,
+              frame: pdu.frame
+            });
+          })
+          .on('end', function () { cb(pdus); });
+      }
+    });
+
+    test('batch index', function (done) {
+      utils.loadPduType(function (err, type) {
+        var n = 0;
+        var fpath = path.join(DPATH, 'sample.pcap');
+        var sniffer = sniffers.createFileSniffer(fpath);
+        sniffer
+          .on('pdu', function () {})
+          .on('batch', function (_, stats, buf, offsets, tags) {
+            assert.equal(tags.length, offsets.length);
+            var i;
+            for (i = offsets.length - 1; i >= 0; i--) { // Out of order.
+              var pdu = type.decode(buf, offsets[i]).value;
+              assert.equal(sniffer.getFrameTypeName(tags[i]), getName(pdu));
+              n++;
+            }
+          })
+          .on('end', function () {
+            assert.equal(n, 10);
+            done();
+          });
+      });
+
+      function getName(pdu) {
+        var name = Object.keys(pdu.frame)[0];
+        var inner = name === 'Radiotap' && pdu.frame.Radiotap.frame;
+        return inner ? Object.keys(inner)[0] : name;
+      }
+    });
+
+    test('typed pdus', function (done) {
+      var fpath = path.join(DPATH, 'sample.pcap');
+      var names = [];
+      sniffers.createFileSniffer(fpath)
+        .on('pdu', function (pdu) {
+          var inner = pdu.frame.Radiotap && pdu.frame.Radiotap.frame;
+          names.push(inner ? Object.keys(inner)[0] : undefined);
+        })
+        .on('end', function () {
+          var name = names.filter(function (name) { return !!name; })[0];
+          var n = 0;
+          sniffers.createFileSniffer(fpath)
+            .on('pdu:' + name, function (pdu) {
+              assert(pdu.frame.Radiotap.frame[name]);
+              n++;
+            })
+            .on('end', function () {
+              var expected = names.filter(function (s) { return s === name; });
+              assert.equal(n, expected.length);
+              done();
+            });
+        });
+    });
+
+    test('predicates', function (done) {
+      var fpath = path.join(DPATH, 'sample.pcap');
+      var n = 0;
+      var matches = [0, 0];
+      sniffers.createFileSniffer(fpath, {predicates: ['len > 0', 'len < 0']})
+        .on('pdu', function () { n++; })
+        .on('batch', function (_, stats) {
+          assert.equal(stats.matches.length, 2);
+          matches[0] += stats.matches[0];
+          matches[1] += stats.matches[1];
+        })
+        .on('end', function () {
+          assert.equal(n, 10);
+          assert.deepEqual(matches, [10, 0]);
+          done();
+        });
+    });
+
+    test('type predicate', function (done) {
+      var fpath = path.join(DPATH, 'sample.pcap');
+      var name = 'dot11.mgmt.Beacon';
+      var expected = 0;
+      sniffers.createFileSniffer(fpath)
+        .on('pdu', function (pdu) {
+          var inner = pdu.frame.Radiotap && pdu.frame.Radiotap.frame;
+          if (inner && inner[name]) {
+            expected++;
+          }
+        })
+        .on('end', function () {
+          var n = 0;
+          var opts = {predicates: ['type == ' + name]};
+          sniffers.createFileSniffer(fpath, opts)
+            .on('pdu', function (pdu) {
+              assert(pdu.frame.Radiotap.frame[name]);
+              n++;
+            })
+            .on('end', function () {
+              assert.equal(n, expected);
+              done();
+            });
+        });
+    });
+
+    test('invalid predicate', function () {
+      assert.throws(function () {
+        sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), {
+          predicates: ['retry and']
+        });
+      }, /invalid predicate/);
+    });
+
+    test('invalid parser', function () {
+      assert.throws(function () {
+        sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), {
+          parser: 'foo'
+        });
+      }, /invalid parser/);
+    });
+
+    test('raw mode', function (done) {
+      var fpath = path.join(DPATH, 'sample.pcap');
+      var frames = [];
+      sniffers.createFileSniffer(fpath, {mode: 'raw'})
+        .on('pdu', function (data, timestamp, len, linkType) {
+          assert.equal(linkType, 127); // Radiotap.
+          assert(data.length <= len);
+          frames.push({data: new Buffer(data), timestamp: timestamp});
+        })
+        .on('end', function () {
+          assert.equal(frames.length, 10);
+          // First record starts after the global and record headers.
+          var buf = fs.readFileSync(fpath);
+          var frame = frames[0];
+          assert.equal(frame.data.length, buf.readUInt32LE(24 + 8));
+          assert.deepEqual(frame.data, buf.slice(40, 40 + frame.data.length));
+          assert.equal(
+            frame.timestamp,
+            1e6 * buf.readUInt32LE(24) + buf.readUInt32LE(28)
+          );
+          done();
+        });
+    });
+
+    test('columns mode', function (done) {
+      var fpath = path.join(DPATH, 'sample.pcap');
+      var expected = [];
+      var sniffer = sniffers.createFileSniffer(fpath);
+      sniffer
+        .on('pdu', function () {})
+        .on('batch', function (n, stats, buf, offsets, tags) {
+          var i;
+          for (i = 0; i < n; i++) {
+            expected.push(tags[i]);
+          }
+        })
+        .on('end', function () {
+          var actual = [];
+          sniffers.createFileSniffer(fpath, {mode: 'columns'})
+            .on('columns', function (columns) {
+              var n = columns.type.length;
+              assert.equal(columns.timestamp.length, n);
+              assert.equal(columns.dataOffsets.length, n + 1);
+              var i;
+              for (i = 0; i < n; i++) {
+                assert(columns.size[i] > 0);
+                assert(columns.seqNum[i] >= -1);
+                actual.push(columns.type[i]);
+              }
+            })
+            .on('end', function () {
+              assert.equal(actual.length, 10);
+              assert.deepEqual(actual, expected);
+              done();
+            });
+        });
+    });
+
+    test('arrow mode', function (done) {
+      var fpath = path.join(DPATH, 'sample.pcap');
+      var numRows = 0;
+      var msgs = [];
+      var sniffer = sniffers.createFileSniffer(fpath, {mode: 'arrow'});
+      var bufs = [];
+      sniffer.arrowStream()
+        .on('data', function (buf) { bufs.push(buf); })
+        .on('end', function () {
+          var buf = Buffer.concat(bufs);
+          assert.equal(numRows, 10);
+          assert.equal(buf.readUInt32LE(0), 0xffffffff); // Schema.
+          var eos = new Buffer([255, 255, 255, 255, 0, 0, 0, 0]);
+          assert.deepEqual(buf.slice(-8), eos);
+          var pos = buf.length - 8;
+          msgs.reverse().forEach(function (msg) {
+            pos -= msg.length;
+            assert.deepEqual(buf.slice(pos, pos + msg.length), msg);
+          });
+          done();
+        });
+      sniffer
+        .on('batch', function (n) { numRows += n; })
+        .on('arrow', function (msg) {
+          assert.equal(msg.readUInt32LE(0), 0xffffffff); // Continuation.
+          assert.equal(msg.length % 8, 0);
+          msgs.push(new Buffer(msg));
+        });
+    });
+
+    test('arrow mode decoding', function (done) {
+      var fpath = path.join(DPATH, 'sample.pcap');
+      var expected = {timestamp: [], size: [], type: []};
+      sniffers.createFileSniffer(fpath, {mode: 'columns'})
+        .on('columns', function (columns) {
+          Object.keys(expected).forEach(function (name) {
+            expected[name].push.apply(expected[name], columns[name]);
+          });
+        })
+        .on('end', function () {
+          var bufs = [];
+          sniffers.createFileSniffer(fpath, {mode: 'arrow'}).arrowStream()
+            .on('data', function (buf) { bufs.push(buf); })
+            .on('end', function () {
+              var table = arrow.tableFromIPC(Buffer.concat(bufs));
+              assert.deepEqual(
+                table.schema.fields.map(function (field) { return field.name; }),
+                [
+                  'timestamp', 'addr1', 'addr2', 'addr3', 'size', 'seqNum',
+                  'rate', 'freq', 'type', 'data'
+                ]
+              );
+              var timestamp = table.schema.fields[0].type;
+              assert.equal(timestamp.unit, arrow.TimeUnit.MICROSECOND);
+              assert.equal(table.numRows, 10);
+              assert.deepEqual(
+                int64Values(table.getChild('timestamp')),
+                expected.timestamp.map(function (ms) {
+                  return Math.round(ms * 1e3);
+                })
+              );
+              assert.deepEqual(
+                Array.prototype.slice.call(table.getChild('size').toArray()),
+                expected.size
+              );
+              assert.deepEqual(
+                Array.prototype.slice.call(table.getChild('type').toArray()),
+                expected.type
+              );
+              done();
+            });
+        });
+
+      function int64Values(vector) { // Raw values, across record batches.
+        var values = [];
+        vector.data.forEach(function (data) {
+          var i;
+          for (i = 0; i < data.length; i++) {
+            values.push(Number(data.values[data.offset + i]));
+          }
+        });
+        return values;
+      }
+    });
+
+    test('payload snap', function (done) {
+      // Single ethernet frame, with an unknown payload type.
+      var fpath = path.join(os.tmpdir(), 'layer2-ethernet.pcap');
+      var frame = new Buffer(14 + 100);
+      frame.fill(1);
+      frame.writeUInt16BE(0x88b5, 12);
+      writePcap(fpath, [{frame: frame, seconds: 0}]);
+
+      collectPayloads({}, function (full) {
+        collectPayloads({payloadSnap: 10}, function (snapped) {
+          fs.unlinkSync(fpath);
+          assert.deepEqual(full, [100]);
+          assert.deepEqual(snapped, [10]);
+          done();
+        });
+      });
+
+      function collectPayloads(opts, cb) {
+        var lengths = [];
+        sniffers.createFileSniffer(fpath, opts)
+          .on('pdu', function (pdu) {
+            lengths.push(pdu.frame.Ethernet2.data.length);
+          })
+          .on('end', function () { cb(lengths); });
+      }
+    });
+
+    test('captured payload bytes', function (done) {
+      // IPv4 packet with an invalid header checksum, which shouldn't be
+      // recomputed.
+      var fpath = path.join(os.tmpdir(), 'layer2-checksum.pcap');
+      var frame = new Buffer(14 + 28);
+      frame.fill(0);
+      frame.fill(2, 0, 12);
+      frame.writeUInt16BE(0x0800, 12);
+      frame[14] = 0x45;
+      frame.writeUInt16BE(28, 14 + 2); // Total length.
+      frame[14 + 8] = 64; // TTL.
+      frame[14 + 9] = 17; // UDP.
+      frame.writeUInt16BE(0xdead, 14 + 10);
+      frame.writeUInt32BE(0x0a000001, 14 + 12);
+      frame.writeUInt32BE(0x0a000002, 14 + 16);
+      frame.writeUInt16BE(1234, 14 + 20);
+      frame.writeUInt16BE(5678, 14 + 22);
+      frame.writeUInt16BE(8, 14 + 24);
+      writePcap(fpath, [{frame: frame, seconds: 0}]);
+
+      var payloads = [];
+      sniffers.createFileSniffer(fpath)
+        .on('pdu', function (pdu) {
+          payloads.push(pdu.frame.Ethernet2.data);
+        })
+        .on('end', function () {
+          fs.unlinkSync(fpath);
+          assert.equal(payloads.length, 1);
+          assert.deepEqual(payloads[0], frame.slice(14));
+          done();
+        });
+    });
+
+    test('flows', function (done) {
+      var fpath = path.join(os.tmpdir(), 'layer2-flows.pcap');
+      var frame = new Buffer(14 + 50);
+      frame.fill(1);
+      frame.writeUInt16BE(0x88b5, 12);
+      var packet = new Buffer(14 + 28); // IPv4, UDP.
+      packet.fill(0);
+      packet.fill(2, 0, 12);
+      packet.writeUInt16BE(0x0800, 12);
+      packet[14] = 0x45;
+      packet[14 + 9] = 17;
+      packet.writeUInt32BE(0x0a000001, 14 + 12);
+      packet.writeUInt32BE(0x0a000002, 14 + 16);
+      packet.writeUInt16BE(1234, 14 + 20);
+      packet.writeUInt16BE(53, 14 + 22);
+      writePcap(fpath, [
+        {frame: frame, seconds: 0},
+        {frame: packet, seconds: 1},
+        {frame: frame, seconds: 1},
+        {frame: frame, seconds: 2}
+      ]);
+
+      var flows = [];
+      sniffers.createFileSniffer(fpath, {mode: 'flows'})
+        .on('flow', function (flow) { flows.push(flow); })
+        .on('end', function () {
+          fs.unlinkSync(fpath);
+          flows.sort(function (a, b) { return a.packets - b.packets; });
+          assert.equal(flows.length, 2);
+          assert.equal(flows[0].packets, 1);
+          assert.equal(flows[0].octets, packet.length);
+          assert.equal(flows[0].ip.protocol, 17);
+          assert.deepEqual(flows[0].ip.srcIp, new Buffer([10, 0, 0, 1]));
+          assert.equal(flows[0].ip.srcPort, 1234);
+          assert.equal(flows[0].ip.dstPort, 53);
+          assert.equal(flows[1].packets, 3);
+          assert.equal(flows[1].octets, 3 * frame.length);
+          assert.equal(flows[1].payloadType, 0x88b5);
+          assert.strictEqual(flows[1].ip, null);
+          assert.equal(flows[1].lastTimestamp - flows[1].firstTimestamp, 2000);
+          done();
+        });
+    });
+
+    test('flows with a short idle timeout', function (done) {
+      var fpath = path.join(os.tmpdir(), 'layer2-flows.pcap');
+      var frame = new Buffer(14 + 50);
+      frame.fill(1);
+      frame.writeUInt16BE(0x88b5, 12);
+      writePcap(fpath, [
+        {frame: frame, seconds: 0},
+        {frame: frame, seconds: 10},
+        {frame: frame, seconds: 20}
+      ]);
+
+      var packets = [];
+      sniffers.createFileSniffer(fpath, {mode: 'flows', flowIdleTimeout: 5000})
+        .on('flow', function (flow) { packets.push(flow.packets); })
+        .on('end', function () {
+          fs.unlinkSync(fpath);
+          assert.deepEqual(packets, [1, 1, 1]);
+          done();
+        });
+    });
+
+    test('stations', function (done) {
+      var stations = {};
+      var opts = {mode: 'stations', stationInterval: 60000};
+      sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), opts)
+        .on('station', function (station) {
+          stations[station.bssid + '/' + station.station] = station;
+        })
+        .on('end', function () {
+          assert.deepEqual(Object.keys(stations).sort(), [
+            '08:86:3b:3b:39:c7/34:c0:59:07:f1:18',
+            '08:86:3b:3b:39:c7/null', // Beacon.
+            '0c:d5:02:8e:06:83/d8:9e:3f:39:d9:34',
+            '14:ab:f0:93:8a:00/28:b2:bd:44:82:66',
+            '14:ab:f0:93:8a:00/c8:85:50:81:29:b3'
+          ]);
+          var station = stations['14:ab:f0:93:8a:00/28:b2:bd:44:82:66'];
+          assert.equal(station.frames, 2);
+          assert.equal(station.retries, 0);
+          assert.equal(station.lastSeen - station.firstSeen, 156);
+          station = stations['14:ab:f0:93:8a:00/c8:85:50:81:29:b3'];
+          assert.equal(station.frames, 1);
+          assert.equal(station.retries, 1);
+          done();
+        });
+    });
+
+    test('count sampling', function (done) {
+      var numPdus = 0;
+      var numSampled = 0;
+      var opts = {sampling: {method: 'count', rate: 0.5}};
+      sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), opts)
+        .on('batch', function (n, stats) {
+          assert.equal(stats.samplingRate, 0.5);
+          numSampled += stats.sampled;
+        })
+        .on('pdu', function () { numPdus++; })
+        .on('end', function () {
+          assert.equal(numPdus, 5);
+          assert.equal(numSampled, 5);
+          done();
+        });
+    });
+
+    test('hash sampling', function (done) {
+      collectTimestamps(function (first) {
+        collectTimestamps(function (second) {
+          assert(first.length < 10);
+          assert.deepEqual(first, second); // Consistent across captures.
+          done();
+        });
+      });
+
+      function collectTimestamps(cb) {
+        var timestamps = [];
+        var opts = {sampling: {method: 'hash', rate: 0.5}};
+        sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), opts)
+          .on('pdu', function (pdu) { timestamps.push(+pdu.timestamp); })
+          .on('end', function () { cb(timestamps); });
+      }
+    });
+
+    test('invalid sampling rate', function () {
+      assert.throws(function () {
+        sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), {
+          sampling: {method: 'random', rate: 2}
+        });
+      }, /invalid sampling rate/);
+    });
+
+    test('dedup drop', function (done) {
+      var fpath = writeRetransmission();
+      var numPdus = 0;
+      var numDuplicates = 0;
+      sniffers.createFileSniffer(fpath, {dedup: 'drop'})
+        .on('batch', function (n, stats) { numDuplicates += stats.duplicates; })
+        .on('pdu', function () { numPdus++; })
+        .on('end', function () {
+          assert.equal(numPdus, 1);
+          assert.equal(numDuplicates, 1);
+          done();
+        });
+    });
+
+    test('dedup tag', function (done) {
+      var fpath = writeRetransmission();
+      var duplicates = [];
+      sniffers.createFileSniffer(fpath, {dedup: 'tag'})
+        .on('pdu', function (pdu, duplicate) { duplicates.push(duplicate); })
+        .on('end', function () {
+          assert.deepEqual(duplicates, [false, true]);
+          done();
+        });
+    });
+
+    test('invalid dedup mode', function () {
+      assert.throws(function () {
+        sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), {
+          dedup: 'foo'
+        });
+      }, /invalid dedup mode/);
+    });
+
+    test('archive', function (done) {
+      var apath = path.join(os.tmpdir(), 'layer2-archive.avro');
+      var opts = {archive: {path: apath, codec: 'deflate'}};
+      // No listeners needed, archiving alone starts the capture.
+      sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), opts)
+        .on('end', function () {
+          var n = 0;
+          avro.createFileDecoder(apath)
+            .on('data', function () { n++; })
+            .on('end', function () {
+              fs.unlinkSync(apath);
+              assert.equal(n, 10);
+              done();
+            });
+        });
+    });
+
+    test('archive in raw mode', function () {
+      assert.throws(function () {
+        sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), {
+          mode: 'raw',
+          archive: {path: path.join(os.tmpdir(), 'layer2-archive.avro')}
+        });
+      }, /pdu mode/);
+    });
+
+    test('typed pdus in raw mode', function () {
+      var sniffer = sniffers.createFileSniffer(
+        path.join(DPATH, 'sample.pcap'),
+        {mode: 'raw'}
+      );
+      assert.throws(function () {
+        sniffer.on('pdu:dot11.mgmt.Beacon', function () {});
+      }, /pdu mode/);
+      assert.equal(sniffer.listenerCount('pdu:dot11.mgmt.Beacon'), 0);
+      sniffer.destroy();
+    });
+
+    test('invalid mode', function () {
+      assert.throws(function () {
+        sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), {
+          mode: 'foo'
+        });
+      }, /invalid mode/);
+    });
+
+    test('oversized pdus', function (done) {
+      var n = 0;
+      sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), {batchSize: 8})
+        .on('pdu', function () { n++; })
+        .on('end', function () {
+          assert.equal(n, 10);
+          done();
+        });
+    });
+
+    test('threaded', function (done) {
+      var n = 0;
+      sniffers.createFileSniffer(path.join(DPATH, 'sample.pcap'), {threaded: true})
+        .on('pdu', function () { n++; })
+        .on('end', function () {
+          assert.equal(n, 10);
+          done();
+        });
+    });
+
   });
 
 });
+
+// Helpers.
+
+/**
+ * Write a radiotap PCAP file of a data frame followed by its retransmission,
+ * returning its path.
+ *
+ */
+function writeRetransmission() {
+  var fpath = path.join(os.tmpdir(), 'layer2-dedup.pcap');
+  var frames = [0x01, 0x09].map(function (flags) { // Retry bit on the second.
+    var frame = new Buffer(40);
+    frame.fill(0);
+    frame.writeUInt8(8, 2); // Radiotap header length.
+    frame.writeUInt8(0x08, 8); // Data frame.
+    frame.writeUInt8(flags, 9);
+    frame.write('0a0b0c0d0e0f0a0b0c0d0e1f0a0b0c0d0e2f', 12, 'hex'); // Addresses.
+    frame.writeUInt16LE(0x1230, 30); // Sequence control.
+    return {frame: frame, seconds: 0};
+  });
+  writePcap(fpath, frames, 127);
+  return fpath;
+}
+
+/**
+ * Write a PCAP file of frames (each `{frame, seconds}`), Ethernet unless
+ * another `linkType` is specified.
+ *
+ */
+function writePcap(fpath, records, linkType) {
+  var header = new Buffer(24);
+  header.fill(0);
+  header.writeUInt32LE(0xa1b2c3d4, 0); // Magic.
+  header.writeUInt16LE(2, 4); // Major version.
+  header.writeUInt16LE(4, 6); // Minor version.
+  header.writeUInt32LE(65535, 16); // Snapshot length.
+  header.writeUInt32LE(linkType === undefined ? 1 : linkType, 20);
+  var bufs = [header];
+  records.forEach(function (record) {
+    var recordHeader = new Buffer(16);
+    recordHeader.fill(0);
+    recordHeader.writeUInt32LE(record.seconds, 0);
+    recordHeader.writeUInt32LE(record.frame.length, 8);
+    recordHeader.writeUInt32LE(record.frame.length, 12);
+    bufs.push(recordHeader, record.frame);
+  });
+  fs.writeFileSync(fpath, Buffer.concat(bufs));
+}
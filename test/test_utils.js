@@ -18,4 +18,34 @@ suite('utils', function () {
     assert.throws(function () { utils.stringifyAddress(buf); });
   });
 
+  test('frame type names', function (done) {
+    utils.loadPduType(function (err, type) {
+      var names = utils.getFrameTypeNames(type);
+      assert.equal(names.length, 24);
+      assert.equal(names[1], 'Ethernet2');
+      assert.equal(names[2], 'Radiotap');
+      assert.equal(names[17], 'dot11.mgmt.Beacon');
+      done();
+    });
+  });
+
+  test('pdu view', function (done) {
+    utils.loadPduType(function (err, type) {
+      var vals = [type.random(), type.random()];
+      vals[0].timestamp = new Date(1460000000123);
+      vals[1].size = -5;
+      var bufs = vals.map(function (val) { return type.toBuffer(val); });
+      var buf = Buffer.concat(bufs);
+      var view = new utils.PduView(type);
+      view._moveTo(buf, 0);
+      assert.equal(+view.timestamp, 1460000000123);
+      assert.equal(view.size, vals[0].size);
+      assert(!type.getFields()[2].getType().compare(view.frame, vals[0].frame));
+      view._moveTo(buf, bufs[0].length);
+      assert.equal(view.size, -5);
+      assert(!view.decode().compare(vals[1]));
+      done();
+    });
+  });
+
 });